@@ -18,14 +18,37 @@ SOURCES += \
 # 头文件
 HEADERS += \
     audioplayer.h \
+    audiotap.h \
+    beatdetector.h \
+    binaryformat.h \
+    cachedirectory.h \
+    crossfader.h \
+    encodingdetector.h \
+    lyriccache.h \
     lyricdownloader.h \
+    lyricfileindex.h \
+    lyricloader.h \
     lyricparser.h \
+    lyricprefetcher.h \
+    lyricprovider.h \
+    lyricresponsecache.h \
+    lyricsearchdialog.h \
+    lyricsearchindex.h \
     lyricwidget.h \
+    loudnessscanner.h \
     menu.h \
+    networkdiagnosticsdialog.h \
+    networkresilience.h \
     onlinemusicsearch.h \
+    pcmconverter.h \
+    pcmringbuffer.h \
     playhistory.h \
+    positionclock.h \
+    spectrumanalyzer.h \
+    spectrumbands.h \
     spectrumwidget.h \
     videoplayer.h \
+    waveformoverview.h \
     widget.h
 
 # UI 文件
@@ -29,11 +29,21 @@
 #include <QEvent>
 #include <QMenu>
 #include <QAction>
+#include <QtMath>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QSet>
 #include "spectrumwidget.h"
 #include "lyricwidget.h"
 #include "lyricparser.h"
 #include "lyricdownloader.h"
+#include "lyricloader.h"
+#include "lyricprefetcher.h"
+#include "lyricsearchdialog.h"
 #include "onlinemusicsearch.h"
+#include "waveformoverview.h"
+#include "loudnessscanner.h"
+#include "crossfader.h"
 
 // 枚举播放模式
 enum PlayMode
@@ -54,6 +64,19 @@ private:
     SpectrumWidget *m_spectrumWidget; // 频谱可视化组件
     LyricWidget *m_lyricWidget;     // 歌词显示组件
     LyricDownloader *m_lyricDownloader; // 歌词下载器
+    LyricLoader *m_lyricLoader;         // 后台歌词加载
+    QString m_lyricDownloadedFor;       // 最近一次已下载歌词的曲目（避免解析为空时反复下载）
+    quint64 m_lyricDownloadTask = 0;    // 进行中的歌词下载任务
+    QString m_lyricDownloadPath;        // 该任务对应的曲目（批量预取的结果不弹提示）
+    QLabel *m_lyricStatus;              // 歌词下载提示（非模态，数秒后自动隐藏）
+    QTimer *m_lyricStatusTimer;         // 提示隐藏定时器
+    static const int LYRIC_STATUS_MS = 3000;    // 提示显示时长
+    LyricPrefetcher *m_lyricPrefetcher; // 播放列表歌词批量预取
+    LyricSearchIndex *m_lyricSearch;    // 歌词全文索引
+    qint64 m_pendingSeekMs = -1;        // 媒体加载完成后要跳转到的位置
+    WaveformOverview *m_waveformOverview; // 波形概览生成器
+    LoudnessScanner *m_loudnessScanner; // 响度扫描器
+    qreal m_trackGain = 1.0;        // 当前曲目的响度归一化增益（线性，最大 1.0）
 
     // 控制按钮
     QPushButton *m_btnPlayPause;    // 播放/暂停
@@ -66,7 +89,7 @@ private:
     QToolButton *m_btnRandom;       // 随机播放
 
     // 进度控制
-    QSlider *m_progressSlider;      // 进度条
+    WaveformSlider *m_progressSlider; // 进度条（带波形概览）
     QLabel *m_currentTime;          // 当前时间
     QLabel *m_totalTime;            // 总时间
     
@@ -80,6 +103,28 @@ private:
     QList<QUrl> m_playlist;         // 播放列表
     int m_currentIndex;             // 当前播放索引
 
+    // 无缝播放：第二个播放器提前打开并缓冲下一首，曲尾按测得的启动延迟提前启动
+    static const int SWITCH_WINDOW_MS = 400;    // 距曲尾多久开始准备切换
+    static const int MAX_LEAD_MS = 150;         // 提前启动量上限
+    QMediaPlayer *m_nextPlayer;     // 预载播放器（与 m_player 轮换）
+    QAudioOutput *m_nextOutput;     // 预载播放器的音频输出
+    int m_nextIndex = -1;           // 已预选的下一首（随机模式下也提前固定）
+    bool m_retiring = false;        // 预载播放器仍在播放上一首的尾部
+    QList<QMetaObject::Connection> m_playerConnections; // 当前播放器的信号连接
+    QTimer *m_switchTimer;          // 曲尾精确切换定时器
+    QElapsedTimer m_gapClock;       // 间隙测量时钟
+    qint64 m_oldEndMs = -1;         // 上一首实际结束时刻
+    qint64 m_newStartMs = -1;       // 下一首实际开始时刻（按首个位置回推）
+    bool m_awaitingStart = false;   // 等待下一首的首个位置上报
+    double m_appliedLeadMs = 0.0;   // 本次切换实际使用的提前量
+    double m_startLeadMs = 0.0;     // 自适应提前量（约等于播放器启动延迟）
+    double m_lastGapMs = 0.0;       // 最近一次曲间间隙（负数表示重叠）
+    bool m_switchBuffered = false;  // 本次切换时下一首是否已缓冲完成（BufferedMedia）
+    
+    // 交叉淡化：曲尾提前启动下一首，两首重叠 m_crossfadeMs 毫秒（0 表示关闭，仅无缝衔接）
+    Crossfader *m_crossfader;       // 等功率音量曲线
+    int m_crossfadeMs = 0;          // 交叉淡化时长
+
     // 状态
     PlayMode m_playMode;            // 当前播放模式
     QWidget* m_parent = nullptr;    // 父控件
@@ -99,6 +144,22 @@ public:
         // 设置音量（0.0 到 1.0，默认设置为 0.8）
         m_audioOutput->setVolume(0.8);
         
+        // 预载播放器：与当前播放器轮换，提前打开下一首
+        m_nextPlayer = new QMediaPlayer(this);
+        m_nextOutput = new QAudioOutput(this);
+        m_nextOutput->setVolume(0.8);
+        m_nextPlayer->setAudioOutput(m_nextOutput);
+        watchPreroll(m_player);
+        watchPreroll(m_nextPlayer);
+        
+        m_switchTimer = new QTimer(this);
+        m_switchTimer->setSingleShot(true);
+        m_switchTimer->setTimerType(Qt::PreciseTimer);
+        connect(m_switchTimer, &QTimer::timeout, this, &AudioPlayer::startPrerolledNext);
+        m_gapClock.start();
+        
+        m_crossfader = new Crossfader(this);
+        
         // 调试信息：检查音频输出设备
         qDebug() << "=== 音频播放器初始化 ===";
         qDebug() << "音频输出设备:" << m_audioOutput->device().description();
@@ -107,6 +168,23 @@ public:
         
         // 初始化歌词下载器
         m_lyricDownloader = new LyricDownloader(this);
+        
+        // 歌词批量预取（启动稍后继续上次未完成的队列）
+        m_lyricPrefetcher = new LyricPrefetcher(m_lyricDownloader, this);
+        QTimer::singleShot(5000, m_lyricPrefetcher, &LyricPrefetcher::resume);
+        
+        // 初始化歌词加载器（后台查找与解析）
+        m_lyricLoader = new LyricLoader(this);
+        
+        // 初始化歌词全文索引（后台分批建立，持久化到磁盘），音乐库目录整体索引
+        m_lyricSearch = new LyricSearchIndex(this);
+        m_lyricSearch->addDirectory(QStandardPaths::writableLocation(QStandardPaths::MusicLocation));
+        
+        // 初始化波形概览（后台解码，结果缓存在磁盘）
+        m_waveformOverview = new WaveformOverview(this);
+        
+        // 初始化响度扫描器（线程池并行分析，播放时应用增益）
+        m_loudnessScanner = new LoudnessScanner(this);
 
         // 设置初始播放模式
         m_playMode = ListLoop;
@@ -132,6 +210,7 @@ public:
     // 添加文件到播放列表
     void addFiles(const QStringList &files)
     {
+        QStringList added;
         foreach (const QString &file, files)
         {
             QFileInfo fileInfo(file);
@@ -139,10 +218,19 @@ public:
             {
                 m_playlist.append(QUrl::fromLocalFile(file));
                 m_playListWidget->addItem(fileInfo.fileName());
+                added.append(fileInfo.absoluteFilePath());
             }
         }
+        
+        // 后台扫描响度、索引歌词（连同所在文件夹中未加入播放列表的曲目）
+        m_loudnessScanner->scan(added);
+        m_lyricSearch->addTracks(added);
+        QSet<QString> folders;
+        for (const QString &path : std::as_const(added)) folders.insert(QFileInfo(path).absolutePath());
+        for (const QString &folder : std::as_const(folders)) m_lyricSearch->addDirectory(folder, false);
 
         if (m_playlist.isEmpty()) return;
+        resetPreroll();
 
         // 如果当前没有播放，自动播放第一首
         if (m_player->playbackState() != QMediaPlayer::PlayingState)
@@ -152,14 +240,52 @@ public:
         }
     }
 
+    // 最近一次曲间间隙（毫秒，负数表示重叠）与当前自适应提前量
+    double lastTransitionGapMs() const { return m_lastGapMs; }
+    double startLeadMs() const { return m_startLeadMs; }
+    
+    // 交叉淡化时长（毫秒，0 表示关闭）
+    void setCrossfadeDuration(int ms)
+    {
+        m_crossfadeMs = qMax(0, ms);
+        m_switchTimer->stop();
+    }
+    int crossfadeDuration() const { return m_crossfadeMs; }
+    
+    // 交叉淡化单次音量更新的平均耗时（纳秒）
+    double crossfadeStepCostNs() const { return m_crossfader->averageStepCostNs(); }
+    
+    // 为播放列表中所有本地曲目预取歌词（后台进行，进度见 lyricPrefetcher()）
+    void prefetchLyrics()
+    {
+        QStringList paths;
+        for (const QUrl &url : std::as_const(m_playlist)) {
+            if (url.isLocalFile()) paths.append(url.toLocalFile());
+        }
+        if (!paths.isEmpty()) m_lyricPrefetcher->start(paths);
+    }
+    LyricPrefetcher *lyricPrefetcher() const { return m_lyricPrefetcher; }
+    LyricDownloader *lyricDownloader() const { return m_lyricDownloader; }
+    
+    // 歌词输出延迟补偿（毫秒），用于蓝牙等高延迟输出设备
+    void setLyricLatency(int ms) { m_lyricWidget->setLatency(ms); }
+    int lyricLatency() const { return m_lyricWidget->latency(); }
+
     // 暂停播放器
     void audioPause()
     {
         m_player->pause();
+        m_switchTimer->stop();
+        stopCrossfade();
         m_btnPlayPause->setIcon(QIcon("./assets/play.png"));
         m_btnPlayPause->setIconSize(QSize(48, 48));
     }
 
+signals:
+    // 完成一次曲间间隙测量（毫秒，负数表示重叠），leadMs 为下次切换的提前量，
+    // buffered 为切换时下一首是否已缓冲完成；间隙由计时器与首个位置上报估算，精度为毫秒级而非采样级
+    void transitionGapMeasured(double gapMs, double leadMs, bool buffered);
+
 private:
     // 创建UI界面
     void createUI()
@@ -239,6 +365,17 @@ private:
         m_lyricWidget->setMinimumHeight(200);
         leftLayout->addWidget(m_lyricWidget);
 
+        // 歌词下载提示：不打断播放与操作
+        m_lyricStatus = new QLabel(leftPanel);
+        m_lyricStatus->setAlignment(Qt::AlignCenter);
+        m_lyricStatus->setStyleSheet("color: #64b5f6; font-size: 10pt;");
+        m_lyricStatus->hide();
+        leftLayout->addWidget(m_lyricStatus);
+        m_lyricStatusTimer = new QTimer(this);
+        m_lyricStatusTimer->setSingleShot(true);
+        m_lyricStatusTimer->setInterval(LYRIC_STATUS_MS);
+        connect(m_lyricStatusTimer, &QTimer::timeout, m_lyricStatus, &QWidget::hide);
+
         splitter->addWidget(leftPanel);
 
         // 右侧：播放列表和控制面板
@@ -347,8 +484,30 @@ private:
         );
         connect(testButton, &QPushButton::clicked, this, &AudioPlayer::testAudio);
         
+        // 歌词搜索按钮
+        QPushButton *lyricSearchButton = new QPushButton("📝 搜索歌词", playlistGroup);
+        lyricSearchButton->setStyleSheet(
+            "QPushButton { "
+            "   background-color: #00897b; "
+            "   color: white; "
+            "   border: none; "
+            "   padding: 8px; "
+            "   border-radius: 5px; "
+            "   font-weight: bold; "
+            "   font-size: 9pt; "
+            "}"
+            "QPushButton:hover { "
+            "   background-color: #26a69a; "
+            "}"
+            "QPushButton:pressed { "
+            "   background-color: #00695c; "
+            "}"
+        );
+        connect(lyricSearchButton, &QPushButton::clicked, this, &AudioPlayer::onSearchLyrics);
+        
         actionButtonLayout->addWidget(deleteButton);
         actionButtonLayout->addWidget(testButton);
+        actionButtonLayout->addWidget(lyricSearchButton);
         playlistLayout->addLayout(actionButtonLayout);
 
         rightLayout->addWidget(playlistGroup);
@@ -387,7 +546,7 @@ private:
         m_currentTime->setFixedWidth(50);
         m_currentTime->setAlignment(Qt::AlignCenter);
 
-        m_progressSlider = new QSlider(Qt::Horizontal, controlGroup);
+        m_progressSlider = new WaveformSlider(Qt::Horizontal, controlGroup);
         m_progressSlider->setRange(0, 100);
 
         m_totalTime = new QLabel("00:00", controlGroup);
@@ -632,20 +791,11 @@ private:
         // 音量控制
         connect(m_volumeSlider, &QSlider::valueChanged, this, &AudioPlayer::onVolumeChanged);
 
-        // 播放器信号（Qt6）
-        connect(m_player, &QMediaPlayer::positionChanged, this, &AudioPlayer::updatePosition);
-        connect(m_player, &QMediaPlayer::durationChanged, this, &AudioPlayer::updateDuration);
-        connect(m_player, &QMediaPlayer::playbackStateChanged, this, &AudioPlayer::updatePlayButton);
-        connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &AudioPlayer::onMediaStatusChanged);
+        // 播放器信号、频谱与歌词同步（播放器轮换时重新连接）
+        attachPlayer(m_player);
         
-        // 错误处理
-        connect(m_player, &QMediaPlayer::errorOccurred, this, &AudioPlayer::onPlayerError);
-
-        // 连接频谱可视化
-        m_spectrumWidget->setMediaPlayer(m_player);
-        
-        // 连接歌词同步
-        connect(m_player, &QMediaPlayer::positionChanged, m_lyricWidget, &LyricWidget::updatePosition);
+        // 歌词淡入跟随节拍
+        connect(m_spectrumWidget, &SpectrumWidget::beatDetected, m_lyricWidget, &LyricWidget::onBeat);
 
         // 播放列表选择
         connect(m_playListWidget, &QListWidget::itemDoubleClicked, [this](QListWidgetItem *item)
@@ -657,6 +807,209 @@ private:
 
         // 进度条拖动
         connect(m_progressSlider, &QSlider::sliderMoved, this, &AudioPlayer::seek);
+        
+        // 当前曲目的响度分析完成后立即应用增益
+        connect(m_loudnessScanner, &LoudnessScanner::loudnessReady, this,
+                [this](const QString &filePath, const LoudnessResult &) {
+            if (m_currentIndex >= 0 && m_currentIndex < m_playlist.size()
+                && m_playlist[m_currentIndex].toLocalFile() == filePath) {
+                updateTrackGain();
+            }
+        });
+        
+        // 歌词加载完成（过期请求已由加载器丢弃，这里再核对一次曲目）
+        connect(m_lyricLoader, &LyricLoader::lyricsReady, this,
+                [this](const QString &audioPath, const QList<LyricLine> &lyrics) {
+            if (isCurrentTrack(audioPath)) {
+                m_lyricWidget->setLyrics(lyrics);
+            }
+        });
+        connect(m_lyricLoader, &LyricLoader::lyricsNotFound, this, &AudioPlayer::downloadLyrics);
+        connect(m_lyricDownloader, &LyricDownloader::downloadFinished, this, &AudioPlayer::onLyricDownloadFinished);
+        
+        // 波形概览就绪（只接受当前曲目的结果）
+        connect(m_waveformOverview, &WaveformOverview::waveformReady, this,
+                [this](const QString &audioPath, QSharedPointer<WaveformData> data) {
+            if (m_currentIndex >= 0 && m_currentIndex < m_playlist.size()
+                && m_playlist[m_currentIndex].toLocalFile() == audioPath) {
+                m_progressSlider->setWaveform(data);
+            }
+        });
+    }
+
+    // 把界面、频谱和歌词连接到当前播放器
+    void attachPlayer(QMediaPlayer *player)
+    {
+        for (const QMetaObject::Connection &connection : m_playerConnections) {
+            disconnect(connection);
+        }
+        m_playerConnections.clear();
+        
+        // 播放器信号（Qt6）
+        m_playerConnections << connect(player, &QMediaPlayer::positionChanged, this, &AudioPlayer::updatePosition);
+        m_playerConnections << connect(player, &QMediaPlayer::durationChanged, this, &AudioPlayer::updateDuration);
+        m_playerConnections << connect(player, &QMediaPlayer::playbackStateChanged, this, &AudioPlayer::updatePlayButton);
+        m_playerConnections << connect(player, &QMediaPlayer::mediaStatusChanged, this, &AudioPlayer::onMediaStatusChanged);
+        
+        // 错误处理
+        m_playerConnections << connect(player, &QMediaPlayer::errorOccurred, this, &AudioPlayer::onPlayerError);
+        
+        // 连接歌词同步
+        m_playerConnections << connect(player, &QMediaPlayer::positionChanged, m_lyricWidget, &LyricWidget::updatePosition);
+        m_playerConnections << connect(player, &QMediaPlayer::playbackStateChanged, m_lyricWidget,
+                                       [this](QMediaPlayer::PlaybackState state) {
+            m_lyricWidget->setPlaying(state == QMediaPlayer::PlayingState);
+        });
+        m_playerConnections << connect(player, &QMediaPlayer::playbackRateChanged, m_lyricWidget, &LyricWidget::setPlaybackRate);
+        m_lyricWidget->setPlaybackRate(player->playbackRate());
+        m_lyricWidget->setPlaying(player->playbackState() == QMediaPlayer::PlayingState);
+        
+        // 连接频谱可视化
+        m_spectrumWidget->setMediaPlayer(player);
+    }
+    
+    // 两个播放器共用的预载处理：仅对当前处于预载位置的播放器生效
+    void watchPreroll(QMediaPlayer *player)
+    {
+        connect(player, &QMediaPlayer::mediaStatusChanged, this,
+                [this, player](QMediaPlayer::MediaStatus status) {
+            if (player != m_nextPlayer) return;
+            
+            if (m_retiring) {
+                // 上一首的尾部播完：记录结束时刻，随后预载再下一首
+                if (status == QMediaPlayer::EndOfMedia) {
+                    m_crossfader->finish();
+                    m_retiring = false;
+                    m_oldEndMs = m_gapClock.elapsed();
+                    finishGapMeasurement();
+                    player->stop();
+                    prerollNext();
+                }
+                return;
+            }
+            
+            // 加载完成后进入暂停态，后端即开始解码并预填充缓冲
+            if (status == QMediaPlayer::LoadedMedia
+                && player->playbackState() == QMediaPlayer::StoppedState) {
+                player->pause();
+            }
+        });
+    }
+    
+    // 按播放模式选出下一首
+    int pickNextIndex() const
+    {
+        if (m_playMode == Random) {
+            return QRandomGenerator::global()->bounded(m_playlist.size());
+        }
+        return (m_currentIndex + 1) % m_playlist.size();
+    }
+    
+    // 预载播放器是否已就绪（已打开下一首并完成缓冲）
+    bool prerollReady() const
+    {
+        if (m_retiring || m_nextIndex < 0 || m_nextIndex >= m_playlist.size()) return false;
+        if (m_nextPlayer->source() != m_playlist[m_nextIndex]) return false;
+        const QMediaPlayer::MediaStatus status = m_nextPlayer->mediaStatus();
+        return status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::BufferedMedia;
+    }
+    
+    // 预选并预载下一首
+    void prerollNext()
+    {
+        if (m_retiring || m_playlist.size() < 2
+            || m_currentIndex < 0 || m_currentIndex >= m_playlist.size()) {
+            return;
+        }
+        if (m_nextIndex < 0 || m_nextIndex >= m_playlist.size()) {
+            m_nextIndex = pickNextIndex();
+        }
+        const QUrl &url = m_playlist[m_nextIndex];
+        if (m_nextPlayer->source() != url) {
+            m_nextPlayer->setSource(url);
+        }
+    }
+    
+    // 播放列表或播放模式变化后重新预选
+    void resetPreroll()
+    {
+        m_switchTimer->stop();
+        m_nextIndex = -1;
+        if (!m_retiring) {
+            m_nextPlayer->setSource(QUrl());
+        }
+        if (m_player->playbackState() != QMediaPlayer::StoppedState) {
+            prerollNext();
+        }
+    }
+    
+    // 交换当前播放器与预载播放器；stopOld 为 false 时旧播放器播完剩余部分后自行停止
+    void swapPlayers(bool stopOld)
+    {
+        std::swap(m_player, m_nextPlayer);
+        std::swap(m_audioOutput, m_nextOutput);
+        m_nextIndex = -1;
+        attachPlayer(m_player);
+        updateDuration(m_player->duration());
+        
+        m_retiring = !stopOld && m_nextPlayer->playbackState() == QMediaPlayer::PlayingState;
+        if (!m_retiring) {
+            m_nextPlayer->stop();
+        }
+    }
+    
+    // 曲尾临近时按提前量定好切换时刻
+    void armSwitch(qint64 position)
+    {
+        if (m_playMode == SingleLoop || m_switchTimer->isActive() || !prerollReady()) return;
+        if (m_player->playbackState() != QMediaPlayer::PlayingState) return;
+        
+        const qint64 duration = m_player->duration();
+        const qint64 remaining = duration - position;
+        if (duration <= 0 || remaining > m_crossfadeMs + SWITCH_WINDOW_MS) return;
+        m_switchTimer->start(qMax<qint64>(0, remaining - m_crossfadeMs - qRound(m_startLeadMs)));
+    }
+    
+    // 两端时刻都已知时计算间隙，并据此调整下次的提前量
+    void finishGapMeasurement()
+    {
+        if (m_oldEndMs < 0 || m_newStartMs < 0) return;
+        
+        m_lastGapMs = m_newStartMs - m_oldEndMs;
+        // 启动延迟 = 间隙 + 本次提前量
+        const double latency = m_lastGapMs + m_appliedLeadMs;
+        m_startLeadMs = qBound(0.0, m_startLeadMs * 0.5 + latency * 0.5, double(MAX_LEAD_MS));
+        m_oldEndMs = -1;
+        m_newStartMs = -1;
+        qDebug() << "曲间间隙:" << m_lastGapMs << "ms，下次提前量:" << m_startLeadMs << "ms";
+        emit transitionGapMeasured(m_lastGapMs, m_startLeadMs, m_switchBuffered);
+    }
+    
+    // 中止交叉淡化：旧曲尾部立即停止，当前曲目恢复正常音量
+    void stopCrossfade()
+    {
+        if (!m_crossfader->isActive()) return;
+        m_crossfader->finish();
+        if (m_retiring) {
+            m_retiring = false;
+            m_oldEndMs = -1;
+            m_nextPlayer->stop();
+            prerollNext();
+        }
+        applyVolume();
+    }
+    
+    // 曲目切换后加载歌词、波形与响度增益
+    void onTrackChanged()
+    {
+        // 换曲后之前记下的跳转位置不再有效
+        m_pendingSeekMs = -1;
+        // 加载歌词
+        loadLyrics();
+        // 加载波形概览
+        loadWaveform();
+        // 应用响度归一化增益
+        updateTrackGain();
     }
 
     // 格式化时间显示
@@ -729,6 +1082,7 @@ private slots:
             
             // 添加到播放列表
             m_playlist.append(songUrl);
+            resetPreroll();
             
             // 显示歌曲信息
             QString displayName = QString("%1 - %2").arg(song.name).arg(song.artist);
@@ -749,6 +1103,44 @@ private slots:
         delete searchDialog;
     }
     
+    // 在已索引的本地歌词中搜索，选中结果后跳转到该句
+    void onSearchLyrics()
+    {
+        LyricSearchDialog *searchDialog = new LyricSearchDialog(m_lyricSearch, this);
+        connect(searchDialog, &LyricSearchDialog::hitSelected, this, [this](const LyricSearchHit &hit) {
+            playAt(hit.audioPath, hit.timestamp);
+        });
+        searchDialog->exec();
+        delete searchDialog;
+    }
+    
+    // 播放某个本地文件并跳转到指定位置（不在播放列表中时先加入）
+    void playAt(const QString &audioPath, qint64 positionMs)
+    {
+        const QUrl url = QUrl::fromLocalFile(audioPath);
+        int index = m_playlist.indexOf(url);
+        if (index < 0) {
+            if (!QFileInfo::exists(audioPath)) return;
+            m_playlist.append(url);
+            m_playListWidget->addItem(QFileInfo(audioPath).fileName());
+            resetPreroll();
+            index = m_playlist.size() - 1;
+        }
+        
+        m_currentIndex = index;
+        play();
+        
+        // 媒体尚未加载时记下位置，加载完成后再跳转
+        const QMediaPlayer::MediaStatus status = m_player->mediaStatus();
+        if (status == QMediaPlayer::LoadedMedia || status == QMediaPlayer::BufferingMedia
+            || status == QMediaPlayer::BufferedMedia) {
+            m_player->setPosition(positionMs);
+            m_pendingSeekMs = -1;
+        } else {
+            m_pendingSeekMs = positionMs;
+        }
+    }
+    
     // 测试音频功能
     void testAudio()
     {
@@ -813,7 +1205,11 @@ private slots:
         // 检查播放列表
         info += "【播放列表】\n";
         info += QString("歌曲数量: %1\n").arg(m_playlist.size());
-        info += QString("当前索引: %1\n\n").arg(m_currentIndex);
+        info += QString("当前索引: %1\n").arg(m_currentIndex);
+        info += QString("曲间间隙: %1ms（提前量 %2ms）\n")
+                    .arg(m_lastGapMs, 0, 'f', 1).arg(m_startLeadMs, 0, 'f', 1);
+        info += QString("交叉淡化: %1ms（单次更新 %2μs）\n\n")
+                    .arg(m_crossfadeMs).arg(m_crossfader->averageStepCostNs() / 1000.0, 0, 'f', 1);
         
         // 检查错误
         if (m_player->error() != QMediaPlayer::NoError) {
@@ -897,6 +1293,7 @@ private slots:
             }
         }
         
+        resetPreroll();
         qDebug() << "已删除歌曲，当前索引:" << m_currentIndex << "播放列表大小:" << m_playlist.size();
     }
     
@@ -966,6 +1363,8 @@ private slots:
         
         // 清空列表
         m_playlist.clear();
+        stopCrossfade();
+        resetPreroll();
         m_playListWidget->clear();
         m_currentIndex = -1;
         m_lyricWidget->clear();
@@ -992,11 +1391,19 @@ private slots:
         if (m_playlist.isEmpty() || m_currentIndex < 0 || m_currentIndex >= m_playlist.size())
             return;
         
-        // 只有当源不同时才重新设置源
-        if (m_player->source() != m_playlist[m_currentIndex]) {
-            m_player->setSource(m_playlist[m_currentIndex]);
-            // 加载歌词
-            loadLyrics();
+        // 只有当源不同时才重新设置源；目标恰是已预载的曲目时直接换用预载播放器
+        const QUrl &url = m_playlist[m_currentIndex];
+        if (m_player->source() != url) {
+            m_switchTimer->stop();
+            stopCrossfade();
+            if (prerollReady() && m_nextPlayer->source() == url) {
+                swapPlayers(true);
+                prerollNext();
+            } else {
+                m_nextIndex = -1;
+                m_player->setSource(url);
+            }
+            onTrackChanged();
         }
         
         // 确保音频输出已设置且音量正确
@@ -1005,11 +1412,9 @@ private slots:
             qDebug() << "重新设置音频输出";
         }
         
-        // 确保音量不为0
-        qreal currentVolume = m_audioOutput->volume();
-        qDebug() << "当前音量:" << currentVolume;
-        if (currentVolume < 0.01) {
-            m_audioOutput->setVolume(0.8);
+        // 确保音量不为0（按滑块判断，响度增益不计入）
+        qDebug() << "当前音量:" << m_audioOutput->volume();
+        if (m_volumeSlider->value() < 1) {
             m_volumeSlider->setValue(80);
             qDebug() << "音量过低，已重置为80%";
         }
@@ -1026,45 +1431,100 @@ private slots:
         m_btnPlayPause->setIconSize(QSize(48, 48));
     }
     
-    // 加载歌词
+    // 加载歌词：在后台线程查找并解析，结果异步返回
     void loadLyrics()
     {
-        if (m_currentIndex < 0 || m_currentIndex >= m_playlist.size()) {
-            m_lyricWidget->clear();
+        m_lyricWidget->clear();
+        m_lyricDownloader->cancel(m_lyricDownloadTask);
+        if (m_currentIndex < 0 || m_currentIndex >= m_playlist.size()
+            || !m_playlist[m_currentIndex].isLocalFile()) {
+            m_lyricLoader->cancel();
             return;
         }
         
-        QString audioPath = m_playlist[m_currentIndex].toLocalFile();
-        
-        // 首先尝试从本地加载歌词
-        QList<LyricLine> lyrics = LyricParser::autoLoadLyrics(audioPath);
+        m_lyricLoader->request(m_playlist[m_currentIndex].toLocalFile());
+    }
+    
+    bool isCurrentTrack(const QString &audioPath) const
+    {
+        return m_currentIndex >= 0 && m_currentIndex < m_playlist.size()
+               && m_playlist[m_currentIndex].toLocalFile() == audioPath;
+    }
+    
+    // 本地没有歌词时尝试在线下载（异步），成功后重新加载
+    void downloadLyrics(const QString &audioPath)
+    {
+        if (!isCurrentTrack(audioPath) || audioPath == m_lyricDownloadedFor) return;
+        qDebug() << "本地未找到歌词文件，尝试在线下载...";
         
-        if (lyrics.isEmpty()) {
-            qDebug() << "本地未找到歌词文件，尝试在线下载...";
-            
-            // 显示下载提示
-            m_lyricWidget->clear();
+        m_lyricDownloader->cancel(m_lyricDownloadTask);
+        m_lyricDownloadPath = audioPath;
+        m_lyricDownloadTask = m_lyricDownloader->autoDownloadLyric(audioPath);
+    }
+    
+    // 歌词下载完成（切歌时任务已被取消，这里再核对一次曲目）
+    void onLyricDownloadFinished(const QString &audioPath, bool success, const QString &message)
+    {
+        const bool requested = audioPath == m_lyricDownloadPath;
+        if (requested) m_lyricDownloadPath.clear();
+        
+        if (success) {
+            // 批量预取恰好取到当前曲目时同样重新加载
+            if (isCurrentTrack(audioPath)) {
+                qDebug() << "歌词下载成功，重新加载";
+                m_lyricDownloadedFor = audioPath;
+                m_lyricLoader->request(audioPath, true);
+            }
             
-            // 在后台下载歌词
-            QTimer::singleShot(100, this, [this, audioPath]() {
-                bool success = m_lyricDownloader->autoDownloadLyric(audioPath);
-                
-                if (success) {
-                    qDebug() << "歌词下载成功，重新加载";
-                    // 重新加载歌词
-                    QList<LyricLine> lyrics = LyricParser::autoLoadLyrics(audioPath);
-                    m_lyricWidget->setLyrics(lyrics);
-                    
-                    // 可选：显示成功提示
-                    QMessageBox::information(this, "提示", "歌词下载成功！");
-                } else {
-                    qDebug() << "歌词下载失败:" << m_lyricDownloader->lastError();
-                    // 可选：显示失败提示
-                    // QMessageBox::warning(this, "提示", "未找到歌词：" + m_lyricDownloader->lastError());
-                }
-            });
+            if (requested) showLyricStatus("歌词下载成功");
+        } else if (requested) {
+            qDebug() << "歌词下载失败:" << message;
+            // 可选：显示失败提示
+            // QMessageBox::warning(this, "提示", "未找到歌词：" + message);
+        }
+    }
+
+    // 在歌词区下方短暂显示一条提示
+    void showLyricStatus(const QString &message)
+    {
+        m_lyricStatus->setText(message);
+        m_lyricStatus->show();
+        m_lyricStatusTimer->start();
+    }
+
+    // 根据响度缓存更新当前曲目的增益；尚未分析完成时保持原音量
+    void updateTrackGain()
+    {
+        m_trackGain = 1.0;
+        const QUrl &url = m_playlist[m_currentIndex];
+        LoudnessResult loudness;
+        if (url.isLocalFile() && m_loudnessScanner->lookup(url.toLocalFile(), loudness)) {
+            // QAudioOutput 音量上限为 1.0，只能衰减，不能提升
+            m_trackGain = qMin(1.0, qPow(10.0, loudness.replayGainDb() / 20.0));
+            qDebug() << "响度归一化:" << loudness.integratedLufs << "LUFS, 增益"
+                     << loudness.replayGainDb() << "dB";
+        }
+        applyVolume();
+    }
+    
+    // 音量 = 滑块音量 × 响度增益（淡入过程中交给淡化曲线）
+    void applyVolume()
+    {
+        const qreal volume = m_volumeSlider->value() / 100.0 * m_trackGain;
+        if (m_crossfader->isActive()) {
+            m_crossfader->setIncomingBase(volume);
         } else {
-            m_lyricWidget->setLyrics(lyrics);
+            m_audioOutput->setVolume(volume);
+        }
+    }
+
+    // 加载波形概览（仅本地文件）
+    void loadWaveform()
+    {
+        m_progressSlider->clearWaveform();
+        const QUrl &url = m_playlist[m_currentIndex];
+        if (url.isLocalFile()) {
+            m_waveformOverview->request(url.toLocalFile());
         }
     }
 
@@ -1072,6 +1532,8 @@ private slots:
     void pause()
     {
         m_player->pause();
+        m_switchTimer->stop();
+        stopCrossfade();
         m_spectrumWidget->setPlaying(false);
         m_btnPlayPause->setIcon(QIcon("./assets/play.png"));
         m_btnPlayPause->setIconSize(QSize(48, 48));
@@ -1091,29 +1553,57 @@ private slots:
         play();
     }
 
-    // 下一首
+    // 下一首（优先使用已预选的曲目，随机模式下与预载结果一致）
     void next()
     {
         if (m_playlist.isEmpty()) return;
         
-        if (m_playMode == Random) {
-            m_currentIndex = QRandomGenerator::global()->bounded(m_playlist.size());
+        if (m_nextIndex >= 0 && m_nextIndex < m_playlist.size()) {
+            m_currentIndex = m_nextIndex;
         } else {
-            if (m_currentIndex < m_playlist.size() - 1) {
-                m_currentIndex++;
-            } else {
-                m_currentIndex = 0;
-            }
+            m_currentIndex = pickNextIndex();
         }
         
         play();
     }
+    
+    // 曲尾切换到预载播放器：旧播放器继续播完剩余部分（开启交叉淡化时同时淡出）
+    void startPrerolledNext()
+    {
+        if (m_playMode == SingleLoop || !prerollReady()) return;
+        
+        const bool oldPlaying = m_player->playbackState() == QMediaPlayer::PlayingState
+                                && m_player->mediaStatus() != QMediaPlayer::EndOfMedia;
+        const qint64 remaining = m_player->duration() - m_player->position();
+        const bool crossfade = oldPlaying && m_crossfadeMs > 0 && remaining > 0;
+        
+        // 交叉淡化是有意的重叠，不计入间隙测量
+        m_appliedLeadMs = oldPlaying ? m_startLeadMs : 0.0;
+        m_switchBuffered = m_nextPlayer->mediaStatus() == QMediaPlayer::BufferedMedia;
+        m_oldEndMs = oldPlaying ? -1 : m_gapClock.elapsed();
+        m_newStartMs = -1;
+        m_awaitingStart = !crossfade;
+        
+        m_currentIndex = m_nextIndex;
+        swapPlayers(!oldPlaying);
+        if (crossfade) {
+            m_crossfader->start(m_nextOutput, m_nextOutput->volume(),
+                                m_audioOutput, m_volumeSlider->value() / 100.0,
+                                static_cast<int>(qMin<qint64>(m_crossfadeMs, remaining)));
+        }
+        m_player->play();
+        onTrackChanged();
+        m_spectrumWidget->setPlaying(true);
+        m_playListWidget->setCurrentRow(m_currentIndex);
+        prerollNext();
+    }
 
     // 设置播放模式
     void setPlayMode(PlayMode mode)
     {
         m_playMode = mode;
         updatePlayModeUI();
+        resetPreroll();
     }
 
     // 更新播放按钮状态
@@ -1135,6 +1625,14 @@ private slots:
     void updatePosition(qint64 position)
     {
         m_currentTime->setText(formatTime(position));
+        
+        // 新曲目首个位置上报：回推实际开始时刻
+        if (m_awaitingStart && position > 0) {
+            m_awaitingStart = false;
+            m_newStartMs = m_gapClock.elapsed() - position;
+            finishGapMeasurement();
+        }
+        armSwitch(position);
 
         if (!m_progressSlider->isSliderDown())
         {
@@ -1154,14 +1652,15 @@ private slots:
     // 跳转到指定位置
     void seek(int position)
     {
+        m_switchTimer->stop();
+        stopCrossfade();
         m_player->setPosition(position);
     }
     
     // 音量改变
     void onVolumeChanged(int value)
     {
-        qreal volume = value / 100.0;  // 转换为 0.0 到 1.0
-        m_audioOutput->setVolume(volume);
+        applyVolume();
         m_volumeLabel->setText(QString("%1%").arg(value));
         
         // 更新音量图标
@@ -1198,6 +1697,8 @@ private slots:
                 // 单曲循环：重置到开头并继续播放
                 m_player->setPosition(0);
                 m_player->play();
+            } else if (prerollReady()) {
+                startPrerolledNext(); // 定时切换未触发时的兜底
             } else {
                 next(); // 播放下一首
             }
@@ -1205,9 +1706,22 @@ private slots:
             QMessageBox::warning(this, "错误", "无效的媒体文件！\n请检查文件格式是否支持。");
         } else if (status == QMediaPlayer::LoadedMedia) {
             qDebug() << "媒体加载成功，时长:" << m_player->duration() << "ms";
+            applyPendingSeek();
+            prerollNext();
+        } else if (status == QMediaPlayer::BufferedMedia) {
+            applyPendingSeek();
+            prerollNext();
         }
     }
     
+    // 歌词搜索跳转：媒体加载完成后执行
+    void applyPendingSeek()
+    {
+        if (m_pendingSeekMs < 0) return;
+        m_player->setPosition(m_pendingSeekMs);
+        m_pendingSeekMs = -1;
+    }
+    
     // 播放器错误处理
     void onPlayerError(QMediaPlayer::Error error, const QString &errorString)
     {
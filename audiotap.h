@@ -0,0 +1,278 @@
+#ifndef AUDIOTAP_H
+#define AUDIOTAP_H
+
+#include <QObject>
+#include <QThread>
+#include <QAudioDecoder>
+#include <QAudioBuffer>
+#include <QAudioFormat>
+#include <QMediaPlayer>
+#include <QTimer>
+#include <QVector>
+#include <QUrl>
+#include <QDebug>
+#include <atomic>
+#include "pcmringbuffer.h"
+#include "pcmconverter.h"
+#include "beatdetector.h"
+
+// 解码线程中的工作对象：按播放进度读取解码数据，混缩为单声道后写入无锁环形缓冲，
+// 同时做节拍检测
+class AudioTapWorker : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const qint64 LOOKAHEAD_US = 30000;      // 允许领先播放头的时间（微秒）
+    static const qint64 RESYNC_US = 500000;        // 判定为向后跳转的阈值（微秒）
+    static const int SCRATCH_FRAMES = 16384;       // 预分配的混缩缓冲帧数
+    static const qint64 STALE_BEAT_US = 200000;    // 早于播放头这么久的节拍不再发布（快进追赶时）
+    static const int MAX_BEATS = 16;               // 单块最多发布的节拍数
+
+    PcmRingBuffer *m_ring;                  // 输出缓冲（由 AudioTap 持有）
+    const std::atomic<qint64> *m_playheadUs; // 播放头位置（由 GUI 线程更新）
+    std::atomic<int> *m_sampleRate;         // 当前采样率（发布给 GUI 线程）
+    std::atomic<qint64> *m_beatCostNs;      // 节拍检测平均每块耗时（发布给 GUI 线程）
+
+    QAudioDecoder *m_decoder = nullptr;     // 独立解码器（在解码线程中创建）
+    QTimer *m_pumpTimer = nullptr;          // 节流定时器
+    QAudioBuffer m_pending;                 // 已读出但尚未到播放时间的缓冲
+    QUrl m_source;                          // 当前音源
+    QVector<float> m_scratch;               // 混缩缓冲
+    qint64 m_streamTimeUs = 0;              // 已写入样本对应的流时间
+    BeatDetector m_beatDetector;            // 节拍检测器
+    BeatEvent m_beats[MAX_BEATS];           // 单块检测结果
+    double m_publishedBpm = 0.0;            // 已发布的 BPM
+
+public:
+    AudioTapWorker(PcmRingBuffer *ring, const std::atomic<qint64> *playheadUs,
+                   std::atomic<int> *sampleRate, std::atomic<qint64> *beatCostNs)
+        : m_ring(ring)
+        , m_playheadUs(playheadUs)
+        , m_sampleRate(sampleRate)
+        , m_beatCostNs(beatCostNs)
+    {
+        m_scratch.resize(SCRATCH_FRAMES);
+    }
+
+public slots:
+    // 在解码线程启动后创建解码器与定时器
+    void initialize()
+    {
+        m_decoder = new QAudioDecoder(this);
+        connect(m_decoder, &QAudioDecoder::bufferReady, this, &AudioTapWorker::pump);
+        connect(m_decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error),
+                this, [this](QAudioDecoder::Error error) {
+            qDebug() << "音频抽头解码错误:" << error << m_decoder->errorString();
+        });
+
+        m_pumpTimer = new QTimer(this);
+        m_pumpTimer->setInterval(20);
+        connect(m_pumpTimer, &QTimer::timeout, this, &AudioTapWorker::pump);
+    }
+
+    // 切换音源：重新开始解码
+    void restart(const QUrl &source)
+    {
+        m_source = source;
+        m_decoder->stop();
+        m_pending = QAudioBuffer();
+        m_streamTimeUs = 0;
+        m_beatDetector.reset(m_beatDetector.sampleRate());
+        publishTempo();
+
+        // 网络音源不重复拉流，只分析本地文件
+        if (source.isLocalFile()) {
+            m_decoder->setSource(source);
+            m_decoder->start();
+        }
+    }
+
+    // 播放时按节拍读取，暂停/停止时停止读取
+    void setActive(bool active)
+    {
+        if (active) {
+            m_pumpTimer->start();
+        } else {
+            m_pumpTimer->stop();
+        }
+    }
+
+signals:
+    // 检测到节拍（timeUs 为流时间）
+    void beatDetected(qint64 timeUs, float strength);
+    // BPM 估计变化，0 表示未锁定
+    void tempoChanged(double bpm);
+
+private slots:
+    // 按播放进度把解码数据推入环形缓冲
+    void pump()
+    {
+        const qint64 playheadUs = m_playheadUs->load(std::memory_order_relaxed);
+
+        // 播放头回退（向后跳转）时解码器无法回溯，只能从头重新解码
+        if (m_streamTimeUs > playheadUs + LOOKAHEAD_US + RESYNC_US) {
+            restart(m_source);
+            return;
+        }
+
+        for (;;) {
+            if (!m_pending.isValid()) {
+                if (!m_decoder->bufferAvailable()) break;
+                m_pending = m_decoder->read();
+                if (!m_pending.isValid()) break;
+            }
+            if (m_pending.startTime() > playheadUs + LOOKAHEAD_US) {
+                break;  // 尚未播放到，留待下次
+            }
+            append(m_pending);
+            m_pending = QAudioBuffer();
+        }
+    }
+
+private:
+    // 混缩为单声道并写入环形缓冲
+    void append(const QAudioBuffer &buffer)
+    {
+        const QAudioFormat format = buffer.format();
+        const int channels = format.channelCount();
+        const int frames = static_cast<int>(buffer.frameCount());
+        if (channels <= 0 || frames <= 0) return;
+
+        m_sampleRate->store(format.sampleRate(), std::memory_order_relaxed);
+        m_streamTimeUs = buffer.startTime() + format.durationForFrames(frames);
+        if (m_beatDetector.sampleRate() != format.sampleRate()) {
+            m_beatDetector.reset(format.sampleRate());
+        }
+
+        // 按预分配缓冲分块处理，超大缓冲也不会触发分配
+        const qint64 playheadUs = m_playheadUs->load(std::memory_order_relaxed);
+        for (int offset = 0; offset < frames; offset += SCRATCH_FRAMES) {
+            const int count = qMin(SCRATCH_FRAMES, frames - offset);
+            if (!PcmConverter::toMono(buffer, offset, count, m_scratch.data())) return;
+            m_ring->write(m_scratch.constData(), count);
+
+            const int beats = m_beatDetector.process(m_scratch.constData(), count,
+                                                     buffer.startTime() + format.durationForFrames(offset),
+                                                     m_beats, MAX_BEATS);
+            for (int i = 0; i < beats; ++i) {
+                if (m_beats[i].timeUs >= playheadUs - STALE_BEAT_US) {
+                    emit beatDetected(m_beats[i].timeUs, m_beats[i].strength);
+                }
+            }
+        }
+        m_beatCostNs->store(static_cast<qint64>(m_beatDetector.averageCostNs()), std::memory_order_relaxed);
+        publishTempo();
+    }
+
+    // BPM 变化超过 0.5 时发布
+    void publishTempo()
+    {
+        const double bpm = m_beatDetector.bpm();
+        if (qAbs(bpm - m_publishedBpm) < 0.5 && (bpm > 0.0) == (m_publishedBpm > 0.0)) return;
+        m_publishedBpm = bpm;
+        emit tempoChanged(bpm);
+    }
+};
+
+// 音频 PCM 抽头
+// Qt6 移除了 QAudioProbe，QMediaPlayer 不再暴露解码后的 PCM。
+// 这里在独立线程中用 QAudioDecoder 解码与播放器相同的音源，并按播放进度节流读取，
+// 经无锁环形缓冲交给 GUI 线程，供频谱分析使用；解码线程中同时做节拍检测。
+class AudioTap : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int RING_FRAMES = 16384;   // 环形缓冲容量
+
+    QMediaPlayer *m_player;                 // 跟随的播放器
+    QThread m_thread;                       // 解码线程
+    AudioTapWorker *m_worker;               // 解码线程中的工作对象
+    PcmRingBuffer m_ring;                   // 解码线程 -> GUI 线程
+    std::atomic<qint64> m_playheadUs;       // 播放头位置（微秒）
+    std::atomic<int> m_sampleRate;          // 当前采样率
+    std::atomic<qint64> m_beatCostNs;       // 节拍检测平均每块耗时
+
+public:
+    explicit AudioTap(QObject *parent = nullptr)
+        : QObject(parent)
+        , m_player(nullptr)
+        , m_ring(RING_FRAMES)
+        , m_playheadUs(0)
+        , m_sampleRate(0)
+        , m_beatCostNs(0)
+    {
+        m_worker = new AudioTapWorker(&m_ring, &m_playheadUs, &m_sampleRate, &m_beatCostNs);
+        m_worker->moveToThread(&m_thread);
+        connect(m_worker, &AudioTapWorker::beatDetected, this, &AudioTap::beatDetected);
+        connect(m_worker, &AudioTapWorker::tempoChanged, this, &AudioTap::tempoChanged);
+        connect(&m_thread, &QThread::started, m_worker, &AudioTapWorker::initialize);
+        connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+        m_thread.setObjectName("AudioTap");
+        m_thread.start();
+    }
+
+    ~AudioTap()
+    {
+        m_thread.quit();
+        m_thread.wait();
+    }
+
+    // 关联媒体播放器，自动跟随音源与播放状态
+    void setMediaPlayer(QMediaPlayer *player)
+    {
+        if (m_player) {
+            disconnect(m_player, nullptr, this, nullptr);
+        }
+        m_player = player;
+        if (!m_player) {
+            restartWorker(QUrl());
+            return;
+        }
+
+        connect(m_player, &QMediaPlayer::sourceChanged, this, &AudioTap::restartWorker);
+        connect(m_player, &QMediaPlayer::positionChanged, this, [this](qint64 position) {
+            m_playheadUs.store(position * 1000, std::memory_order_relaxed);
+        });
+        connect(m_player, &QMediaPlayer::playbackStateChanged, this,
+                [this](QMediaPlayer::PlaybackState state) {
+            const bool active = (state == QMediaPlayer::PlayingState);
+            QMetaObject::invokeMethod(m_worker, [worker = m_worker, active]() {
+                worker->setActive(active);
+            }, Qt::QueuedConnection);
+        });
+        restartWorker(m_player->source());
+    }
+
+    int sampleRate() const { return m_sampleRate.load(std::memory_order_relaxed); }
+
+    // 节拍检测平均每块耗时（纳秒）
+    qint64 beatCostNs() const { return m_beatCostNs.load(std::memory_order_relaxed); }
+
+    // 复制播放头处最新的 frames 个样本；数据不足或读取时恰被覆盖则返回 false
+    bool copyLatest(float *dest, int frames)
+    {
+        if (m_player) {
+            m_playheadUs.store(m_player->position() * 1000, std::memory_order_relaxed);
+        }
+        return m_ring.readLatest(dest, frames);
+    }
+
+signals:
+    // 检测到节拍（在 GUI 线程中发出；解码领先播放头最多约 30ms）
+    void beatDetected(qint64 timeUs, float strength);
+    // BPM 估计变化，0 表示未锁定
+    void tempoChanged(double bpm);
+
+private slots:
+    void restartWorker(const QUrl &source)
+    {
+        m_playheadUs.store(0, std::memory_order_relaxed);
+        QMetaObject::invokeMethod(m_worker, [worker = m_worker, source]() {
+            worker->restart(source);
+        }, Qt::QueuedConnection);
+    }
+};
+
+#endif // AUDIOTAP_H
@@ -0,0 +1,257 @@
+#ifndef BEATDETECTOR_H
+#define BEATDETECTOR_H
+
+#include <QVector>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <cstring>
+#include "spectrumanalyzer.h"
+
+// 一次检测到的节拍
+struct BeatEvent
+{
+    qint64 timeUs;      // 流时间（微秒）
+    float strength;     // 强度 0~1（超出自适应阈值的程度）
+};
+
+// 实时起音/节拍检测器
+// 流程：单声道 PCM -> 1024 点帧、512 点跳步 -> 粗 Mel 频带 -> 频谱通量（正向差分之和）
+//      -> 局部均值自适应阈值 + 峰值拾取 -> 节拍事件；通量历史自相关估计 BPM
+// 按块增量处理，所有缓冲在构造时定长分配，内存占用与输入长度无关
+class BeatDetector
+{
+private:
+    static const int FRAME_SIZE = 1024;         // 分析帧长
+    static const int HOP_SIZE = 512;            // 跳步
+    static const int BAND_COUNT = 32;           // 通量计算用的频带数
+    static const int THRESHOLD_WINDOW = 24;     // 自适应阈值窗口（跳步数，约 0.28 秒）
+    static const int HISTORY = 384;             // BPM 估计用的通量历史（跳步数，约 4.5 秒）
+    static const int TEMPO_INTERVAL = 43;       // 每隔多少跳步重新估计一次 BPM（约 0.5 秒）
+    static constexpr float THRESHOLD_RATIO = 1.5f;     // 阈值 = 局部均值 * 系数 + 下限
+    static constexpr float THRESHOLD_FLOOR = 0.01f;
+    static constexpr qint64 MIN_INTERVAL_US = 250000;  // 相邻节拍最小间隔（对应 240 BPM）
+    static constexpr double MIN_BPM = 60.0;
+    static constexpr double MAX_BPM = 180.0;
+
+    SpectrumAnalyzer m_analyzer;        // 复用频谱分析器做 FFT 与频带映射
+    int m_sampleRate;
+
+    QVector<float> m_frame;             // 当前分析帧
+    int m_fill;                         // 帧内已填充样本数
+    QVector<float> m_bands;             // 本帧频带
+    QVector<float> m_prevBands;         // 上一帧频带
+    bool m_hasPrev;
+
+    QVector<float> m_flux;              // 通量环形历史
+    int m_fluxCount;                    // 已写入的通量总数
+    float m_windowSum;                  // 阈值窗口内的通量和
+
+    // 峰值拾取需要延迟一个跳步：n-1 处的通量同时大于 n-2 与 n 才算峰
+    float m_candidateFlux;
+    float m_candidateThreshold;
+    qint64 m_candidateUs;
+    float m_prevFlux;
+    qint64 m_lastBeatUs;
+
+    double m_bpm;                       // 当前 BPM 估计，0 表示尚未锁定
+    double m_pendingBpm;                // 与当前估计不一致的新候选
+    int m_pendingVotes;                 // 新候选连续出现的次数
+    int m_hopsSinceTempo;
+
+    // 性能统计
+    qint64 m_lastCostNs;                // 最近一块的处理耗时
+    double m_averageCostNs;             // 平滑后的平均耗时
+
+public:
+    BeatDetector()
+        : m_analyzer(BandLayout<BandScale::Mel, BAND_COUNT, FRAME_SIZE>::Table)
+        , m_sampleRate(0)
+        , m_lastCostNs(0)
+        , m_averageCostNs(0.0)
+    {
+        m_frame.resize(FRAME_SIZE);
+        m_bands.resize(BAND_COUNT);
+        m_prevBands.resize(BAND_COUNT);
+        m_flux.resize(HISTORY);
+        reset(44100);
+    }
+
+    // 切换音源或跳转后清空状态
+    void reset(int sampleRate)
+    {
+        m_sampleRate = sampleRate;
+        m_analyzer.setSampleRate(sampleRate);
+        m_fill = 0;
+        m_hasPrev = false;
+        m_flux.fill(0.0f);
+        m_fluxCount = 0;
+        m_windowSum = 0.0f;
+        m_candidateFlux = 0.0f;
+        m_candidateThreshold = 0.0f;
+        m_candidateUs = 0;
+        m_prevFlux = 0.0f;
+        m_lastBeatUs = -MIN_INTERVAL_US;
+        m_bpm = 0.0;
+        m_pendingBpm = 0.0;
+        m_pendingVotes = 0;
+        m_hopsSinceTempo = 0;
+    }
+
+    int sampleRate() const { return m_sampleRate; }
+
+    // 当前 BPM 估计，0 表示尚未锁定
+    double bpm() const { return m_bpm; }
+
+    // 最近一块 / 平均每块处理耗时（纳秒）
+    qint64 lastCostNs() const { return m_lastCostNs; }
+    double averageCostNs() const { return m_averageCostNs; }
+
+    // 处理一块连续的单声道样本，startTimeUs 为首个样本的流时间
+    // 检测到的节拍写入 events（最多 maxEvents 个），返回写入数量
+    int process(const float *samples, int frames, qint64 startTimeUs,
+                BeatEvent *events, int maxEvents)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        int count = 0;
+        int consumed = 0;
+        while (consumed < frames) {
+            const int n = qMin(FRAME_SIZE - m_fill, frames - consumed);
+            std::memcpy(m_frame.data() + m_fill, samples + consumed, n * sizeof(float));
+            m_fill += n;
+            consumed += n;
+            if (m_fill < FRAME_SIZE) break;
+
+            // 帧中心的流时间（帧可能跨越上一块，偏移为负即可）
+            const qint64 centerUs = startTimeUs
+                + (consumed - FRAME_SIZE / 2) * qint64(1000000) / m_sampleRate;
+            BeatEvent event;
+            if (analyzeFrame(centerUs, &event) && count < maxEvents) {
+                events[count++] = event;
+            }
+
+            std::memmove(m_frame.data(), m_frame.constData() + HOP_SIZE,
+                         (FRAME_SIZE - HOP_SIZE) * sizeof(float));
+            m_fill = FRAME_SIZE - HOP_SIZE;
+        }
+
+        m_lastCostNs = timer.nsecsElapsed();
+        m_averageCostNs = m_averageCostNs <= 0.0
+            ? m_lastCostNs
+            : m_averageCostNs * 0.95 + m_lastCostNs * 0.05;
+        return count;
+    }
+
+private:
+    // 分析一帧；若上一跳步构成节拍则写入 beat 并返回 true
+    bool analyzeFrame(qint64 centerUs, BeatEvent *beat)
+    {
+        m_analyzer.analyze(m_frame.constData(), m_bands.data());
+
+        // 频谱通量：只累计能量上升的频带
+        float flux = 0.0f;
+        if (m_hasPrev) {
+            for (int b = 0; b < BAND_COUNT; ++b) {
+                flux += qMax(0.0f, m_bands[b] - m_prevBands[b]);
+            }
+            flux /= BAND_COUNT;
+        }
+        std::memcpy(m_prevBands.data(), m_bands.constData(), BAND_COUNT * sizeof(float));
+        m_hasPrev = true;
+
+        // 更新环形历史与阈值窗口的滑动和
+        if (m_fluxCount >= THRESHOLD_WINDOW) {
+            m_windowSum -= m_flux[(m_fluxCount - THRESHOLD_WINDOW) % HISTORY];
+        }
+        m_flux[m_fluxCount % HISTORY] = flux;
+        m_windowSum += flux;
+        ++m_fluxCount;
+
+        const int windowLength = qMin(m_fluxCount, THRESHOLD_WINDOW);
+        const float threshold = (m_windowSum / windowLength) * THRESHOLD_RATIO + THRESHOLD_FLOOR;
+
+        // 峰值拾取：上一跳步是局部极大、超过其阈值且距上一拍足够远
+        const bool isBeat = m_candidateFlux > m_prevFlux
+            && m_candidateFlux >= flux
+            && m_candidateFlux > m_candidateThreshold
+            && m_candidateUs - m_lastBeatUs >= MIN_INTERVAL_US;
+        if (isBeat) {
+            m_lastBeatUs = m_candidateUs;
+            beat->timeUs = m_candidateUs;
+            beat->strength = qBound(0.0f, m_candidateFlux / m_candidateThreshold - 1.0f, 1.0f);
+        }
+
+        m_prevFlux = m_candidateFlux;
+        m_candidateFlux = flux;
+        m_candidateThreshold = threshold;
+        m_candidateUs = centerUs;
+
+        if (++m_hopsSinceTempo >= TEMPO_INTERVAL && m_fluxCount >= HISTORY / 2) {
+            m_hopsSinceTempo = 0;
+            estimateTempo();
+        }
+        return isBeat;
+    }
+
+    // 对通量历史做自相关，在 MIN_BPM~MAX_BPM 对应的延迟范围内找最强周期
+    void estimateTempo()
+    {
+        const int length = qMin(m_fluxCount, HISTORY);
+        const int newest = m_fluxCount - 1;
+        const double hopsPerSecond = double(m_sampleRate) / HOP_SIZE;
+        const int minLag = qMax(1, int(hopsPerSecond * 60.0 / MAX_BPM));
+        const int maxLag = qMin(length / 2, int(hopsPerSecond * 60.0 / MIN_BPM) + 1);
+        if (minLag >= maxLag) return;
+
+        float mean = 0.0f;
+        for (int i = 0; i < length; ++i) mean += m_flux[(newest - i) % HISTORY];
+        mean /= length;
+
+        auto at = [&](int age) { return m_flux[(newest - age) % HISTORY] - mean; };
+        auto correlate = [&](int lag) {
+            double sum = 0.0;
+            for (int i = 0; i + lag < length; ++i) sum += at(i) * at(i + lag);
+            return sum / (length - lag);
+        };
+
+        int bestLag = 0;
+        double best = 0.0, left = 0.0, right = 0.0;
+        double prev = correlate(minLag - 1);
+        double current = correlate(minLag);
+        for (int lag = minLag; lag <= maxLag; ++lag) {
+            const double next = correlate(lag + 1);
+            if (current > best) {
+                best = current;
+                bestLag = lag;
+                left = prev;
+                right = next;
+            }
+            prev = current;
+            current = next;
+        }
+        if (bestLag == 0) return;
+
+        // 抛物线插值得到亚跳步精度的周期
+        double offset = 0.0;
+        const double denom = left - 2.0 * best + right;
+        if (denom < 0.0) offset = qBound(-0.5, 0.5 * (left - right) / denom, 0.5);
+        const double estimate = 60.0 * hopsPerSecond / (bestLag + offset);
+
+        // 与当前估计接近时平滑；明显不同时需连续出现 3 次才切换，避免来回跳动
+        if (m_bpm <= 0.0 || qAbs(estimate - m_bpm) / m_bpm < 0.08) {
+            m_bpm = (m_bpm <= 0.0) ? estimate : m_bpm * 0.8 + estimate * 0.2;
+            m_pendingVotes = 0;
+        } else if (m_pendingVotes > 0 && qAbs(estimate - m_pendingBpm) / m_pendingBpm < 0.08) {
+            if (++m_pendingVotes >= 3) {
+                m_bpm = estimate;
+                m_pendingVotes = 0;
+            }
+        } else {
+            m_pendingBpm = estimate;
+            m_pendingVotes = 1;
+        }
+    }
+};
+
+#endif // BEATDETECTOR_H
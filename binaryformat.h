@@ -0,0 +1,61 @@
+#ifndef BINARYFORMAT_H
+#define BINARYFORMAT_H
+
+#include <QString>
+#include <QByteArray>
+#include <QtEndian>
+#include <initializer_list>
+#include <cstring>
+
+// 缓存与索引文件共用的小端二进制格式工具
+// 文件头：4 字节标识 | quint32 版本 | quint32 字段…（其余补零到头部长度）；字符串按 UTF-16 小端存储
+class BinaryFormat
+{
+public:
+    // 生成文件头：标识、版本，之后依次为各字段
+    static QByteArray header(const char *magic, quint32 version, int headerSize,
+                             std::initializer_list<quint32> fields)
+    {
+        QByteArray bytes(headerSize, '\0');
+        uchar *out = reinterpret_cast<uchar *>(bytes.data());
+        memcpy(out, magic, 4);
+        qToLittleEndian<quint32>(version, out + 4);
+        int offset = 8;
+        for (quint32 field : fields) {
+            qToLittleEndian<quint32>(field, out + offset);
+            offset += 4;
+        }
+        return bytes;
+    }
+
+    // 检查映射内容的标识与版本
+    static bool checkHeader(const uchar *base, qint64 size, const char *magic, quint32 version, int headerSize)
+    {
+        return base && size >= headerSize && memcmp(base, magic, 4) == 0
+               && qFromLittleEndian<quint32>(base + 4) == version;
+    }
+
+    // 文件头中第 index 个字段（版本之后）
+    static quint32 headerField(const uchar *base, int index)
+    {
+        return qFromLittleEndian<quint32>(base + 8 + index * 4);
+    }
+
+    static void appendUtf16(QByteArray &buffer, const QString &text)
+    {
+        const qsizetype start = buffer.size();
+        buffer.resize(start + text.size() * 2);
+        qToLittleEndian<quint16>(text.constData(), text.size(), buffer.data() + start);
+    }
+
+    // 读取 length 个 UTF-16 单元并前移 p；调用方负责检查剩余长度
+    static QString readUtf16(const uchar *&p, qint64 length)
+    {
+        QString text(length, Qt::Uninitialized);
+        qFromLittleEndian<quint16>(p, length, text.data());
+        p += length * 2;
+        return text;
+    }
+};
+
+#endif // BINARYFORMAT_H
@@ -0,0 +1,56 @@
+#ifndef CACHEDIRECTORY_H
+#define CACHEDIRECTORY_H
+
+#include <QString>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDebug>
+
+// 缓存目录的容量控制（每个条目一个文件的缓存：波形旁路文件、已解析歌词等）
+// 以文件修改时间作为最近使用时间：命中时 touch() 刷新，写入新文件后 trim() 淘汰，
+// 超过有效期的直接删除，其余从最久未使用的开始删，直到总大小与文件数都在上限内
+class CacheDirectory
+{
+public:
+    // 标记为最近使用（Windows 上只读打开无法修改时间，故以读写方式打开）
+    static void touch(const QString &path)
+    {
+        QFile file(path);
+        if (file.open(QIODevice::ReadWrite)) {
+            file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+        }
+    }
+
+    // 淘汰 dirPath 下匹配 nameFilter 的文件，返回删除的文件数
+    static int trim(const QString &dirPath, const QString &nameFilter,
+                    qint64 maxBytes, int maxFiles, qint64 maxAgeMs)
+    {
+        // 按修改时间从新到旧
+        const QFileInfoList files = QDir(dirPath).entryInfoList({nameFilter}, QDir::Files, QDir::Time);
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        qint64 totalBytes = 0;
+        int kept = 0;
+        int removed = 0;
+        bool full = false;  // 已达上限，更旧的全部删除
+        for (const QFileInfo &info : files) {
+            if (!full && (kept >= maxFiles || totalBytes + info.size() > maxBytes)) {
+                full = true;
+            }
+            if (full || info.lastModified().msecsTo(now) > maxAgeMs) {
+                if (QFile::remove(info.absoluteFilePath())) ++removed;
+                continue;
+            }
+            totalBytes += info.size();
+            ++kept;
+        }
+        if (removed > 0) {
+            qDebug() << "缓存目录已清理:" << dirPath << "删除" << removed << "个，保留" << kept
+                     << "个，共" << totalBytes / 1024 << "KB";
+        }
+        return removed;
+    }
+};
+
+#endif // CACHEDIRECTORY_H
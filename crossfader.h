@@ -0,0 +1,125 @@
+#ifndef CROSSFADER_H
+#define CROSSFADER_H
+
+#include <QObject>
+#include <QAudioOutput>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QtMath>
+
+// 曲间交叉淡化
+// QMediaPlayer 不暴露解码后的 PCM，无法在软件中混音；两个播放器各自输出，
+// 由本类按等功率曲线（淡出 cos、淡入 sin，任意时刻功率和恒为 1）同步调节两个 QAudioOutput 的线性音量。
+// 曲线表在构造时生成，淡化过程中只做查表插值，不分配内存。
+class Crossfader : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int CURVE_SIZE = 513;      // 曲线表点数
+    static const int STEP_MS = 15;          // 音量更新周期
+
+    QVector<float> m_fadeIn;                // sin(πt/2)
+    QVector<float> m_fadeOut;               // cos(πt/2)
+    QTimer m_timer;                         // 音量更新定时器
+    QElapsedTimer m_clock;                  // 淡化进度计时
+
+    QPointer<QAudioOutput> m_outgoing;      // 淡出的输出
+    QPointer<QAudioOutput> m_incoming;      // 淡入的输出
+    double m_outgoingBase = 0.0;            // 淡出前的音量
+    double m_incomingBase = 0.0;            // 淡入目标音量
+    int m_durationMs = 0;                   // 淡化时长
+
+    // 性能统计
+    qint64 m_lastStepNs = 0;                // 最近一次音量更新耗时
+    double m_averageStepNs = 0.0;           // 平滑后的平均耗时
+
+public:
+    explicit Crossfader(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+        m_fadeIn.resize(CURVE_SIZE);
+        m_fadeOut.resize(CURVE_SIZE);
+        for (int i = 0; i < CURVE_SIZE; ++i) {
+            const double t = double(i) / (CURVE_SIZE - 1);
+            m_fadeIn[i] = static_cast<float>(qSin(t * M_PI / 2.0));
+            m_fadeOut[i] = static_cast<float>(qCos(t * M_PI / 2.0));
+        }
+
+        m_timer.setInterval(STEP_MS);
+        m_timer.setTimerType(Qt::PreciseTimer);
+        connect(&m_timer, &QTimer::timeout, this, &Crossfader::step);
+    }
+
+    bool isActive() const { return m_timer.isActive(); }
+
+    // 最近一次 / 平均单次音量更新耗时（纳秒）
+    qint64 lastStepCostNs() const { return m_lastStepNs; }
+    double averageStepCostNs() const { return m_averageStepNs; }
+
+    // 开始淡化：outgoing 从 outgoingBase 淡出到 0，incoming 从 0 淡入到 incomingBase
+    void start(QAudioOutput *outgoing, double outgoingBase,
+               QAudioOutput *incoming, double incomingBase, int durationMs)
+    {
+        m_outgoing = outgoing;
+        m_incoming = incoming;
+        m_outgoingBase = outgoingBase;
+        m_incomingBase = incomingBase;
+        m_durationMs = qMax(1, durationMs);
+        m_clock.start();
+        step();
+        m_timer.start();
+    }
+
+    // 淡化过程中调整淡入目标音量（音量滑块、响度增益变化时）
+    void setIncomingBase(double volume)
+    {
+        m_incomingBase = volume;
+        if (isActive()) step();
+    }
+
+    // 立即结束：淡出端静音，淡入端到达目标音量
+    void finish()
+    {
+        if (!isActive()) return;
+        m_timer.stop();
+        if (m_outgoing) m_outgoing->setVolume(0.0);
+        if (m_incoming) m_incoming->setVolume(m_incomingBase);
+        emit finished();
+    }
+
+signals:
+    void finished();
+
+private slots:
+    // 按进度查表插值并更新两个输出的音量
+    void step()
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        const double progress = qMin(1.0, double(m_clock.elapsed()) / m_durationMs);
+        const double position = progress * (CURVE_SIZE - 1);
+        const int index = qMin(static_cast<int>(position), CURVE_SIZE - 2);
+        const float frac = static_cast<float>(position - index);
+        const float fadeIn = m_fadeIn[index] + (m_fadeIn[index + 1] - m_fadeIn[index]) * frac;
+        const float fadeOut = m_fadeOut[index] + (m_fadeOut[index + 1] - m_fadeOut[index]) * frac;
+
+        if (m_outgoing) m_outgoing->setVolume(m_outgoingBase * fadeOut);
+        if (m_incoming) m_incoming->setVolume(m_incomingBase * fadeIn);
+
+        m_lastStepNs = timer.nsecsElapsed();
+        m_averageStepNs = m_averageStepNs <= 0.0
+            ? m_lastStepNs
+            : m_averageStepNs * 0.95 + m_lastStepNs * 0.05;
+
+        if (progress >= 1.0) {
+            m_timer.stop();
+            emit finished();
+        }
+    }
+};
+
+#endif // CROSSFADER_H
@@ -0,0 +1,223 @@
+#ifndef ENCODINGDETECTOR_H
+#define ENCODINGDETECTOR_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringDecoder>
+#include <QDebug>
+#include <QtAlgorithms>
+#include <cstring>
+#include <climits>
+
+#ifdef Q_OS_WIN
+#include <qt_windows.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENCODINGDETECTOR_SSE2
+#endif
+
+// 文本编码
+enum class TextEncoding
+{
+    Utf8,       // UTF-8（含纯 ASCII）
+    Utf16LE,
+    Utf16BE,
+    Gbk,        // GBK / GB2312（简体）
+    Big5        // Big5（繁体）
+};
+
+// 歌词文件编码检测
+// 顺序：BOM -> UTF-8 合法性校验（ASCII 段按 16 字节整块跳过）-> GBK / Big5 双字节统计
+// 绝大多数文件在第一步或第二步结束，只有非 UTF-8 文件才会进入统计
+class EncodingDetector
+{
+public:
+    // 检测编码，bomLength 返回需要跳过的 BOM 字节数
+    static TextEncoding detect(const char *data, qint64 size, int *bomLength = nullptr)
+    {
+        const uchar *p = reinterpret_cast<const uchar *>(data);
+        int bom = 0;
+        TextEncoding encoding = TextEncoding::Utf8;
+
+        if (size >= 3 && p[0] == 0xEF && p[1] == 0xBB && p[2] == 0xBF) {
+            bom = 3;
+        } else if (size >= 2 && p[0] == 0xFF && p[1] == 0xFE) {
+            bom = 2;
+            encoding = TextEncoding::Utf16LE;
+        } else if (size >= 2 && p[0] == 0xFE && p[1] == 0xFF) {
+            bom = 2;
+            encoding = TextEncoding::Utf16BE;
+        } else if (!isValidUtf8(p, size)) {
+            encoding = detectDoubleByte(p, size);
+        }
+
+        if (bomLength) *bomLength = bom;
+        return encoding;
+    }
+
+    static const char *name(TextEncoding encoding)
+    {
+        switch (encoding) {
+        case TextEncoding::Utf8: return "UTF-8";
+        case TextEncoding::Utf16LE: return "UTF-16LE";
+        case TextEncoding::Utf16BE: return "UTF-16BE";
+        case TextEncoding::Gbk: return "GBK";
+        case TextEncoding::Big5: return "Big5";
+        }
+        return "UTF-8";
+    }
+
+    // 转换为 UTF-8（data 不含 BOM），ok 返回是否能够解码
+    // GBK / Big5 优先用 Qt 的 ICU 支持，Windows 上没有 ICU 时用系统代码页转换；
+    // 两者都不可用时报告无法解码并返回空，不按系统编码硬转成乱码
+    static QByteArray toUtf8(const char *data, qint64 size, TextEncoding encoding, bool *ok = nullptr)
+    {
+        if (ok) *ok = true;
+        QStringDecoder decoder;
+        switch (encoding) {
+        case TextEncoding::Utf8:
+            return QByteArray(data, size);
+        case TextEncoding::Utf16LE:
+            decoder = QStringDecoder(QStringConverter::Utf16LE);
+            break;
+        case TextEncoding::Utf16BE:
+            decoder = QStringDecoder(QStringConverter::Utf16BE);
+            break;
+        case TextEncoding::Gbk:
+            decoder = QStringDecoder("GB18030");
+            break;
+        case TextEncoding::Big5:
+            decoder = QStringDecoder("Big5");
+            break;
+        }
+        if (decoder.isValid()) {
+            const QString text = decoder.decode(QByteArrayView(data, size));
+            return text.toUtf8();
+        }
+
+#ifdef Q_OS_WIN
+        QString text;
+        if (decodeCodePage(data, size, encoding == TextEncoding::Gbk ? 54936 : 950, text)) {
+            return text.toUtf8();
+        }
+#endif
+        qWarning() << "无法解码" << name(encoding) << "编码的文本（Qt 未启用 ICU）";
+        if (ok) *ok = false;
+        return QByteArray();
+    }
+
+private:
+#ifdef Q_OS_WIN
+    // 系统代码页转换（54936 为 GB18030，兼容 GBK；950 为 Big5），Windows 自带，不依赖 ICU
+    static bool decodeCodePage(const char *data, qint64 size, UINT codePage, QString &text)
+    {
+        if (size == 0) {
+            text.clear();
+            return true;
+        }
+        if (size > INT_MAX) return false;
+        const int length = MultiByteToWideChar(codePage, 0, data, int(size), nullptr, 0);
+        if (length <= 0) return false;
+        text.resize(length);
+        return MultiByteToWideChar(codePage, 0, data, int(size),
+                                   reinterpret_cast<wchar_t *>(text.data()), length) == length;
+    }
+#endif
+
+    // UTF-8 合法性校验：拒绝过长编码、代理区与超出 U+10FFFF 的码点
+    static bool isValidUtf8(const uchar *p, qint64 size)
+    {
+        const uchar *end = p + size;
+        while (p < end) {
+            p = skipAscii(p, end);
+            if (p >= end) break;
+
+            const uchar lead = *p;
+            int length;
+            uchar min = 0x80, max = 0xBF;   // 第二字节的合法范围
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                length = 2;
+            } else if (lead >= 0xE0 && lead <= 0xEF) {
+                length = 3;
+                if (lead == 0xE0) min = 0xA0;
+                else if (lead == 0xED) max = 0x9F;
+            } else if (lead >= 0xF0 && lead <= 0xF4) {
+                length = 4;
+                if (lead == 0xF0) min = 0x90;
+                else if (lead == 0xF4) max = 0x8F;
+            } else {
+                return false;
+            }
+
+            if (end - p < length) return false;
+            if (p[1] < min || p[1] > max) return false;
+            for (int i = 2; i < length; ++i) {
+                if ((p[i] & 0xC0) != 0x80) return false;
+            }
+            p += length;
+        }
+        return true;
+    }
+
+    // 跳过连续的 ASCII 字节，返回第一个非 ASCII 字节的位置
+    static const uchar *skipAscii(const uchar *p, const uchar *end)
+    {
+#ifdef ENCODINGDETECTOR_SSE2
+        while (end - p >= 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            const int mask = _mm_movemask_epi8(chunk);   // 每字节最高位
+            if (mask != 0) {
+                return p + qCountTrailingZeroBits(static_cast<quint32>(mask));
+            }
+            p += 16;
+        }
+#else
+        while (end - p >= 8) {
+            quint64 chunk;
+            std::memcpy(&chunk, p, 8);
+            if (chunk & Q_UINT64_C(0x8080808080808080)) break;
+            p += 8;
+        }
+#endif
+        while (p < end && *p < 0x80) ++p;
+        return p;
+    }
+
+    // 双字节编码统计
+    // GB2312 汉字的尾字节都在 0xA1~0xFE；Big5 约四成汉字的尾字节落在 0x40~0x7E，
+    // 而 GBK 在该区间只有扩展区的生僻字。两者都合法时按低位尾字节的比例判定
+    static TextEncoding detectDoubleByte(const uchar *p, qint64 size)
+    {
+        qint64 pairs = 0;
+        qint64 lowTrail = 0;        // 尾字节 0x40~0x7E
+        bool gbkValid = true;
+        bool big5Valid = true;
+
+        const uchar *end = p + size;
+        while (p < end) {
+            p = skipAscii(p, end);
+            if (p >= end) break;
+            const uchar lead = *p;
+            if (lead == 0x80 || lead == 0xFF || end - p < 2) {
+                gbkValid = big5Valid = false;
+                break;
+            }
+            const uchar trail = p[1];
+            p += 2;
+            ++pairs;
+
+            if (trail < 0x40 || trail == 0x7F || trail == 0xFF) gbkValid = false;
+            if (trail < 0x40 || (trail > 0x7E && trail < 0xA1) || trail == 0xFF) big5Valid = false;
+            if (trail <= 0x7E) ++lowTrail;
+        }
+
+        if (gbkValid != big5Valid) {
+            return gbkValid ? TextEncoding::Gbk : TextEncoding::Big5;
+        }
+        return lowTrail * 10 > pairs ? TextEncoding::Big5 : TextEncoding::Gbk;
+    }
+};
+
+#endif // ENCODINGDETECTOR_H
@@ -0,0 +1,470 @@
+#ifndef LOUDNESSSCANNER_H
+#define LOUDNESSSCANNER_H
+
+#include <QObject>
+#include <QThread>
+#include <QThreadPool>
+#include <QEventLoop>
+#include <QAudioDecoder>
+#include <QAudioBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QUrl>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include "pcmconverter.h"
+
+// 响度分析结果
+struct LoudnessResult
+{
+    double integratedLufs;      // 积分响度（LUFS）
+    double truePeakDb;          // 真峰值（dBTP）
+
+    LoudnessResult(double lufs = 0.0, double peak = 0.0)
+        : integratedLufs(lufs), truePeakDb(peak) {}
+
+    // ReplayGain 2.0 增益（参考响度 -18 LUFS），并保证真峰值不超过 -1 dBTP
+    double replayGainDb() const
+    {
+        double gain = -18.0 - integratedLufs;
+        return qMin(gain, -1.0 - truePeakDb);
+    }
+};
+
+// EBU R128 / ITU-R BS.1770-4 响度计
+// K 加权（高架 + 高通两级双二阶）-> 100ms 分段均方 -> 400ms 门限块（75% 重叠）
+// -> 绝对门限 -70 LUFS + 相对门限 -10 LU；真峰值使用 4 倍过采样多相 FIR
+class LoudnessMeter
+{
+private:
+    static const int MAX_CHANNELS = 8;
+    static const int OVERSAMPLE = 4;            // 真峰值过采样倍数
+    static const int TAPS_PER_PHASE = 12;       // 每相 FIR 阶数
+
+    int m_channels;
+    int m_stepFrames;                           // 100ms 对应的帧数
+
+    // K 加权滤波器系数与状态（直接 II 型转置），状态按声道并排存放（见 kWeightFrame）
+    double m_b[2][3];
+    double m_a[2][3];
+    double m_z1[2][MAX_CHANNELS];
+    double m_z2[2][MAX_CHANNELS];
+    double m_weight[MAX_CHANNELS];              // 声道加权（环绕声道 1.41，LFE 0）
+
+    double m_stepSquares[MAX_CHANNELS];         // 当前 100ms 分段的平方和
+    int m_stepFill;                             // 当前分段已累计帧数
+    double m_recentSteps[4];                    // 最近 4 个分段的加权均方
+    int m_stepCount;                            // 已完成的分段数
+    QVector<double> m_blockEnergies;            // 每个 400ms 块的加权均方
+
+    // 真峰值
+    float m_fir[OVERSAMPLE][TAPS_PER_PHASE];
+    float m_history[MAX_CHANNELS][2 * TAPS_PER_PHASE];   // 双份存放，免去取模
+    int m_historyPos;
+    float m_truePeak;
+
+public:
+    LoudnessMeter(int sampleRate, int channels)
+        : m_channels(qBound(1, channels, static_cast<int>(MAX_CHANNELS)))
+        , m_stepFrames(qMax(1, sampleRate / 10))
+        , m_stepFill(0)
+        , m_stepCount(0)
+        , m_historyPos(0)
+        , m_truePeak(0.0f)
+    {
+        // 第一级：高架滤波器（模拟头部声学效应）
+        {
+            const double f0 = 1681.974450955533;
+            const double G = 3.999843853973347;
+            const double Q = 0.7071752369554196;
+            const double K = std::tan(M_PI * f0 / sampleRate);
+            const double Vh = std::pow(10.0, G / 20.0);
+            const double Vb = std::pow(Vh, 0.4996667741545416);
+            const double a0 = 1.0 + K / Q + K * K;
+            m_b[0][0] = (Vh + Vb * K / Q + K * K) / a0;
+            m_b[0][1] = 2.0 * (K * K - Vh) / a0;
+            m_b[0][2] = (Vh - Vb * K / Q + K * K) / a0;
+            m_a[0][0] = 1.0;
+            m_a[0][1] = 2.0 * (K * K - 1.0) / a0;
+            m_a[0][2] = (1.0 - K / Q + K * K) / a0;
+        }
+        // 第二级：RLB 高通滤波器
+        {
+            const double f0 = 38.13547087602444;
+            const double Q = 0.5003270373238773;
+            const double K = std::tan(M_PI * f0 / sampleRate);
+            const double a0 = 1.0 + K / Q + K * K;
+            m_b[1][0] = 1.0;
+            m_b[1][1] = -2.0;
+            m_b[1][2] = 1.0;
+            m_a[1][0] = 1.0;
+            m_a[1][1] = 2.0 * (K * K - 1.0) / a0;
+            m_a[1][2] = (1.0 - K / Q + K * K) / a0;
+        }
+
+        for (int c = 0; c < MAX_CHANNELS; ++c) {
+            m_z1[0][c] = m_z2[0][c] = m_z1[1][c] = m_z2[1][c] = 0.0;
+            m_stepSquares[c] = 0.0;
+            // 5.1 布局：L R C LFE Ls Rs
+            m_weight[c] = 1.0;
+            if (m_channels >= 6) {
+                if (c == 3) m_weight[c] = 0.0;
+                if (c == 4 || c == 5) m_weight[c] = 1.41;
+            }
+            for (int t = 0; t < 2 * TAPS_PER_PHASE; ++t) m_history[c][t] = 0.0f;
+        }
+        for (double &step : m_recentSteps) step = 0.0;
+
+        // 4 倍过采样插值滤波器：Hann 窗 sinc，按相位拆分
+        const int length = OVERSAMPLE * TAPS_PER_PHASE;
+        const double center = (length - 1) / 2.0;
+        for (int n = 0; n < length; ++n) {
+            const double x = (n - center) / OVERSAMPLE;
+            const double sinc = (x == 0.0) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            const double window = 0.5 - 0.5 * std::cos(2.0 * M_PI * (n + 0.5) / length);
+            m_fir[n % OVERSAMPLE][n / OVERSAMPLE] = static_cast<float>(sinc * window);
+        }
+    }
+
+    // 输入交错浮点样本
+    void process(const float *samples, int frames)
+    {
+        switch (m_channels) {
+        case 1: processFrames<1>(samples, frames); break;
+        case 2: processFrames<2>(samples, frames); break;
+        default: processFramesGeneric(samples, frames); break;
+        }
+    }
+
+    // 计算最终结果；不足一个门限块时返回 false
+    bool finish(LoudnessResult &result) const
+    {
+        if (m_blockEnergies.isEmpty()) return false;
+
+        // 绝对门限 -70 LUFS
+        const double absoluteGate = energyFromLufs(-70.0);
+        double sum = 0.0;
+        int count = 0;
+        for (double e : m_blockEnergies) {
+            if (e > absoluteGate) { sum += e; ++count; }
+        }
+        if (count == 0) {
+            result = LoudnessResult(-70.0, linearToDb(m_truePeak));
+            return true;
+        }
+
+        // 相对门限：绝对门限后平均响度 -10 LU
+        const double relativeGate = sum / count * std::pow(10.0, -10.0 / 10.0);
+        double gatedSum = 0.0;
+        int gatedCount = 0;
+        for (double e : m_blockEnergies) {
+            if (e > absoluteGate && e > relativeGate) { gatedSum += e; ++gatedCount; }
+        }
+
+        result = LoudnessResult(lufsFromEnergy(gatedSum / qMax(1, gatedCount)),
+                                linearToDb(m_truePeak));
+        return true;
+    }
+
+private:
+    static double lufsFromEnergy(double energy) { return -0.691 + 10.0 * std::log10(energy + 1e-20); }
+    static double energyFromLufs(double lufs) { return std::pow(10.0, (lufs + 0.691) / 10.0); }
+    static double linearToDb(float value) { return 20.0 * std::log10(qMax(value, 1e-9f)); }
+
+    // 声道数为编译期常量时 kWeightFrame 的声道循环完全展开，立体声两路 double 合为一条 SIMD 运算
+    template <int Channels>
+    void processFrames(const float *samples, int frames)
+    {
+        for (int f = 0; f < frames; ++f) {
+            const float *frame = samples + f * Channels;
+            kWeightFrame(frame, Channels);
+            truePeakFrame(frame, Channels);
+            advanceStep();
+        }
+    }
+
+    void processFramesGeneric(const float *samples, int frames)
+    {
+        for (int f = 0; f < frames; ++f) {
+            const float *frame = samples + f * m_channels;
+            kWeightFrame(frame, m_channels);
+            truePeakFrame(frame, m_channels);
+            advanceStep();
+        }
+    }
+
+    // 一帧的两级双二阶串联并累计平方：双二阶在时间上有递推依赖，但各声道之间相互独立，
+    // 因此每一级都对所有声道同时计算（系数广播、状态按声道连续），而不是逐声道走完两级
+    inline void kWeightFrame(const float *frame, int channels)
+    {
+        double x[MAX_CHANNELS];
+        for (int c = 0; c < channels; ++c) x[c] = frame[c];
+        for (int s = 0; s < 2; ++s) {
+            const double b0 = m_b[s][0], b1 = m_b[s][1], b2 = m_b[s][2];
+            const double a1 = m_a[s][1], a2 = m_a[s][2];
+            double *z1 = m_z1[s];
+            double *z2 = m_z2[s];
+            for (int c = 0; c < channels; ++c) {
+                const double y = b0 * x[c] + z1[c];
+                z1[c] = b1 * x[c] - a1 * y + z2[c];
+                z2[c] = b2 * x[c] - a2 * y;
+                x[c] = y;
+            }
+        }
+        for (int c = 0; c < channels; ++c) m_stepSquares[c] += x[c] * x[c];
+    }
+
+    // 4 倍过采样后取绝对值最大（含原始采样点）
+    inline void truePeakFrame(const float *frame, int channels)
+    {
+        m_historyPos = (m_historyPos + TAPS_PER_PHASE - 1) % TAPS_PER_PHASE;
+        for (int c = 0; c < channels; ++c) {
+            float *history = m_history[c];
+            history[m_historyPos] = history[m_historyPos + TAPS_PER_PHASE] = frame[c];
+            const float *window = history + m_historyPos;
+            for (int p = 0; p < OVERSAMPLE; ++p) {
+                float acc = 0.0f;
+                for (int t = 0; t < TAPS_PER_PHASE; ++t) {
+                    acc += m_fir[p][t] * window[t];
+                }
+                m_truePeak = qMax(m_truePeak, std::fabs(acc));
+            }
+            m_truePeak = qMax(m_truePeak, std::fabs(frame[c]));
+        }
+    }
+
+    // 每满 100ms 结束一个分段，每个分段结束一个 400ms 门限块
+    inline void advanceStep()
+    {
+        if (++m_stepFill < m_stepFrames) return;
+
+        double energy = 0.0;
+        for (int c = 0; c < m_channels; ++c) {
+            energy += m_weight[c] * m_stepSquares[c] / m_stepFrames;
+            m_stepSquares[c] = 0.0;
+        }
+        m_stepFill = 0;
+
+        m_recentSteps[m_stepCount % 4] = energy;
+        ++m_stepCount;
+        if (m_stepCount >= 4) {
+            m_blockEnergies.append((m_recentSteps[0] + m_recentSteps[1]
+                                    + m_recentSteps[2] + m_recentSteps[3]) / 4.0);
+        }
+    }
+};
+
+// 播放列表响度扫描器
+// 在与 CPU 核数相同的线程池中并行解码分析，结果按 路径+修改时间+大小 缓存到磁盘
+// 缓存条目数有上限，超出时淘汰最久未使用的条目
+class LoudnessScanner : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int MAX_CACHE_ENTRIES = 20000;
+
+    struct CacheEntry
+    {
+        LoudnessResult result;
+        qint64 lastUsed = 0;    // 最近使用时间（毫秒，UTC）；只在写回时一并保存，命中不触发写盘
+    };
+
+    QThreadPool m_pool;                         // 分析线程池
+    QHash<QString, CacheEntry> m_cache;         // 键 -> 结果
+    QSet<QString> m_pending;                    // 正在分析的键
+    QString m_cacheFilePath;                    // 缓存文件
+    bool m_dirty;                               // 缓存是否需要写回
+
+public:
+    explicit LoudnessScanner(QObject *parent = nullptr)
+        : QObject(parent)
+        , m_dirty(false)
+    {
+        m_pool.setMaxThreadCount(QThread::idealThreadCount());
+
+        QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        QDir().mkpath(cachePath);
+        m_cacheFilePath = cachePath + "/loudness.json";
+        loadCache();
+    }
+
+    ~LoudnessScanner()
+    {
+        m_pool.clear();
+        m_pool.waitForDone();
+        saveCache();
+    }
+
+    // 缓存键：路径 + 修改时间 + 大小
+    static QString cacheKey(const QString &filePath)
+    {
+        QFileInfo info(filePath);
+        return QString("%1|%2|%3").arg(info.absoluteFilePath())
+                                  .arg(info.lastModified().toMSecsSinceEpoch())
+                                  .arg(info.size());
+    }
+
+    // 查询已缓存的结果
+    bool lookup(const QString &filePath, LoudnessResult &result)
+    {
+        auto it = m_cache.find(cacheKey(filePath));
+        if (it == m_cache.end()) return false;
+        it->lastUsed = QDateTime::currentMSecsSinceEpoch();
+        result = it->result;
+        return true;
+    }
+
+    // 扫描一批本地文件，已缓存或正在分析的跳过
+    void scan(const QStringList &filePaths)
+    {
+        for (const QString &path : filePaths) {
+            const QString key = cacheKey(path);
+            if (m_cache.contains(key) || m_pending.contains(key)) continue;
+            m_pending.insert(key);
+
+            m_pool.start([this, path, key]() {
+                LoudnessResult result;
+                bool ok = analyzeFile(path, result);
+                QMetaObject::invokeMethod(this, [this, path, key, ok, result]() {
+                    onAnalyzed(path, key, ok, result);
+                }, Qt::QueuedConnection);
+            });
+        }
+    }
+
+    // 待分析的文件数
+    int pendingCount() const { return m_pending.size(); }
+
+signals:
+    void loudnessReady(const QString &filePath, const LoudnessResult &result);
+
+private:
+    void onAnalyzed(const QString &path, const QString &key, bool ok, const LoudnessResult &result)
+    {
+        m_pending.remove(key);
+        if (!ok) return;
+
+        CacheEntry entry;
+        entry.result = result;
+        entry.lastUsed = QDateTime::currentMSecsSinceEpoch();
+        m_cache.insert(key, entry);
+        m_dirty = true;
+        qDebug() << "响度分析完成:" << QFileInfo(path).fileName()
+                 << result.integratedLufs << "LUFS" << result.truePeakDb << "dBTP";
+        emit loudnessReady(path, result);
+
+        // 一批扫描结束后写回缓存
+        if (m_pending.isEmpty()) {
+            saveCache();
+        }
+    }
+
+    // 在线程池线程中同步解码整首文件（局部事件循环驱动 QAudioDecoder）
+    static bool analyzeFile(const QString &path, LoudnessResult &result)
+    {
+        QAudioDecoder decoder;
+        QEventLoop loop;
+        QScopedPointer<LoudnessMeter> meter;
+        QVector<float> scratch;
+        bool failed = false;
+
+        QObject::connect(&decoder, &QAudioDecoder::bufferReady, [&]() {
+            while (decoder.bufferAvailable()) {
+                QAudioBuffer buffer = decoder.read();
+                if (!buffer.isValid()) continue;
+                const QAudioFormat format = buffer.format();
+                if (!meter) {
+                    meter.reset(new LoudnessMeter(format.sampleRate(), format.channelCount()));
+                }
+                const int frames = static_cast<int>(buffer.frameCount());
+                scratch.resize(frames * format.channelCount());
+                if (PcmConverter::toFloat(buffer, 0, frames, scratch.data())) {
+                    meter->process(scratch.constData(), frames);
+                }
+            }
+        });
+        QObject::connect(&decoder, &QAudioDecoder::finished, &loop, &QEventLoop::quit);
+        QObject::connect(&decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error),
+                         [&](QAudioDecoder::Error) {
+            failed = true;
+            loop.quit();
+        });
+
+        decoder.setSource(QUrl::fromLocalFile(path));
+        decoder.start();
+        loop.exec();
+
+        return !failed && meter && meter->finish(result);
+    }
+
+    void loadCache()
+    {
+        QFile file(m_cacheFilePath);
+        if (!file.open(QIODevice::ReadOnly)) return;
+
+        QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+        for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+            QJsonObject obj = it.value().toObject();
+            CacheEntry entry;
+            entry.result = LoudnessResult(obj["lufs"].toDouble(), obj["peak"].toDouble());
+            entry.lastUsed = static_cast<qint64>(obj["used"].toDouble());
+            m_cache.insert(it.key(), entry);
+        }
+    }
+
+    // 超出上限时按最近使用时间淘汰
+    void trimCache()
+    {
+        if (m_cache.size() <= MAX_CACHE_ENTRIES) return;
+
+        QVector<QPair<qint64, QString>> order;
+        order.reserve(m_cache.size());
+        for (auto it = m_cache.constBegin(); it != m_cache.constEnd(); ++it) {
+            order.append(qMakePair(it->lastUsed, it.key()));
+        }
+        std::sort(order.begin(), order.end());
+        const int excess = m_cache.size() - MAX_CACHE_ENTRIES;
+        for (int i = 0; i < excess; ++i) {
+            m_cache.remove(order[i].second);
+        }
+    }
+
+    // 原子写入，写到一半崩溃也不会留下损坏的缓存
+    void saveCache()
+    {
+        if (!m_dirty) return;
+        trimCache();
+
+        QJsonObject root;
+        for (auto it = m_cache.constBegin(); it != m_cache.constEnd(); ++it) {
+            QJsonObject obj;
+            obj["lufs"] = it->result.integratedLufs;
+            obj["peak"] = it->result.truePeakDb;
+            obj["used"] = static_cast<double>(it->lastUsed);
+            root[it.key()] = obj;
+        }
+
+        QSaveFile file(m_cacheFilePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qDebug() << "无法写入响度缓存:" << m_cacheFilePath;
+            return;
+        }
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        if (file.commit()) {
+            m_dirty = false;
+        }
+    }
+};
+
+#endif // LOUDNESSSCANNER_H
@@ -0,0 +1,195 @@
+#ifndef LYRICCACHE_H
+#define LYRICCACHE_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QtEndian>
+#include <QDebug>
+#include <QAtomicInt>
+#include "lyricwidget.h"
+#include "cachedirectory.h"
+#include "binaryformat.h"
+
+// 已解析歌词的二进制缓存
+// 缓存文件格式（小端）：
+//   "QMLC" | quint32 版本 | quint32 行数 | quint32 逐字数 | quint32 字符池长度（UTF-16 单元）| quint32 保留
+//   | 行表[行数]：qint64 时间戳 | quint32 文本偏移 | quint32 文本长度 | quint32 首个逐字 | quint32 逐字数
+//   | 逐字表[逐字数]：qint64 时间戳 | quint32 起始 | quint32 长度
+//   | 字符池：所有行文本的 UTF-16 拼接
+// 加载时内存映射缓存文件，只按偏移拷出字符串，不经过文本解析器
+// 命中时刷新修改时间，写入新文件后按最久未使用淘汰，目录大小有上限
+class LyricCache
+{
+private:
+    static const quint32 VERSION = 4;   // 2：按检测到的编码解析；3：时间戳已应用 [offset:]；4：重复标签的逐字时间已平移
+    static const int HEADER_SIZE = 24;
+    static const int LINE_SIZE = 24;
+    static const int WORD_SIZE = 16;
+
+    // 缓存上限
+    static constexpr qint64 MAX_CACHE_BYTES = 64LL * 1024 * 1024;        // 普通歌词每首约 5KB
+    static const int MAX_CACHE_FILES = 20000;
+    static constexpr qint64 MAX_CACHE_AGE_MS = 90LL * 24 * 3600 * 1000;  // 90 天未使用即删除
+    static const int TRIM_INTERVAL = 1000;  // 每写入这么多个文件清理一次（启动后第一次写入也清理）；
+                                            // 清理要 stat 整个目录，建索引时会连续写入上万个文件
+
+    // 写入计数（加载与写入可能来自线程池中的多个线程）
+    static QAtomicInt &saveCounter()
+    {
+        static QAtomicInt counter;
+        return counter;
+    }
+
+public:
+    static QString cacheDir()
+    {
+        return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/lyrics";
+    }
+
+    // 缓存文件路径：缓存目录下，以 歌词路径+修改时间+大小 的哈希命名
+    static QString cachePath(const QString &lrcPath)
+    {
+        QFileInfo info(lrcPath);
+        QByteArray key = info.absoluteFilePath().toUtf8()
+                         + '|' + QByteArray::number(info.lastModified().toMSecsSinceEpoch())
+                         + '|' + QByteArray::number(info.size());
+        return cacheDir() + "/" + QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex() + ".lyc";
+    }
+
+    // 读取缓存文件，不存在或格式不符时返回 false
+    static bool load(const QString &path, QList<LyricLine> &lyrics)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly) || file.size() < HEADER_SIZE) {
+            return false;
+        }
+
+        const uchar *base = file.map(0, file.size());
+        if (!BinaryFormat::checkHeader(base, file.size(), "QMLC", VERSION, HEADER_SIZE)) {
+            return false;
+        }
+
+        const quint32 lineCount = BinaryFormat::headerField(base, 0);
+        const quint32 wordCount = BinaryFormat::headerField(base, 1);
+        const quint32 poolSize = BinaryFormat::headerField(base, 2);
+        const qint64 expected = HEADER_SIZE + qint64(lineCount) * LINE_SIZE
+                                + qint64(wordCount) * WORD_SIZE + qint64(poolSize) * 2;
+        if (file.size() != expected) {
+            return false;
+        }
+
+        const uchar *lineTable = base + HEADER_SIZE;
+        const uchar *wordTable = lineTable + qint64(lineCount) * LINE_SIZE;
+        const uchar *pool = wordTable + qint64(wordCount) * WORD_SIZE;
+
+        QList<LyricLine> result;
+        result.reserve(lineCount);
+        for (quint32 i = 0; i < lineCount; ++i) {
+            const uchar *entry = lineTable + qint64(i) * LINE_SIZE;
+            const quint32 textOffset = qFromLittleEndian<quint32>(entry + 8);
+            const quint32 textLength = qFromLittleEndian<quint32>(entry + 12);
+            const quint32 firstWord = qFromLittleEndian<quint32>(entry + 16);
+            const quint32 lineWords = qFromLittleEndian<quint32>(entry + 20);
+            if (quint64(textOffset) + textLength > poolSize
+                || quint64(firstWord) + lineWords > wordCount) {
+                return false;
+            }
+
+            const uchar *text = pool + qint64(textOffset) * 2;
+            result.append(LyricLine(qFromLittleEndian<qint64>(entry), BinaryFormat::readUtf16(text, textLength)));
+
+            QVector<LyricWord> &words = result.last().words;
+            words.reserve(lineWords);
+            for (quint32 w = 0; w < lineWords; ++w) {
+                const uchar *word = wordTable + qint64(firstWord + w) * WORD_SIZE;
+                words.append(LyricWord{qFromLittleEndian<qint64>(word),
+                                       static_cast<int>(qFromLittleEndian<quint32>(word + 8)),
+                                       static_cast<int>(qFromLittleEndian<quint32>(word + 12))});
+            }
+        }
+
+        lyrics = result;
+        file.close();
+        CacheDirectory::touch(path);
+        return true;
+    }
+
+    // 超出上限时淘汰最久未使用的缓存文件
+    static void trimCache()
+    {
+        CacheDirectory::trim(cacheDir(), "*.lyc", MAX_CACHE_BYTES, MAX_CACHE_FILES, MAX_CACHE_AGE_MS);
+    }
+
+    // 原子写入缓存文件；相同文本（副歌、一行多个时间标签）在字符池中只存一份
+    static bool save(const QString &path, const QList<LyricLine> &lyrics)
+    {
+        QByteArray lineTable;
+        QByteArray wordTable;
+        QByteArray pool;
+        lineTable.reserve(lyrics.size() * LINE_SIZE);
+
+        quint32 poolSize = 0;
+        quint32 wordCount = 0;
+        QHash<QString, quint32> offsets;    // 文本 -> 字符池偏移
+        for (const LyricLine &line : lyrics) {
+            auto it = offsets.constFind(line.text);
+            if (it == offsets.constEnd()) {
+                it = offsets.insert(line.text, poolSize);
+                BinaryFormat::appendUtf16(pool, line.text);
+                poolSize += static_cast<quint32>(line.text.size());
+            }
+            const quint32 offset = it.value();
+
+            uchar entry[LINE_SIZE];
+            qToLittleEndian<qint64>(line.timestamp, entry);
+            qToLittleEndian<quint32>(offset, entry + 8);
+            qToLittleEndian<quint32>(static_cast<quint32>(line.text.size()), entry + 12);
+            qToLittleEndian<quint32>(wordCount, entry + 16);
+            qToLittleEndian<quint32>(static_cast<quint32>(line.words.size()), entry + 20);
+            lineTable.append(reinterpret_cast<const char *>(entry), LINE_SIZE);
+
+            for (const LyricWord &word : line.words) {
+                uchar bytes[WORD_SIZE];
+                qToLittleEndian<qint64>(word.timestamp, bytes);
+                qToLittleEndian<quint32>(static_cast<quint32>(word.start), bytes + 8);
+                qToLittleEndian<quint32>(static_cast<quint32>(word.length), bytes + 12);
+                wordTable.append(reinterpret_cast<const char *>(bytes), WORD_SIZE);
+                ++wordCount;
+            }
+        }
+
+        QDir().mkpath(QFileInfo(path).absolutePath());
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qDebug() << "无法写入歌词缓存:" << path;
+            return false;
+        }
+
+        file.write(BinaryFormat::header("QMLC", VERSION, HEADER_SIZE,
+                                        {static_cast<quint32>(lyrics.size()), wordCount, poolSize}));
+        file.write(lineTable);
+        file.write(wordTable);
+        file.write(pool);
+        if (!file.commit()) {
+            return false;
+        }
+
+        // 只有取到整数倍计数的那个线程清理，避免每次写入都列目录
+        if (saveCounter().fetchAndAddRelaxed(1) % TRIM_INTERVAL == 0) {
+            trimCache();
+        }
+        return true;
+    }
+};
+
+#endif // LYRICCACHE_H
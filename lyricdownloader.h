@@ -5,42 +5,125 @@
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
 #include <QFile>
 #include <QFileInfo>
 #include <QTextStream>
-#include <QUrlQuery>
 #include <QDebug>
-#include <QEventLoop>
-#include <QTimer>
+#include <QHash>
+#include <QElapsedTimer>
+#include <functional>
+#include <algorithm>
 #include "lyricwidget.h"
+#include "lyricresponsecache.h"
+#include "lyricprovider.h"
 
 // 在线歌词下载器
+// 全部请求异步完成（不开嵌套事件循环），每次下载是一个任务，可随时取消。
+// 歌词来源可配置多个（见 createLyricProviders）：按各来源响应时间直方图排序，同时询问最快的几个，
+// 取第一个有歌词的结果并中止其余；某个来源失败时再补上排在后面的来源
 class LyricDownloader : public QObject
 {
     Q_OBJECT
     
+public:
+    // 下载完成回调：成功时 lyricText 非空，失败时 error 为原因；
+    // definitive 表示结果是明确答复（有歌词或确认没有，含缓存命中），网络错误、超时、熔断拒绝为 false，稍后可以重试
+    using FetchCallback = std::function<void(const QString& lyricText, const QString& error, bool definitive)>;
+    
 private:
+    static const int RACE_WIDTH = 2;        // 同时询问的来源数
+    static const int MIN_SAMPLES = 3;       // 样本不足的来源优先尝试（先摸清它的速度）
+    
+    // 一个下载任务
+    struct Task
+    {
+        QString title;
+        QString artist;
+        QString audioPath;                  // 对应的本地音频（用于进度通知，可为空）
+        QString cacheKey;                   // 查询缓存键
+        QList<LyricProvider*> pending;      // 尚未询问的来源（已排序）
+        QHash<LyricFetch*, LyricProvider*> running; // 进行中的查询
+        QHash<LyricFetch*, qint64> startedAt;       // 各查询的发起时刻
+        bool allDefinitive = true;          // 所有来源都明确答复"没有"（才写入负缓存）
+        FetchCallback callback;
+    };
+    
     QNetworkAccessManager* m_networkManager;
+    LyricResponseCache* m_cache;            // 查询结果缓存（含"未找到"）
+    QList<LyricProvider*> m_providers;      // 歌词来源
+    QList<LyricProvider*> m_retiredProviders; // 已被替换、仍有任务在用的来源（任务结束后释放）
+    QHash<quint64, Task> m_tasks;           // 进行中的任务
+    quint64 m_lastTaskId = 0;
     QString m_lastError;
+    QElapsedTimer m_clock;
+    
+    // 统计
+    qint64 m_requests = 0;
+    qint64 m_succeeded = 0;
+    qint64 m_failed = 0;
+    qint64 m_cancelled = 0;
     
 public:
+    // 来源配置取自环境变量 QTMEDIAPLAYER_LYRIC_PROVIDERS（格式见 createLyricProviders），未设置时使用默认接口
     explicit LyricDownloader(QObject* parent = nullptr)
         : QObject(parent)
     {
         m_networkManager = new QNetworkAccessManager(this);
+        m_cache = new LyricResponseCache(this);
+        m_clock.start();
+        setProviders(createLyricProviders(qEnvironmentVariable("QTMEDIAPLAYER_LYRIC_PROVIDERS"),
+                                          m_networkManager, this));
     }
     
     ~LyricDownloader()
     {
+        // 先中止所有查询，之后不再回调
+        cancelAll();
         delete m_networkManager;
     }
     
+    // 查询结果缓存（命中统计、清空）
+    LyricResponseCache* cache() const { return m_cache; }
+    
     // 获取最后的错误信息
     QString lastError() const { return m_lastError; }
     
+    // 替换歌词来源（按配置串创建，或传入自定义实现）；进行中的任务不受影响
+    // 被替换下来的自有来源在没有任务引用后释放
+    void setProviders(const QList<LyricProvider*>& providers)
+    {
+        for (LyricProvider* provider : std::as_const(m_providers)) {
+            if (!providers.contains(provider) && provider->parent() == this) m_retiredProviders.append(provider);
+        }
+        m_providers = providers;
+        for (LyricProvider* provider : providers) {
+            if (!provider->parent()) provider->setParent(this);
+            m_retiredProviders.removeAll(provider);
+        }
+        releaseRetiredProviders();
+    }
+    void configureProviders(const QString& spec)
+    {
+        setProviders(createLyricProviders(spec, m_networkManager, this));
+    }
+    QList<LyricProvider*> providers() const { return m_providers; }
+    
+    // 按响应时间排序的来源：样本不足的在前，其余按中位数、再按 90 分位升序
+    QList<LyricProvider*> rankedProviders() const
+    {
+        QList<LyricProvider*> ranked = m_providers;
+        std::stable_sort(ranked.begin(), ranked.end(), [](LyricProvider* a, LyricProvider* b) {
+            const LatencyHistogram& ha = a->latency();
+            const LatencyHistogram& hb = b->latency();
+            const bool newA = ha.sampleCount() < MIN_SAMPLES;
+            const bool newB = hb.sampleCount() < MIN_SAMPLES;
+            if (newA != newB) return newA;
+            if (ha.quantile(0.5) != hb.quantile(0.5)) return ha.quantile(0.5) < hb.quantile(0.5);
+            return ha.quantile(0.9) < hb.quantile(0.9);
+        });
+        return ranked;
+    }
+    
     // 从文件名提取歌曲信息
     struct SongInfo {
         QString title;      // 歌曲名
@@ -76,12 +159,10 @@ public:
         return SongInfo(baseName, "");
     }
     
-    // 搜索歌词（网易云音乐 API）
-    // 注意：这是一个简化的实现，实际使用时可能需要处理更多细节
-    QString searchAndDownloadLyric(const QString& songName, const QString& artistName = "")
+    // 搜索并下载歌词，完成时调用 callback(歌词文本, 错误信息, 是否明确答复)，返回任务号
+    // 先查缓存，命中（包括"未找到"）时不联网，回调同样异步进行；任务被取消时不再回调
+    quint64 fetchLyric(const QString& songName, const QString& artistName, const FetchCallback& callback)
     {
-        m_lastError.clear();
-        
         // 构建搜索关键词
         QString keyword = songName;
         if (!artistName.isEmpty()) {
@@ -90,130 +171,63 @@ public:
         
         qDebug() << "搜索歌词:" << keyword;
         
-        // 使用网易云音乐 API（第三方接口）
-        // 注意：这里使用的是公开的第三方 API，实际使用时请确保合法性
-        QString searchUrl = QString("https://netease-cloud-music-api-psi-drab.vercel.app/search?keywords=%1&limit=1")
-                           .arg(QString(keyword.toUtf8().toPercentEncoding()));
-        
-        QNetworkRequest request;
-        request.setUrl(QUrl(searchUrl));
-        request.setHeader(QNetworkRequest::UserAgentHeader, "QtMediaPlayer/1.0");
-        
-        QNetworkReply* reply = m_networkManager->get(request);
-        
-        // 等待响应
-        QEventLoop loop;
-        QTimer timer;
-        timer.setSingleShot(true);
-        
-        connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-        connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
-        
-        timer.start(10000); // 10秒超时
-        loop.exec();
-        
-        if (!timer.isActive()) {
-            m_lastError = "请求超时";
-            reply->deleteLater();
-            return QString();
+        const quint64 id = ++m_lastTaskId;
+        Task task;
+        task.title = songName;
+        task.artist = artistName;
+        task.cacheKey = LyricResponseCache::makeKey(songName, artistName);
+        task.callback = callback;
+        
+        QString cachedText;
+        const LyricResponseCache::Lookup cached = m_cache->lookup(task.cacheKey, cachedText);
+        if (cached != LyricResponseCache::Lookup::Miss) {
+            qDebug() << "歌词查询命中缓存:" << keyword << (cached == LyricResponseCache::Lookup::Found ? "有歌词" : "未找到");
+            const QString error = cached == LyricResponseCache::Lookup::Found ? QString() : QString("未找到歌曲（缓存）");
+            m_tasks.insert(id, task);
+            QMetaObject::invokeMethod(this, [this, id, cachedText, error]() {
+                if (m_tasks.contains(id)) finish(id, cachedText, error, true, false);
+            }, Qt::QueuedConnection);
+            return id;
         }
-        timer.stop();
         
-        if (reply->error() != QNetworkReply::NoError) {
-            m_lastError = "网络错误: " + reply->errorString();
-            qDebug() << m_lastError;
-            reply->deleteLater();
-            return QString();
+        task.pending = rankedProviders();
+        m_tasks.insert(id, task);
+        for (int i = 0; i < RACE_WIDTH; ++i) {
+            if (!launchNext(id)) break;
         }
-        
-        QByteArray data = reply->readAll();
-        reply->deleteLater();
-        
-        // 解析搜索结果
-        QJsonDocument doc = QJsonDocument::fromJson(data);
-        if (doc.isNull() || !doc.isObject()) {
-            m_lastError = "解析搜索结果失败";
-            return QString();
+        if (m_tasks[id].running.isEmpty()) {
+            QMetaObject::invokeMethod(this, [this, id]() {
+                if (m_tasks.contains(id)) finish(id, QString(), "没有可用的歌词来源", false);
+            }, Qt::QueuedConnection);
         }
-        
-        QJsonObject obj = doc.object();
-        QJsonObject result = obj["result"].toObject();
-        QJsonArray songs = result["songs"].toArray();
-        
-        if (songs.isEmpty()) {
-            m_lastError = "未找到歌曲";
-            qDebug() << "未找到歌曲:" << keyword;
-            return QString();
-        }
-        
-        // 获取第一首歌曲的 ID
-        QJsonObject song = songs[0].toObject();
-        int songId = song["id"].toInt();
-        
-        qDebug() << "找到歌曲 ID:" << songId;
-        
-        // 获取歌词
-        return downloadLyricById(songId);
+        return id;
     }
     
-    // 根据歌曲 ID 下载歌词
-    QString downloadLyricById(int songId)
+    // 取消任务（切歌时调用），未完成的查询被中止
+    void cancel(quint64 id)
     {
-        QString lyricUrl = QString("https://netease-cloud-music-api-psi-drab.vercel.app/lyric?id=%1").arg(songId);
-        
-        QNetworkRequest request;
-        request.setUrl(QUrl(lyricUrl));
-        request.setHeader(QNetworkRequest::UserAgentHeader, "QtMediaPlayer/1.0");
-        
-        QNetworkReply* reply = m_networkManager->get(request);
-        
-        // 等待响应
-        QEventLoop loop;
-        QTimer timer;
-        timer.setSingleShot(true);
-        
-        connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-        connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
-        
-        timer.start(10000); // 10秒超时
-        loop.exec();
-        
-        if (!timer.isActive()) {
-            m_lastError = "请求超时";
-            reply->deleteLater();
-            return QString();
-        }
-        timer.stop();
-        
-        if (reply->error() != QNetworkReply::NoError) {
-            m_lastError = "网络错误: " + reply->errorString();
-            reply->deleteLater();
-            return QString();
-        }
-        
-        QByteArray data = reply->readAll();
-        reply->deleteLater();
-        
-        // 解析歌词
-        QJsonDocument doc = QJsonDocument::fromJson(data);
-        if (doc.isNull() || !doc.isObject()) {
-            m_lastError = "解析歌词失败";
-            return QString();
-        }
-        
-        QJsonObject obj = doc.object();
-        QJsonObject lrc = obj["lrc"].toObject();
-        QString lyricText = lrc["lyric"].toString();
-        
-        if (lyricText.isEmpty()) {
-            m_lastError = "歌词为空";
-            return QString();
-        }
-        
-        qDebug() << "成功下载歌词，长度:" << lyricText.length();
-        return lyricText;
+        auto it = m_tasks.find(id);
+        if (it == m_tasks.end()) return;
+        const Task task = *it;
+        m_tasks.erase(it);
+        ++m_cancelled;
+        abortAll(task);
+        releaseRetiredProviders();
     }
     
+    void cancelAll()
+    {
+        const QList<quint64> ids = m_tasks.keys();
+        for (quint64 id : ids) cancel(id);
+    }
+    
+    // 统计：向各来源发起的查询数、完成/失败/取消的任务数、进行中的任务数
+    qint64 requestCount() const { return m_requests; }
+    qint64 succeededCount() const { return m_succeeded; }
+    qint64 failedCount() const { return m_failed; }
+    qint64 cancelledCount() const { return m_cancelled; }
+    int activeCount() const { return m_tasks.size(); }
+    
     // 保存歌词到文件
     static bool saveLyricToFile(const QString& lyricText, const QString& audioFilePath)
     {
@@ -236,29 +250,134 @@ public:
         return true;
     }
     
-    // 自动下载并保存歌词
-    bool autoDownloadLyric(const QString& audioFilePath)
+    // 自动下载并保存歌词，返回任务号；进度与结果通过 downloadProgress / downloadFinished 通知，
+    // 另外在保存之后调用 done（批量预取用它接收歌词文本）
+    quint64 autoDownloadLyric(const QString& audioFilePath, const FetchCallback& done = FetchCallback())
     {
         // 解析歌曲信息
         SongInfo info = parseSongInfo(audioFilePath);
         
         qDebug() << "尝试下载歌词 - 歌曲:" << info.title << "艺术家:" << info.artist;
+        emit downloadProgress(audioFilePath, "正在搜索歌词：" + info.title);
+        
+        const quint64 id = fetchLyric(info.title, info.artist,
+                                      [this, audioFilePath, done](const QString& lyricText, const QString& error, bool definitive) {
+            if (lyricText.isEmpty()) {
+                qDebug() << "下载歌词失败:" << error;
+                emit downloadFinished(audioFilePath, false, error);
+            } else if (saveLyricToFile(lyricText, audioFilePath)) {
+                // 保存到文件
+                emit downloadFinished(audioFilePath, true, "歌词下载成功");
+            } else {
+                emit downloadFinished(audioFilePath, false, "无法保存歌词文件");
+            }
+            if (done) done(lyricText, error, definitive);
+        });
+        if (m_tasks.contains(id)) m_tasks[id].audioPath = audioFilePath;
+        return id;
+    }
+    
+signals:
+    void downloadProgress(const QString& audioFilePath, const QString& message);
+    void downloadFinished(const QString& audioFilePath, bool success, const QString& message);
+    
+private:
+    // 向下一个来源发起查询；没有剩余来源时返回 false
+    bool launchNext(quint64 id)
+    {
+        Task& task = m_tasks[id];
+        if (task.pending.isEmpty()) return false;
+        LyricProvider* provider = task.pending.takeFirst();
+        
+        LyricFetch* fetch = provider->fetch(task.title, task.artist);
+        task.running.insert(fetch, provider);
+        task.startedAt.insert(fetch, m_clock.elapsed());
+        ++m_requests;
+        connect(fetch, &LyricFetch::finished, this,
+                [this, id, fetch](const QString& lyricText, const QString& error, bool definitive) {
+            onFetchFinished(id, fetch, lyricText, error, definitive);
+        });
+        
+        const QString audioPath = task.audioPath;
+        if (!audioPath.isEmpty()) emit downloadProgress(audioPath, "正在从 " + provider->name() + " 查询歌词");
+        return true;
+    }
+    
+    void onFetchFinished(quint64 id, LyricFetch* fetch, const QString& lyricText, const QString& error, bool definitive)
+    {
+        auto it = m_tasks.find(id);
+        if (it == m_tasks.end() || !it->running.contains(fetch)) return;
+        
+        LyricProvider* provider = it->running.take(fetch);
+        const qint64 elapsed = m_clock.elapsed() - it->startedAt.take(fetch);
+        if (definitive) {
+            provider->latency().record(elapsed);
+        } else {
+            provider->latency().recordFailure();
+        }
         
-        // 搜索并下载歌词
-        QString lyricText = searchAndDownloadLyric(info.title, info.artist);
-        
-        if (lyricText.isEmpty()) {
-            qDebug() << "下载歌词失败:" << m_lastError;
-            return false;
+        if (!lyricText.isEmpty()) {
+            qDebug() << "成功下载歌词，来源:" << provider->name() << "耗时" << elapsed << "ms，长度:" << lyricText.length();
+            finish(id, lyricText, QString(), true);
+            return;
         }
         
-        // 保存到文件
-        return saveLyricToFile(lyricText, audioFilePath);
+        qDebug() << "歌词来源" << provider->name() << "未返回歌词:" << error;
+        it->allDefinitive = it->allDefinitive && definitive;
+        
+        // 补上下一个来源；全部答复后结束
+        const bool allAnswered = it->running.isEmpty() && it->pending.isEmpty();
+        const bool allDefinitive = it->allDefinitive;
+        if (allAnswered) {
+            finish(id, QString(), error, allDefinitive);
+        } else {
+            launchNext(id);
+        }
     }
     
-signals:
-    void downloadProgress(const QString& message);
-    void downloadFinished(bool success, const QString& message);
+    // 中止任务中所有进行中的查询
+    static void abortAll(const Task& task)
+    {
+        for (auto it = task.running.cbegin(); it != task.running.cend(); ++it) {
+            it.key()->abort();
+        }
+    }
+    
+    // 结束任务并回调（回调中可以发起新任务）
+    // definitive 表示服务端给出了明确答复（有歌词或确认没有），写入缓存（结果本身来自缓存时除外）；网络错误、超时不缓存
+    // 释放已被替换、且不再有任务引用（待询问或进行中）的来源
+    void releaseRetiredProviders()
+    {
+        for (int i = m_retiredProviders.size() - 1; i >= 0; --i) {
+            LyricProvider* provider = m_retiredProviders[i];
+            bool inUse = false;
+            for (const Task& task : std::as_const(m_tasks)) {
+                if (task.pending.contains(provider) || std::find(task.running.cbegin(), task.running.cend(), provider)
+                                                           != task.running.cend()) {
+                    inUse = true;
+                    break;
+                }
+            }
+            if (inUse) continue;
+            m_retiredProviders.removeAt(i);
+            provider->deleteLater();
+        }
+    }
+    
+    void finish(quint64 id, const QString& lyricText, const QString& error, bool definitive = false, bool store = true)
+    {
+        const Task task = m_tasks.take(id);
+        abortAll(task);  // 其余来源的结果不再需要
+        releaseRetiredProviders();
+        if (definitive && store) m_cache->store(task.cacheKey, lyricText);
+        m_lastError = error;
+        if (lyricText.isEmpty()) {
+            ++m_failed;
+        } else {
+            ++m_succeeded;
+        }
+        if (task.callback) task.callback(lyricText, error, definitive);
+    }
 };
 
 #endif // LYRICDOWNLOADER_H
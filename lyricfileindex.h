@@ -0,0 +1,175 @@
+#ifndef LYRICFILEINDEX_H
+#define LYRICFILEINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// 目录级歌词文件索引
+// 查找规则与 LyricParser::findLyricFile 相同（同目录 -> lyrics/ -> Lyrics/），
+// 但每个目录只列举一次，之后的查找都在内存中完成；目录变化由 QFileSystemWatcher 通知后失效重建。
+// 监视数量有上限（inotify 等有系统限制），超出的目录改为定时过期；
+// 网络文件系统（NFS、SMB）上的变化不一定有通知，监视中的目录也有较长的有效期。
+// 只能在创建它的线程中使用（监视器的通知依赖该线程的事件循环）
+class LyricFileIndex : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int MAX_WATCHED = 4096;            // 最多监视的目录数
+    static const int UNWATCHED_TTL_MS = 30000;      // 未监视目录的缓存有效期
+    static const int WATCHED_TTL_MS = 600000;       // 监视中目录的缓存有效期（兜底收不到通知的情况）
+
+    // 一个目录的列举结果
+    struct Directory
+    {
+        QHash<QString, QString> lrcFiles;   // 折叠大小写后的文件名 -> 实际文件名
+        QString lowerSubdir;                // 实际的 lyrics 子目录名（不存在为空）
+        QString upperSubdir;                // 实际的 Lyrics 子目录名
+        bool watched = false;
+        qint64 listedAt = 0;                // 列举时刻（m_clock 毫秒）
+    };
+
+    QHash<QString, Directory> m_dirs;       // 绝对路径 -> 列举结果
+    QFileSystemWatcher *m_watcher;
+    QSet<QString> m_watched;                // 正在监视的目录
+    QElapsedTimer m_clock;
+
+    // 统计
+    qint64 m_listings = 0;                  // 目录列举次数（实际访问文件系统的次数）
+    qint64 m_lookups = 0;                   // 查找次数
+    qint64 m_lookupNs = 0;                  // 查找总耗时
+
+public:
+    explicit LyricFileIndex(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+        m_clock.start();
+        m_watcher = new QFileSystemWatcher(this);
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString &path) {
+            invalidate(path);
+            // 目录被删除时监视器会自动移除它
+            if (!m_watcher->directories().contains(path)) m_watched.remove(path);
+        });
+    }
+
+    // 查找音频对应的歌词文件，找不到返回空
+    QString find(const QString &audioFilePath)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        const QFileInfo audioInfo(audioFilePath);
+        const QString dirPath = audioInfo.absolutePath();
+        const QString fileName = audioInfo.completeBaseName() + ".lrc";
+
+        QString result = lookup(dirPath, fileName);
+        if (result.isEmpty()) {
+            // 先取出子目录名再查子目录：lookup 可能插入新目录使引用失效
+            const Directory &dir = directory(dirPath);
+            const QString lower = dir.lowerSubdir;
+            const QString upper = dir.upperSubdir;
+            if (!lower.isEmpty()) result = lookup(dirPath + "/" + lower, fileName);
+            if (result.isEmpty() && !upper.isEmpty()) result = lookup(dirPath + "/" + upper, fileName);
+        }
+
+        ++m_lookups;
+        m_lookupNs += timer.nsecsElapsed();
+        return result;
+    }
+
+    // 丢弃某个目录的列举结果（目录变化或确知有新文件时）
+    void invalidate(const QString &dirPath)
+    {
+        m_dirs.remove(dirPath);
+    }
+
+    // 丢弃某个音频所在目录及其歌词子目录的列举结果
+    void invalidateFor(const QString &audioFilePath)
+    {
+        const QString dirPath = QFileInfo(audioFilePath).absolutePath();
+        auto it = m_dirs.constFind(dirPath);
+        if (it != m_dirs.constEnd()) {
+            if (!it->lowerSubdir.isEmpty()) invalidate(dirPath + "/" + it->lowerSubdir);
+            if (!it->upperSubdir.isEmpty()) invalidate(dirPath + "/" + it->upperSubdir);
+        }
+        invalidate(dirPath);
+    }
+
+    // 统计：目录列举次数、查找次数、平均查找耗时（纳秒）
+    qint64 listingCount() const { return m_listings; }
+    qint64 lookupCount() const { return m_lookups; }
+    double averageLookupNs() const { return m_lookups > 0 ? double(m_lookupNs) / m_lookups : 0.0; }
+    int cachedDirectoryCount() const { return m_dirs.size(); }
+
+private:
+    // 文件系统是否区分大小写（与 QFile::exists 的行为保持一致）
+    static Qt::CaseSensitivity fileCase()
+    {
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+        return Qt::CaseInsensitive;
+#else
+        return Qt::CaseSensitive;
+#endif
+    }
+
+    static QString foldCase(const QString &name)
+    {
+        return fileCase() == Qt::CaseInsensitive ? name.toLower() : name;
+    }
+
+    QString lookup(const QString &dirPath, const QString &fileName)
+    {
+        const Directory &dir = directory(dirPath);
+        auto it = dir.lrcFiles.constFind(foldCase(fileName));
+        if (it == dir.lrcFiles.constEnd()) return QString();
+        return dirPath + "/" + it.value();
+    }
+
+    // 取得目录的列举结果，没有或已过期时重新列举
+    const Directory &directory(const QString &dirPath)
+    {
+        auto it = m_dirs.find(dirPath);
+        if (it != m_dirs.end()
+            && m_clock.elapsed() - it->listedAt < (it->watched ? WATCHED_TTL_MS : UNWATCHED_TTL_MS)) {
+            return *it;
+        }
+
+        Directory dir;
+        dir.listedAt = m_clock.elapsed();
+        QDirIterator iterator(dirPath, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+        while (iterator.hasNext()) {
+            iterator.next();
+            const QString name = iterator.fileName();
+            if (iterator.fileInfo().isDir()) {
+                if (name.compare("lyrics", fileCase()) == 0 && dir.lowerSubdir.isEmpty()) {
+                    dir.lowerSubdir = name;
+                } else if (name == "Lyrics") {
+                    dir.upperSubdir = name;
+                }
+            } else if (name.endsWith(".lrc", fileCase())) {
+                dir.lrcFiles.insert(foldCase(name), name);
+            }
+        }
+        ++m_listings;
+
+        // 不存在的目录无法监视，也同样缓存（定时过期），避免反复访问
+        if (m_watched.contains(dirPath)) {
+            dir.watched = true;
+        } else if (m_watched.size() < MAX_WATCHED && m_watcher->addPath(dirPath)) {
+            m_watched.insert(dirPath);
+            dir.watched = true;
+        }
+
+        return *m_dirs.insert(dirPath, dir);
+    }
+};
+
+#endif // LYRICFILEINDEX_H
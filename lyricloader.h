@@ -0,0 +1,119 @@
+#ifndef LYRICLOADER_H
+#define LYRICLOADER_H
+
+#include <QObject>
+#include <QThread>
+#include <QList>
+#include <QString>
+#include <QMetaType>
+#include <QDebug>
+#include <atomic>
+#include "lyricparser.h"
+#include "lyricfileindex.h"
+
+// 后台线程中的歌词加载器：经目录索引查找歌词文件并解析/读取缓存
+// 开始前、查找后各检查一次请求序号，已被新请求取代的任务直接放弃
+class LyricLoadWorker : public QObject
+{
+    Q_OBJECT
+
+private:
+    const std::atomic<quint64> &m_latest;   // 最新请求序号（由 LyricLoader 写入）
+    LyricFileIndex *m_index = nullptr;      // 歌词文件索引（在工作线程中创建）
+
+public:
+    explicit LyricLoadWorker(const std::atomic<quint64> &latest)
+        : m_latest(latest) {}
+
+public slots:
+    // rescan 为 true 时先丢弃该目录的索引（例如刚下载了歌词文件）
+    void load(const QString &audioPath, quint64 generation, bool rescan)
+    {
+        if (generation != m_latest.load(std::memory_order_acquire)) return;
+
+        if (!m_index) m_index = new LyricFileIndex(this);
+        if (rescan) m_index->invalidateFor(audioPath);
+        const QString lyricFile = m_index->find(audioPath);
+        qCDebug(lcLyrics) << "歌词索引: 查找" << m_index->lookupCount() << "次，列举目录" << m_index->listingCount()
+                          << "次，平均查找耗时" << m_index->averageLookupNs() / 1000.0 << "μs";
+        if (generation != m_latest.load(std::memory_order_acquire)) return;
+
+        QList<LyricLine> lyrics;
+        if (!lyricFile.isEmpty()) {
+            lyrics = LyricParser::loadLrcFile(lyricFile);
+        }
+        emit loaded(audioPath, lyrics, generation);
+    }
+
+signals:
+    void loaded(const QString &audioPath, const QList<LyricLine> &lyrics, quint64 generation);
+};
+
+// 异步歌词加载服务：切歌时不在 GUI 线程做任何文件访问
+// 每次请求递增序号，过期请求的结果（用户已切到别的曲目）直接丢弃
+class LyricLoader : public QObject
+{
+    Q_OBJECT
+
+private:
+    QThread m_thread;
+    LyricLoadWorker *m_worker;
+    std::atomic<quint64> m_generation{0};   // 最新请求序号
+
+public:
+    explicit LyricLoader(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+        qRegisterMetaType<QList<LyricLine>>("QList<LyricLine>");
+
+        m_worker = new LyricLoadWorker(m_generation);
+        m_worker->moveToThread(&m_thread);
+        connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+        connect(m_worker, &LyricLoadWorker::loaded, this, &LyricLoader::onLoaded);
+        m_thread.setObjectName("LyricLoader");
+        m_thread.start();
+    }
+
+    ~LyricLoader()
+    {
+        cancel();
+        m_thread.quit();
+        m_thread.wait();
+    }
+
+    // 请求某个本地音频的歌词，结果通过 lyricsReady / lyricsNotFound 返回
+    // 已知目录内容刚变化（监视器通知可能尚未到达）时传 rescan = true
+    void request(const QString &audioPath, bool rescan = false)
+    {
+        const quint64 generation = m_generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+        QMetaObject::invokeMethod(m_worker, [worker = m_worker, audioPath, generation, rescan]() {
+            worker->load(audioPath, generation, rescan);
+        }, Qt::QueuedConnection);
+    }
+
+    // 取消尚未返回的请求
+    void cancel()
+    {
+        m_generation.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+signals:
+    void lyricsReady(const QString &audioPath, const QList<LyricLine> &lyrics);
+    void lyricsNotFound(const QString &audioPath);
+
+private slots:
+    void onLoaded(const QString &audioPath, const QList<LyricLine> &lyrics, quint64 generation)
+    {
+        if (generation != m_generation.load(std::memory_order_acquire)) {
+            qDebug() << "丢弃过期的歌词加载结果:" << audioPath;
+            return;
+        }
+        if (lyrics.isEmpty()) {
+            emit lyricsNotFound(audioPath);
+        } else {
+            emit lyricsReady(audioPath, lyrics);
+        }
+    }
+};
+
+#endif // LYRICLOADER_H
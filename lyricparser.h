@@ -2,90 +2,229 @@
 #define LYRICPARSER_H
 
 #include <QString>
+#include <QByteArray>
 #include <QFile>
 #include <QTextStream>
-#include <QRegularExpression>
+#include <QVarLengthArray>
+#include <QElapsedTimer>
 #include <QList>
 #include <QDebug>
+#include <QLoggingCategory>
 #include <QFileInfo>
 #include <QDir>
+#include <algorithm>
+#include <cstring>
 #include "lyricwidget.h"
+#include "lyriccache.h"
+#include "encodingdetector.h"
+
+// 歌词查找、解析与加载的日志分类（每次加载都会经过，默认不输出调试信息）
+// 需要时设置 QT_LOGGING_RULES="qtmediaplayer.lyrics.debug=true"
+inline const QLoggingCategory &lcLyrics()
+{
+    static const QLoggingCategory category("qtmediaplayer.lyrics", QtInfoMsg);
+    return category;
+}
 
 // LRC 歌词解析器
 class LyricParser
 {
 public:
-    // 解析 LRC 格式歌词文件
+    // 解析 LRC 格式歌词文件（内存映射，映射失败时整体读入）
     static QList<LyricLine> parseLrcFile(const QString& filePath)
     {
         QList<LyricLine> lyrics;
         
         QFile file(filePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            qDebug() << "无法打开歌词文件:" << filePath;
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCDebug(lcLyrics) << "无法打开歌词文件:" << filePath;
+            return lyrics;
+        }
+        
+        QElapsedTimer timer;
+        timer.start();
+        
+        const qint64 size = file.size();
+        qint64 detectNs = 0;
+        if (size > 0) {
+            if (const uchar *mapped = file.map(0, size)) {
+                lyrics = parseLrcBytes(reinterpret_cast<const char *>(mapped), size, detectNs);
+                file.unmap(const_cast<uchar *>(mapped));
+            } else {
+                const QByteArray data = file.readAll();
+                lyrics = parseLrcBytes(data.constData(), data.size(), detectNs);
+            }
+        }
+        
+        file.close();
+        
+        qCDebug(lcLyrics) << "成功解析歌词文件，共" << lyrics.size() << "行，耗时"
+                          << timer.nsecsElapsed() / 1000 << "μs（编码检测" << detectNs / 1000 << "μs）";
+        return lyrics;
+    }
+    
+    // 检测编码后解析；非 UTF-8 文件先整体转换为 UTF-8
+    static QList<LyricLine> parseLrcBytes(const char *data, qint64 size, qint64 &detectNs)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        int bomLength = 0;
+        const TextEncoding encoding = EncodingDetector::detect(data, size, &bomLength);
+        detectNs = timer.nsecsElapsed();
+        
+        if (encoding == TextEncoding::Utf8) {
+            return parseLrcData(data, size);
+        }
+        
+        qCDebug(lcLyrics) << "歌词文件编码:" << EncodingDetector::name(encoding);
+        bool decoded = false;
+        const QByteArray utf8 = EncodingDetector::toUtf8(data + bomLength, size - bomLength, encoding, &decoded);
+        if (!decoded) {
+            return QList<LyricLine>();
+        }
+        return parseLrcData(utf8.constData(), utf8.size());
+    }
+    
+    // 加载歌词文件：优先读取二进制缓存，未命中时解析并写入缓存
+    static QList<LyricLine> loadLrcFile(const QString& filePath)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        
+        QList<LyricLine> lyrics;
+        const QString cachePath = LyricCache::cachePath(filePath);
+        if (LyricCache::load(cachePath, lyrics)) {
+            qCDebug(lcLyrics) << "从缓存加载歌词，共" << lyrics.size() << "行，耗时"
+                              << timer.nsecsElapsed() / 1000 << "μs";
             return lyrics;
         }
         
-        QTextStream in(&file);
-        in.setEncoding(QStringConverter::Utf8);
+        lyrics = parseLrcFile(filePath);
+        if (!lyrics.isEmpty()) {
+            LyricCache::save(cachePath, lyrics);
+        }
+        return lyrics;
+    }
+    
+    // 单遍扫描 UTF-8 LRC 数据（其他编码先经 parseLrcBytes 转换）：直接从字节解析时间标签，每行只构造一次最终文本
+    // 时间标签格式 [m:ss]、[mm:ss.xx]、[mmm:ss.xxx]，小数部分也接受 ':' 分隔
+    // 文本中的 <mm:ss.xx> 为增强型 LRC 的逐字时间
+    static QList<LyricLine> parseLrcData(const char *data, qint64 size)
+    {
+        QList<LyricLine> lyrics;
+        const char *p = data;
+        const char *end = data + size;
+        
+        // 跳过 UTF-8 BOM
+        if (size >= 3 && uchar(p[0]) == 0xEF && uchar(p[1]) == 0xBB && uchar(p[2]) == 0xBF) {
+            p += 3;
+        }
         
-        // LRC 时间标签正则表达式: [mm:ss.xx] 或 [mm:ss]
-        QRegularExpression timeRegex(R"(\[(\d{2}):(\d{2})(?:\.(\d{2,3}))?\])");
+        QVarLengthArray<qint64, 8> timestamps;  // 当前行的时间标签
+        QByteArray joined;                      // 标签夹在文本中间时拼接文本（少见）
+        bool sorted = true;
+        qint64 lastTimestamp = -1;
+        qint64 offset = 0;                      // [offset:] 标签（毫秒，正值表示歌词提前）
         
-        while (!in.atEnd()) {
-            QString line = in.readLine().trimmed();
+        while (p < end) {
+            // 定位行尾，兼容 \n、\r\n 与 \r
+            const char *lineEnd = p;
+            while (lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r') ++lineEnd;
+            const char *next = lineEnd;
+            if (next < end && *next == '\r') ++next;
+            if (next < end && *next == '\n') ++next;
             
-            if (line.isEmpty()) continue;
+            const char *lineBegin = p;
+            p = next;
+            trimSpaces(lineBegin, lineEnd);
+            if (lineBegin == lineEnd) continue;
             
-            // 查找所有时间标签
-            QRegularExpressionMatchIterator it = timeRegex.globalMatch(line);
-            QList<qint64> timestamps;
+            // 找出所有时间标签，其余部分作为文本段
+            timestamps.clear();
+            const char *segBegin = nullptr;
+            const char *segEnd = nullptr;
+            bool multiSegment = false;
+            auto addSegment = [&](const char *from, const char *to) {
+                if (from >= to) return;
+                if (!segBegin) {
+                    segBegin = from;
+                    segEnd = to;
+                    return;
+                }
+                if (!multiSegment) {
+                    joined = QByteArray(segBegin, segEnd - segBegin);
+                    multiSegment = true;
+                }
+                joined.append(from, to - from);
+            };
             
-            while (it.hasNext()) {
-                QRegularExpressionMatch match = it.next();
-                
-                int minutes = match.captured(1).toInt();
-                int seconds = match.captured(2).toInt();
-                int milliseconds = 0;
-                
-                if (!match.captured(3).isEmpty()) {
-                    QString msStr = match.captured(3);
-                    // 处理两位或三位毫秒
-                    if (msStr.length() == 2) {
-                        milliseconds = msStr.toInt() * 10;
-                    } else {
-                        milliseconds = msStr.toInt();
-                    }
+            const char *textStart = lineBegin;
+            const char *q = lineBegin;
+            while (q < lineEnd) {
+                const char *bracket = static_cast<const char *>(std::memchr(q, '[', lineEnd - q));
+                if (!bracket) break;
+                const char *tagEnd = bracket;
+                qint64 ms = 0;
+                if (parseTimeTag(tagEnd, lineEnd, ms)) {
+                    timestamps.append(ms);
+                    addSegment(textStart, bracket);
+                    textStart = q = tagEnd;
+                } else {
+                    q = bracket + 1;
                 }
-                
-                qint64 totalMs = (minutes * 60 + seconds) * 1000 + milliseconds;
-                timestamps.append(totalMs);
+            }
+            addSegment(textStart, lineEnd);
+            
+            // 没有时间标签的行是元数据（[ti:] [ar:] 等），只保留 [offset:]
+            if (timestamps.isEmpty()) {
+                parseOffsetTag(lineBegin, lineEnd, offset);
+                continue;
             }
             
-            // 提取歌词文本（移除所有时间标签）
-            QString lyricText = line;
-            lyricText.remove(timeRegex).trimmed();
+            const char *textBegin = multiSegment ? joined.constData() : segBegin;
+            const char *textEnd = multiSegment ? joined.constData() + joined.size() : segEnd;
+            trimSpaces(textBegin, textEnd);
             
-            // 跳过元数据标签（如 [ti:], [ar:], [al:] 等）
-            if (lyricText.startsWith("[") && lyricText.contains(":")) {
+            // 跳过形如 [xx:...] 的残余标签文本
+            if (textBegin < textEnd && *textBegin == '['
+                && std::memchr(textBegin, ':', textEnd - textBegin)) {
                 continue;
             }
             
-            // 为每个时间戳创建歌词行
+            // 多个时间标签共享同一份文本；逐字时间按第一个标签书写，其余各份按标签差值平移
+            QVector<LyricWord> words;
+            const QString text = std::memchr(textBegin, '<', textEnd - textBegin)
+                ? parseWords(textBegin, textEnd, words)
+                : QString::fromUtf8(textBegin, textEnd - textBegin);
             for (qint64 timestamp : timestamps) {
-                lyrics.append(LyricLine(timestamp, lyricText));
+                if (timestamp < lastTimestamp) sorted = false;
+                lastTimestamp = timestamp;
+                lyrics.append(LyricLine(timestamp, text));
+                lyrics.last().words = words;
+                const qint64 shift = timestamp - timestamps.first();
+                if (shift != 0) {
+                    for (LyricWord &word : lyrics.last().words) word.timestamp += shift;
+                }
             }
         }
         
-        file.close();
-        
-        // 按时间戳排序
-        std::sort(lyrics.begin(), lyrics.end(), 
-                  [](const LyricLine& a, const LyricLine& b) {
-                      return a.timestamp < b.timestamp;
-                  });
+        // 按时间戳排序（一行多标签或乱序文件才需要）
+        if (!sorted) {
+            std::stable_sort(lyrics.begin(), lyrics.end(),
+                             [](const LyricLine& a, const LyricLine& b) {
+                                 return a.timestamp < b.timestamp;
+                             });
+        }
         
-        qDebug() << "成功解析歌词文件，共" << lyrics.size() << "行";
+        // 应用 [offset:]：整体平移不改变顺序
+        if (offset != 0) {
+            for (LyricLine &line : lyrics) {
+                line.timestamp = qMax<qint64>(0, line.timestamp - offset);
+                for (LyricWord &word : line.words) {
+                    word.timestamp = qMax<qint64>(0, word.timestamp - offset);
+                }
+            }
+        }
         return lyrics;
     }
     
@@ -102,25 +241,25 @@ public:
         // 规则1: 同名 .lrc 文件
         QString sameDirLrc = dirPath + "/" + baseName + ".lrc";
         if (QFile::exists(sameDirLrc)) {
-            qDebug() << "找到歌词文件:" << sameDirLrc;
+            qCDebug(lcLyrics) << "找到歌词文件:" << sameDirLrc;
             return sameDirLrc;
         }
         
         // 规则2: lyrics 子文件夹中的同名文件
         QString lyricsSubDir = dirPath + "/lyrics/" + baseName + ".lrc";
         if (QFile::exists(lyricsSubDir)) {
-            qDebug() << "找到歌词文件:" << lyricsSubDir;
+            qCDebug(lcLyrics) << "找到歌词文件:" << lyricsSubDir;
             return lyricsSubDir;
         }
         
         // 规则3: Lyrics 子文件夹（大写）
         QString lyricsSubDirCap = dirPath + "/Lyrics/" + baseName + ".lrc";
         if (QFile::exists(lyricsSubDirCap)) {
-            qDebug() << "找到歌词文件:" << lyricsSubDirCap;
+            qCDebug(lcLyrics) << "找到歌词文件:" << lyricsSubDirCap;
             return lyricsSubDirCap;
         }
         
-        qDebug() << "未找到歌词文件:" << audioFilePath;
+        qCDebug(lcLyrics) << "未找到歌词文件:" << audioFilePath;
         return QString();
     }
     
@@ -133,7 +272,7 @@ public:
             return QList<LyricLine>();
         }
         
-        return parseLrcFile(lyricFile);
+        return loadLrcFile(lyricFile);
     }
     
     // 生成示例歌词文件（用于测试）
@@ -169,6 +308,108 @@ public:
         qDebug() << "已创建示例歌词文件:" << lrcPath;
         return true;
     }
+    
+private:
+    // 去掉两端的空格与制表符
+    static void trimSpaces(const char *&begin, const char *&end)
+    {
+        while (begin < end && (*begin == ' ' || *begin == '\t')) ++begin;
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t')) --end;
+    }
+    
+    // 读取 1~maxDigits 位十进制数，返回位数
+    static int readDigits(const char *&p, const char *end, int maxDigits, int &value)
+    {
+        int digits = 0;
+        value = 0;
+        while (p < end && digits < maxDigits && *p >= '0' && *p <= '9') {
+            value = value * 10 + (*p - '0');
+            ++p;
+            ++digits;
+        }
+        return digits;
+    }
+    
+    // 解析 [offset:±毫秒] 标签，格式不符时不修改 offset
+    static void parseOffsetTag(const char *begin, const char *end, qint64 &offset)
+    {
+        static const char TAG[] = "[offset:";
+        const int tagLength = sizeof(TAG) - 1;
+        if (end - begin <= tagLength || qstrnicmp(begin, TAG, tagLength) != 0) return;
+        
+        const char *p = begin + tagLength;
+        while (p < end && *p == ' ') ++p;
+        bool negative = false;
+        if (p < end && (*p == '+' || *p == '-')) {
+            negative = *p == '-';
+            ++p;
+        }
+        int value = 0;
+        if (readDigits(p, end, 6, value) == 0) return;
+        while (p < end && *p == ' ') ++p;
+        if (p >= end || *p != ']') return;
+        offset = negative ? -value : value;
+    }
+    
+    // 拆出逐字时间标签，返回去掉标签后的文本；标签前的文本不计时，
+    // 末尾标签后没有文字时记为长度 0 的结束标记
+    static QString parseWords(const char *begin, const char *end, QVector<LyricWord> &words)
+    {
+        QString text;
+        const char *segment = begin;
+        const char *q = begin;
+        qint64 wordTime = -1;
+        int wordStart = 0;
+        
+        auto closeWord = [&](const char *to) {
+            text += QString::fromUtf8(segment, to - segment);
+            if (wordTime >= 0) {
+                words.append(LyricWord{wordTime, wordStart, int(text.size()) - wordStart});
+            }
+        };
+        
+        while (q < end) {
+            const char *bracket = static_cast<const char *>(std::memchr(q, '<', end - q));
+            if (!bracket) break;
+            const char *tagEnd = bracket;
+            qint64 ms = 0;
+            if (parseTimeTag(tagEnd, end, ms, '>')) {
+                closeWord(bracket);
+                wordTime = ms;
+                wordStart = text.size();
+                segment = q = tagEnd;
+            } else {
+                q = bracket + 1;
+            }
+        }
+        closeWord(end);
+        return text;
+    }
+    
+    // 解析 p 处的时间标签（p 指向起始括号），成功时 p 移到结束括号之后
+    static bool parseTimeTag(const char *&p, const char *end, qint64 &ms, char close = ']')
+    {
+        const char *q = p + 1;
+        int minutes = 0, seconds = 0, fraction = 0;
+        if (readDigits(q, end, 3, minutes) == 0) return false;
+        if (q >= end || *q != ':') return false;
+        ++q;
+        if (readDigits(q, end, 2, seconds) == 0) return false;
+        
+        if (q < end && (*q == '.' || *q == ':')) {
+            ++q;
+            const int digits = readDigits(q, end, 3, fraction);
+            if (digits == 0) return false;
+            // 一位为十分之一秒，两位为百分之一秒，三位为毫秒
+            if (digits == 1) fraction *= 100;
+            else if (digits == 2) fraction *= 10;
+        }
+        if (q >= end || *q != close) return false;
+        
+        ms = (qint64(minutes) * 60 + seconds) * 1000 + fraction;
+        p = q + 1;
+        return true;
+    }
 };
 
 #endif // LYRICPARSER_H
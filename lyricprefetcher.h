@@ -0,0 +1,332 @@
+#ifndef LYRICPREFETCHER_H
+#define LYRICPREFETCHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <cmath>
+#include "lyricdownloader.h"
+#include "lyricparser.h"
+
+// 播放列表歌词批量预取
+// 对列表中没有本地歌词的曲目逐个调用 LyricDownloader::autoDownloadLyric：
+// 同时进行的任务数有上限，发起新任务受令牌桶限速；艺术家/歌名相同的曲目只查询一次，结果复制给其余曲目。
+// 未完成的队列定期写入磁盘，程序重启后 resume() 继续；
+// 网络错误、超时、熔断拒绝不算明确答复，这些曲目留在队列文件中，下次预取时重试
+class LyricPrefetcher : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int MAX_CONCURRENT = 4;        // 同时进行的下载任务数
+    static constexpr double RATE_PER_SEC = 2.0; // 令牌补充速度（每秒新任务数）
+    static constexpr double BURST = 4.0;        // 令牌桶容量
+    static const int SLICE_MS = 10;             // 每次调度检查本地歌词的时间片
+    static const int SAVE_DELAY_MS = 2000;      // 队列变化后延迟保存
+    static const int PROGRESS_INTERVAL_MS = 500; // 进度通知间隔
+
+    // 一个进行中的查询
+    struct ActiveTask
+    {
+        quint64 id = 0;         // 下载任务号
+        QString path;           // 发起查询的曲目
+        QStringList waiters;    // 艺术家/歌名相同、等待同一结果的其他曲目
+    };
+
+    LyricDownloader *m_downloader;
+    QString m_queuePath;                        // 队列持久化文件
+    QStringList m_queue;                        // 本轮全部曲目
+    int m_head = 0;                             // 下一个待处理的位置
+    QHash<QString, ActiveTask> m_active;        // 进行中的查询：缓存键 -> 任务
+    QHash<QString, QString> m_resolved;         // 本轮已完成的查询：缓存键 -> 歌词（空为未找到）
+    QSet<QString> m_transient;                  // 本轮暂时失败的查询（缓存键），同键曲目不再重复查询
+    QStringList m_deferred;                     // 暂时失败、留待下次重试的曲目
+    bool m_running = false;
+    bool m_pumpQueued = false;
+
+    // 令牌桶
+    double m_tokens = BURST;
+    QElapsedTimer m_refillClock;
+
+    QTimer *m_pumpTimer;                        // 等待令牌
+    QTimer *m_saveTimer;
+
+    // 统计
+    QElapsedTimer m_runClock;
+    QElapsedTimer m_progressClock;
+    int m_fetched = 0;      // 下载成功
+    int m_skipped = 0;      // 已有本地歌词
+    int m_failed = 0;       // 确认没有歌词（或无法保存）
+    int m_tasks = 0;        // 发起的下载任务数（不含复用结果的曲目）
+
+public:
+    explicit LyricPrefetcher(LyricDownloader *downloader, QObject *parent = nullptr)
+        : QObject(parent)
+        , m_downloader(downloader)
+    {
+        m_queuePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/lyricprefetch.lst";
+
+        m_pumpTimer = new QTimer(this);
+        m_pumpTimer->setSingleShot(true);
+        connect(m_pumpTimer, &QTimer::timeout, this, &LyricPrefetcher::pump);
+
+        m_saveTimer = new QTimer(this);
+        m_saveTimer->setSingleShot(true);
+        m_saveTimer->setInterval(SAVE_DELAY_MS);
+        connect(m_saveTimer, &QTimer::timeout, this, &LyricPrefetcher::saveQueue);
+    }
+
+    ~LyricPrefetcher()
+    {
+        if (m_running) saveQueue();
+    }
+
+    // 开始预取（已在运行时把新曲目追加到队列）；上次未完成与暂时失败的曲目排在前面
+    void start(const QStringList &audioPaths)
+    {
+        if (!m_running) {
+            m_queue = loadQueue();
+            m_head = 0;
+            m_resolved.clear();
+            m_transient.clear();
+            m_deferred.clear();
+            m_fetched = m_skipped = m_failed = m_tasks = 0;
+            m_tokens = BURST;
+            m_refillClock.start();
+            m_runClock.start();
+            m_progressClock.start();
+            m_running = true;
+        }
+        m_queue.append(audioPaths);
+        m_queue.removeDuplicates();     // 保留先出现的，已处理的部分不受影响
+        qDebug() << "开始预取歌词:" << audioPaths.size() << "首";
+        m_saveTimer->start();
+        schedulePump();
+    }
+
+    // 继续上次未完成的预取
+    void resume()
+    {
+        if (m_running || loadQueue().isEmpty()) return;
+        qDebug() << "继续上次的歌词预取";
+        start(QStringList());
+    }
+
+    // 停止预取并中止进行中的任务；未完成的部分保留，下次 resume() 继续
+    void stop()
+    {
+        if (!m_running) return;
+        saveQueue();
+        const QHash<QString, ActiveTask> active = m_active;
+        m_active.clear();
+        for (const ActiveTask &task : active) {
+            m_downloader->cancel(task.id);
+        }
+        m_pumpTimer->stop();
+        m_saveTimer->stop();
+        m_running = false;
+    }
+
+    bool isRunning() const { return m_running; }
+
+    // 统计：已处理 / 总数、下载成功、已有本地歌词、确认没有、暂时失败、实际发起的下载任务数
+    int completedCount() const { return m_fetched + m_skipped + m_failed + int(m_deferred.size()); }
+    int totalCount() const { return m_queue.size(); }
+    int fetchedCount() const { return m_fetched; }
+    int skippedCount() const { return m_skipped; }
+    int failedCount() const { return m_failed; }
+    int deferredCount() const { return int(m_deferred.size()); }
+    int taskCount() const { return m_tasks; }
+
+    // 吞吐量（每秒处理的曲目数）
+    double throughput() const
+    {
+        const qint64 ms = m_runClock.isValid() ? m_runClock.elapsed() : 0;
+        return ms > 0 ? completedCount() * 1000.0 / ms : 0.0;
+    }
+
+signals:
+    void progress(int completed, int total, double tracksPerSecond);
+    void finished(int fetched, int skipped, int failed);
+
+private slots:
+    // 调度：检查本地歌词、合并重复查询，在并发与令牌允许时发起新任务
+    void pump()
+    {
+        m_pumpQueued = false;
+        if (!m_running) return;
+
+        QElapsedTimer slice;
+        slice.start();
+        while (m_head < m_queue.size() && m_active.size() < MAX_CONCURRENT) {
+            // 查找本地歌词要访问文件系统，用完时间片后让出事件循环
+            if (slice.elapsed() >= SLICE_MS) {
+                schedulePump();
+                return;
+            }
+
+            const QString path = m_queue[m_head];
+            if (!LyricParser::findLyricFile(path).isEmpty()) {
+                ++m_head;
+                ++m_skipped;
+                continue;
+            }
+
+            const LyricDownloader::SongInfo info = LyricDownloader::parseSongInfo(path);
+            const QString key = LyricResponseCache::makeKey(info.title, info.artist);
+            auto resolved = m_resolved.constFind(key);
+            if (resolved != m_resolved.constEnd()) {
+                ++m_head;
+                settle(path, resolved.value());
+                continue;
+            }
+            if (m_transient.contains(key)) {
+                ++m_head;
+                m_deferred.append(path);
+                continue;
+            }
+            auto active = m_active.find(key);
+            if (active != m_active.end()) {
+                ++m_head;
+                active->waiters.append(path);
+                continue;
+            }
+
+            const qint64 waitMs = takeToken();
+            if (waitMs > 0) {
+                m_pumpTimer->start(int(waitMs));
+                break;
+            }
+
+            ++m_head;
+            ++m_tasks;
+            ActiveTask task;
+            task.path = path;
+            m_active.insert(key, task);
+            // 缓存命中时也是异步回调，此时任务一定还在表中
+            m_active[key].id = m_downloader->autoDownloadLyric(path,
+                [this, key](const QString &lyricText, const QString &, bool definitive) {
+                    onTaskFinished(key, lyricText, definitive);
+                });
+        }
+
+        if (!m_saveTimer->isActive()) m_saveTimer->start();  // 持续调度时也按间隔保存
+        reportProgress(false);
+        if (m_head >= m_queue.size() && m_active.isEmpty()) finish();
+    }
+
+private:
+    void schedulePump()
+    {
+        if (m_pumpQueued) return;
+        m_pumpQueued = true;
+        QMetaObject::invokeMethod(this, &LyricPrefetcher::pump, Qt::QueuedConnection);
+    }
+
+    // 取一个令牌；没有令牌时返回需要等待的毫秒数
+    qint64 takeToken()
+    {
+        m_tokens = qMin(BURST, m_tokens + m_refillClock.restart() * RATE_PER_SEC / 1000.0);
+        if (m_tokens >= 1.0) {
+            m_tokens -= 1.0;
+            return 0;
+        }
+        return qMax<qint64>(1, qint64(std::ceil((1.0 - m_tokens) * 1000.0 / RATE_PER_SEC)));
+    }
+
+    void onTaskFinished(const QString &key, const QString &lyricText, bool definitive)
+    {
+        const ActiveTask task = m_active.take(key);
+        if (lyricText.isEmpty() && !definitive) {
+            // 暂时失败：不当作"没有歌词"复制给其他曲目，全部留待下次重试
+            m_transient.insert(key);
+            m_deferred.append(task.path);
+            m_deferred.append(task.waiters);
+            m_saveTimer->start();
+            schedulePump();
+            return;
+        }
+
+        m_resolved.insert(key, lyricText);
+        if (lyricText.isEmpty()) {
+            ++m_failed;
+        } else {
+            ++m_fetched;  // autoDownloadLyric 已保存
+        }
+        for (const QString &waiter : task.waiters) {
+            settle(waiter, lyricText);
+        }
+        schedulePump();
+    }
+
+    // 复用已完成查询的结果
+    void settle(const QString &path, const QString &lyricText)
+    {
+        if (!lyricText.isEmpty() && LyricDownloader::saveLyricToFile(lyricText, path)) {
+            ++m_fetched;
+        } else {
+            ++m_failed;
+        }
+    }
+
+    void reportProgress(bool force)
+    {
+        if (!force && m_progressClock.elapsed() < PROGRESS_INTERVAL_MS) return;
+        m_progressClock.restart();
+        emit progress(completedCount(), totalCount(), throughput());
+    }
+
+    void finish()
+    {
+        m_running = false;
+        m_saveTimer->stop();
+        m_resolved.clear();
+        m_transient.clear();
+        if (m_deferred.isEmpty()) {
+            QFile::remove(m_queuePath);
+        } else {
+            saveQueue();    // 只剩暂时失败的曲目
+        }
+        reportProgress(true);
+        qDebug() << "歌词预取完成: 下载" << m_fetched << "首，已有" << m_skipped << "首，没有歌词" << m_failed
+                 << "首，暂时失败" << m_deferred.size() << "首，下载任务" << m_tasks << "个，耗时"
+                 << m_runClock.elapsed() / 1000.0 << "秒，" << throughput() << "首/秒";
+        emit finished(m_fetched, m_skipped, m_failed);
+    }
+
+    // 保存尚未完成的曲目（暂时失败、进行中、等待中与未处理的）
+    void saveQueue()
+    {
+        QStringList remaining = m_deferred;
+        for (const ActiveTask &task : std::as_const(m_active)) {
+            remaining.append(task.path);
+            remaining.append(task.waiters);
+        }
+        remaining.append(m_queue.mid(m_head));
+        remaining.removeDuplicates();
+
+        QDir().mkpath(QFileInfo(m_queuePath).absolutePath());
+        QSaveFile file(m_queuePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return;
+        file.write(remaining.join('\n').toUtf8());
+        file.commit();
+    }
+
+    QStringList loadQueue() const
+    {
+        QFile file(m_queuePath);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return QStringList();
+        return QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts);
+    }
+};
+
+#endif // LYRICPREFETCHER_H
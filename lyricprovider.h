@@ -0,0 +1,390 @@
+#ifndef LYRICPROVIDER_H
+#define LYRICPROVIDER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFile>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QStringList>
+#include <QDebug>
+#include <functional>
+#include "encodingdetector.h"
+#include "networkresilience.h"
+
+// 一次进行中的歌词查询（由 LyricProvider::fetch 创建，完成后自行销毁）
+// definitive 表示来源给出了明确答复（有歌词或确认没有）；网络错误、超时为 false
+class LyricFetch : public QObject
+{
+    Q_OBJECT
+
+private:
+    bool m_done = false;
+
+public:
+    explicit LyricFetch(QObject *parent = nullptr) : QObject(parent) {}
+
+    // 中止查询，之后不再发出 finished
+    virtual void abort()
+    {
+        m_done = true;
+        deleteLater();
+    }
+
+signals:
+    void finished(const QString &lyricText, const QString &error, bool definitive);
+
+protected:
+    void complete(const QString &lyricText, const QString &error, bool definitive)
+    {
+        if (m_done) return;
+        m_done = true;
+        emit finished(lyricText, error, definitive);
+        deleteLater();
+    }
+
+    bool isDone() const { return m_done; }
+};
+
+// 响应时间直方图（按 2 倍递增分桶），用于给歌词来源排序
+// 样本累计到上限后各桶减半，使近期表现占主导
+class LatencyHistogram
+{
+private:
+    static const int BUCKET_COUNT = 10;     // 上界 50ms、100ms … 12800ms，最后一桶不设上界
+    static const int FIRST_BOUND_MS = 50;
+    static const int DECAY_TOTAL = 256;
+
+    int m_counts[BUCKET_COUNT] = {};
+    int m_total = 0;
+    qint64 m_failures = 0;
+
+public:
+    void record(qint64 ms)
+    {
+        int bucket = 0;
+        qint64 bound = FIRST_BOUND_MS;
+        while (bucket < BUCKET_COUNT - 1 && ms > bound) {
+            ++bucket;
+            bound *= 2;
+        }
+        add(bucket);
+    }
+
+    // 出错或超时：按最慢的一档计入
+    void recordFailure()
+    {
+        ++m_failures;
+        add(BUCKET_COUNT - 1);
+    }
+
+    // 分位数（所在桶的上界，毫秒）；没有样本时返回 0
+    qint64 quantile(double q) const
+    {
+        if (m_total == 0) return 0;
+        const double target = q * m_total;
+        int seen = 0;
+        qint64 bound = FIRST_BOUND_MS;
+        for (int i = 0; i < BUCKET_COUNT; ++i, bound *= 2) {
+            seen += m_counts[i];
+            if (seen >= target) return bound;
+        }
+        return bound;
+    }
+
+    int sampleCount() const { return m_total; }
+    qint64 failureCount() const { return m_failures; }
+    int bucketCount() const { return BUCKET_COUNT; }
+    int bucket(int index) const { return m_counts[index]; }
+    qint64 bucketBound(int index) const { return qint64(FIRST_BOUND_MS) << index; }
+
+private:
+    void add(int bucket)
+    {
+        ++m_counts[bucket];
+        if (++m_total < DECAY_TOTAL) return;
+        m_total = 0;
+        for (int &count : m_counts) {
+            count /= 2;
+            m_total += count;
+        }
+    }
+};
+
+// 歌词来源接口：按歌名/艺术家查询歌词，基础地址可配置
+class LyricProvider : public QObject
+{
+    Q_OBJECT
+
+protected:
+    QUrl m_baseUrl;
+    LatencyHistogram m_latency;                     // 本来源的响应时间
+
+public:
+    LyricProvider(const QUrl &baseUrl, QObject *parent = nullptr)
+        : QObject(parent), m_baseUrl(baseUrl) {}
+
+    virtual QString name() const = 0;
+
+    // 发起查询；返回的对象完成时发出 finished，可随时 abort()
+    virtual LyricFetch *fetch(const QString &title, const QString &artist) = 0;
+
+    void setBaseUrl(const QUrl &url) { m_baseUrl = url; }
+    QUrl baseUrl() const { return m_baseUrl; }
+
+    LatencyHistogram &latency() { return m_latency; }
+    const LatencyHistogram &latency() const { return m_latency; }
+
+protected:
+    // 基础地址下的子路径
+    QUrl endpoint(const QString &path) const
+    {
+        QUrl url = m_baseUrl;
+        QString base = url.path();
+        if (!base.endsWith('/')) base += '/';
+        url.setPath(base + path);
+        return url;
+    }
+
+    // 超时由容错层控制（单次超时与整体截止时间）
+    static QNetworkRequest makeRequest(const QUrl &url)
+    {
+        QNetworkRequest request(url);
+        request.setHeader(QNetworkRequest::UserAgentHeader, "QtMediaPlayer/1.0");
+        request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+        return request;
+    }
+
+    // 把网络错误转成查询结果；无错误时返回 false
+    static bool replyFailed(const NetworkResult &result, QString &error)
+    {
+        if (result.ok()) return false;
+        error = result.rejected ? result.errorString : "网络错误: " + result.errorString;
+        return true;
+    }
+};
+
+// 基于网络请求的查询：经容错层发出（重试、熔断），持有当前请求，中止时一并中止
+class NetworkLyricFetch : public LyricFetch
+{
+    Q_OBJECT
+
+private:
+    QPointer<ResilientRequest> m_request;
+
+public:
+    using LyricFetch::LyricFetch;
+    using LyricFetch::complete;
+    using LyricFetch::isDone;
+
+    // 发出请求，完成后（未被中止时）调用 handler
+    void get(QNetworkAccessManager *manager, const QNetworkRequest &request,
+             const std::function<void(const NetworkResult &)> &handler)
+    {
+        m_request = NetworkResilience::instance()->get(manager, request, this,
+            [this, handler](const NetworkResult &result) {
+                m_request = nullptr;
+                if (!isDone()) handler(result);
+            });
+    }
+
+    void abort() override
+    {
+        QPointer<ResilientRequest> request = m_request;
+        m_request = nullptr;
+        LyricFetch::abort();
+        if (request) request->abort();
+    }
+};
+
+// 网易云音乐 API（第三方接口，实际使用时请确保合法性）：先搜索歌曲 ID，再取歌词
+class NeteaseLyricProvider : public LyricProvider
+{
+    Q_OBJECT
+
+private:
+    QNetworkAccessManager *m_manager;
+
+public:
+    NeteaseLyricProvider(QNetworkAccessManager *manager, const QUrl &baseUrl, QObject *parent = nullptr)
+        : LyricProvider(baseUrl, parent), m_manager(manager) {}
+
+    QString name() const override { return "netease"; }
+
+    LyricFetch *fetch(const QString &title, const QString &artist) override
+    {
+        QString keyword = title;
+        if (!artist.isEmpty()) keyword = artist + " " + title;
+
+        NetworkLyricFetch *task = new NetworkLyricFetch(this);
+        QUrl url = endpoint("search");
+        QUrlQuery query;
+        query.addQueryItem("keywords", keyword);
+        query.addQueryItem("limit", "1");
+        url.setQuery(query);
+
+        // 搜索结果返回后立即在同一连接上请求歌词
+        task->get(m_manager, makeRequest(url), [this, task, keyword](const NetworkResult &reply) {
+            QString error;
+            if (replyFailed(reply, error)) {
+                task->complete(QString(), error, false);
+                return;
+            }
+            QJsonDocument doc = QJsonDocument::fromJson(reply.body);
+            if (!doc.isObject()) {
+                task->complete(QString(), "解析搜索结果失败", false);
+                return;
+            }
+            QJsonArray songs = doc.object()["result"].toObject()["songs"].toArray();
+            if (songs.isEmpty()) {
+                qDebug() << "未找到歌曲:" << keyword;
+                task->complete(QString(), "未找到歌曲", true);
+                return;
+            }
+
+            const qint64 songId = songs[0].toObject()["id"].toVariant().toLongLong();
+            qDebug() << "找到歌曲 ID:" << songId;
+            QUrl lyricUrl = endpoint("lyric");
+            QUrlQuery lyricQuery;
+            lyricQuery.addQueryItem("id", QString::number(songId));
+            lyricUrl.setQuery(lyricQuery);
+            task->get(m_manager, makeRequest(lyricUrl), [task](const NetworkResult &lyricReply) {
+                QString lyricError;
+                if (replyFailed(lyricReply, lyricError)) {
+                    task->complete(QString(), lyricError, false);
+                    return;
+                }
+                QJsonDocument lyricDoc = QJsonDocument::fromJson(lyricReply.body);
+                if (!lyricDoc.isObject()) {
+                    task->complete(QString(), "解析歌词失败", false);
+                    return;
+                }
+                const QString lyricText = lyricDoc.object()["lrc"].toObject()["lyric"].toString();
+                if (lyricText.isEmpty()) {
+                    task->complete(QString(), "歌词为空", true);
+                } else {
+                    task->complete(lyricText, QString(), true);
+                }
+            });
+        });
+        return task;
+    }
+};
+
+// 本地歌词库：基础地址为 file:// 目录或 http:// 静态文件服务器，
+// 按 "艺术家 - 歌名.lrc"、"歌名.lrc" 依次查找（离线环境与测试用）
+class LocalLyricProvider : public LyricProvider
+{
+    Q_OBJECT
+
+private:
+    QNetworkAccessManager *m_manager;
+
+public:
+    LocalLyricProvider(QNetworkAccessManager *manager, const QUrl &baseUrl, QObject *parent = nullptr)
+        : LyricProvider(baseUrl, parent), m_manager(manager) {}
+
+    QString name() const override { return "local"; }
+
+    LyricFetch *fetch(const QString &title, const QString &artist) override
+    {
+        QStringList names;
+        if (!artist.isEmpty()) names << artist + " - " + title + ".lrc";
+        names << title + ".lrc";
+
+        NetworkLyricFetch *task = new NetworkLyricFetch(this);
+        if (m_baseUrl.isLocalFile()) {
+            // 本地文件很小，直接读取；结果仍异步返回，与网络来源一致
+            QString lyricText;
+            for (const QString &name : names) {
+                lyricText = readFile(endpoint(name).toLocalFile());
+                if (!lyricText.isEmpty()) break;
+            }
+            QMetaObject::invokeMethod(task, [task, lyricText]() {
+                task->complete(lyricText, lyricText.isEmpty() ? QString("未找到歌曲") : QString(), true);
+            }, Qt::QueuedConnection);
+        } else {
+            tryNext(task, names, 0);
+        }
+        return task;
+    }
+
+private:
+    void tryNext(NetworkLyricFetch *task, const QStringList &names, int index)
+    {
+        if (index >= names.size()) {
+            task->complete(QString(), "未找到歌曲", true);
+            return;
+        }
+        task->get(m_manager, makeRequest(endpoint(names[index])), [this, task, names, index](const NetworkResult &reply) {
+            if (reply.httpStatus == 404) {
+                tryNext(task, names, index + 1);
+                return;
+            }
+            QString error;
+            if (replyFailed(reply, error)) {
+                task->complete(QString(), error, false);
+                return;
+            }
+            const QString lyricText = decode(reply.body);
+            if (lyricText.isEmpty()) {
+                tryNext(task, names, index + 1);
+            } else {
+                task->complete(lyricText, QString(), true);
+            }
+        });
+    }
+
+    static QString readFile(const QString &path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) return QString();
+        return decode(file.readAll());
+    }
+
+    // 本地歌词库的编码不一定是 UTF-8，与本地歌词文件同样检测
+    static QString decode(const QByteArray &data)
+    {
+        int bomLength = 0;
+        const TextEncoding encoding = EncodingDetector::detect(data.constData(), data.size(), &bomLength);
+        return QString::fromUtf8(EncodingDetector::toUtf8(data.constData() + bomLength, data.size() - bomLength, encoding));
+    }
+};
+
+// 按配置创建歌词来源
+// 配置格式："类型=基础地址;类型=基础地址"，类型为 netease 或 local，例如
+//   "local=file:///home/me/lyrics;netease=https://example.com/api/"
+// 为空时只使用默认的网易云接口
+inline QList<LyricProvider *> createLyricProviders(const QString &spec, QNetworkAccessManager *manager, QObject *parent)
+{
+    static const char *DEFAULT_NETEASE_URL = "https://netease-cloud-music-api-psi-drab.vercel.app/";
+
+    QList<LyricProvider *> providers;
+    const QStringList entries = spec.split(';', Qt::SkipEmptyParts);
+    for (const QString &entry : entries) {
+        const int separator = entry.indexOf('=');
+        const QString type = entry.left(separator).trimmed().toLower();
+        const QUrl url = QUrl::fromUserInput(entry.mid(separator + 1).trimmed());
+        if (separator <= 0 || !url.isValid()) {
+            qDebug() << "忽略无效的歌词来源配置:" << entry;
+        } else if (type == "netease") {
+            providers << new NeteaseLyricProvider(manager, url, parent);
+        } else if (type == "local") {
+            providers << new LocalLyricProvider(manager, url, parent);
+        } else {
+            qDebug() << "未知的歌词来源类型:" << type;
+        }
+    }
+    if (providers.isEmpty()) {
+        providers << new NeteaseLyricProvider(manager, QUrl(DEFAULT_NETEASE_URL), parent);
+    }
+    return providers;
+}
+
+#endif // LYRICPROVIDER_H
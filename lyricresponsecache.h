@@ -0,0 +1,259 @@
+#ifndef LYRICRESPONSECACHE_H
+#define LYRICRESPONSECACHE_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QTimer>
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include "binaryformat.h"
+
+// 在线歌词查询结果的磁盘缓存
+// 以规范化后的 艺术家/歌名 为键；找到的歌词（正缓存）与"未找到"（负缓存）分别设有效期，
+// 条目数与歌词总量有上限，超出时淘汰最久未使用的条目。
+// 缓存文件格式（小端）：
+//   "QMLR" | quint32 版本 | quint32 条目数 | quint32 保留
+//   | 条目[条目数]：qint64 写入时间 | qint64 最近使用时间 | quint32 键长度 | quint32 歌词长度 | UTF-16 键 | UTF-16 歌词
+// 歌词长度为 0 表示负缓存
+// 命中只在内存中刷新最近使用时间，不触发写盘；写入、淘汰后延迟保存，退出时再把刷新过的使用时间一并写回
+class LyricResponseCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Lookup
+    {
+        Miss,       // 没有有效条目，需要联网
+        Found,      // 命中正缓存
+        NotFound    // 命中负缓存（服务端已答复没有这首歌的歌词）
+    };
+
+private:
+    static const quint32 VERSION = 1;
+    static const int HEADER_SIZE = 16;
+    static const int ENTRY_SIZE = 24;
+    static constexpr qint64 POSITIVE_TTL_MS = 30LL * 24 * 3600 * 1000;  // 正缓存有效期：30 天
+    static constexpr qint64 NEGATIVE_TTL_MS = 24LL * 3600 * 1000;       // 负缓存有效期：1 天（服务端可能补上歌词）
+    static const int MAX_ENTRIES = 2000;                // 条目数上限
+    static const qint64 MAX_TEXT_UNITS = 4 * 1024 * 1024; // 歌词总量上限（UTF-16 单元，约 8MB）
+    static const int SAVE_DELAY_MS = 2000;              // 变更后延迟保存（合并连续写入）
+
+    struct Entry
+    {
+        QString lyricText;      // 空表示负缓存
+        qint64 storedAt = 0;    // 写入时间（毫秒，UTC）
+        qint64 lastUsed = 0;    // 最近使用时间
+    };
+
+    QString m_path;
+    QHash<QString, Entry> m_entries;
+    qint64 m_textUnits = 0;     // 当前歌词总量
+    bool m_loaded = false;      // 首次使用时才读盘
+    bool m_touched = false;     // 有条目的最近使用时间尚未写盘
+    QTimer *m_saveTimer;
+
+    // 统计
+    qint64 m_hits = 0;
+    qint64 m_negativeHits = 0;
+    qint64 m_misses = 0;
+    qint64 m_evictions = 0;
+
+public:
+    explicit LyricResponseCache(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+        m_path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/lyricresponses.bin";
+        m_saveTimer = new QTimer(this);
+        m_saveTimer->setSingleShot(true);
+        m_saveTimer->setInterval(SAVE_DELAY_MS);
+        connect(m_saveTimer, &QTimer::timeout, this, &LyricResponseCache::save);
+    }
+
+    ~LyricResponseCache()
+    {
+        if (m_saveTimer->isActive() || m_touched) save();
+    }
+
+    // 缓存键：兼容分解、转小写、合并空白后的 艺术家\n歌名
+    static QString makeKey(const QString &title, const QString &artist)
+    {
+        auto normalize = [](const QString &text) {
+            return text.normalized(QString::NormalizationForm_KC).toCaseFolded().simplified();
+        };
+        return normalize(artist) + '\n' + normalize(title);
+    }
+
+    // 查询；命中正缓存时 lyricText 为歌词
+    Lookup lookup(const QString &key, QString &lyricText)
+    {
+        ensureLoaded();
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) {
+            ++m_misses;
+            return Lookup::Miss;
+        }
+
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        if (expired(it.value(), now)) {
+            m_textUnits -= it->lyricText.size();
+            m_entries.erase(it);
+            m_saveTimer->start();
+            ++m_misses;
+            return Lookup::Miss;
+        }
+
+        it->lastUsed = now;
+        m_touched = true;
+        if (it->lyricText.isEmpty()) {
+            ++m_negativeHits;
+            return Lookup::NotFound;
+        }
+        lyricText = it->lyricText;
+        ++m_hits;
+        return Lookup::Found;
+    }
+
+    // 记录查询结果；lyricText 为空表示服务端确认没有歌词
+    void store(const QString &key, const QString &lyricText)
+    {
+        ensureLoaded();
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) m_textUnits -= it->lyricText.size();
+
+        Entry entry;
+        entry.lyricText = lyricText;
+        entry.storedAt = now;
+        entry.lastUsed = now;
+        m_entries.insert(key, entry);
+        m_textUnits += lyricText.size();
+
+        evict();
+        m_saveTimer->start();
+    }
+
+    void clear()
+    {
+        ensureLoaded();
+        m_entries.clear();
+        m_textUnits = 0;
+        m_saveTimer->start();
+    }
+
+    // 统计：正缓存命中、负缓存命中、未命中、淘汰次数、当前条目数
+    qint64 hitCount() const { return m_hits; }
+    qint64 negativeHitCount() const { return m_negativeHits; }
+    qint64 missCount() const { return m_misses; }
+    qint64 evictionCount() const { return m_evictions; }
+    int entryCount() const { return m_entries.size(); }
+
+private:
+    static bool expired(const Entry &entry, qint64 now)
+    {
+        const qint64 ttl = entry.lyricText.isEmpty() ? NEGATIVE_TTL_MS : POSITIVE_TTL_MS;
+        return now - entry.storedAt > ttl;
+    }
+
+    // 超出上限时先清掉过期条目，仍超出则按最近使用时间淘汰
+    void evict()
+    {
+        if (m_entries.size() <= MAX_ENTRIES && m_textUnits <= MAX_TEXT_UNITS) return;
+
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        QVector<QPair<qint64, QString>> order;
+        order.reserve(m_entries.size());
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (expired(it.value(), now)) {
+                m_textUnits -= it->lyricText.size();
+                it = m_entries.erase(it);
+            } else {
+                order.append(qMakePair(it->lastUsed, it.key()));
+                ++it;
+            }
+        }
+
+        std::sort(order.begin(), order.end());
+        for (const auto &item : order) {
+            if (m_entries.size() <= MAX_ENTRIES && m_textUnits <= MAX_TEXT_UNITS) break;
+            m_textUnits -= m_entries.value(item.second).lyricText.size();
+            m_entries.remove(item.second);
+            ++m_evictions;
+        }
+    }
+
+    void ensureLoaded()
+    {
+        if (m_loaded) return;
+        m_loaded = true;
+        load();
+    }
+
+    // 读取缓存文件，格式不符时从空缓存开始
+    void load()
+    {
+        QFile file(m_path);
+        if (!file.open(QIODevice::ReadOnly) || file.size() < HEADER_SIZE) return;
+        const uchar *base = file.map(0, file.size());
+        if (!BinaryFormat::checkHeader(base, file.size(), "QMLR", VERSION, HEADER_SIZE)) return;
+
+        const uchar *p = base + HEADER_SIZE;
+        const uchar *end = base + file.size();
+        const quint32 count = BinaryFormat::headerField(base, 0);
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        for (quint32 i = 0; i < count; ++i) {
+            if (end - p < ENTRY_SIZE) break;
+            Entry entry;
+            entry.storedAt = qFromLittleEndian<qint64>(p);
+            entry.lastUsed = qFromLittleEndian<qint64>(p + 8);
+            const qint64 keyLength = qFromLittleEndian<quint32>(p + 16);
+            const qint64 textLength = qFromLittleEndian<quint32>(p + 20);
+            p += ENTRY_SIZE;
+            if (end - p < (keyLength + textLength) * 2) break;
+            const QString key = BinaryFormat::readUtf16(p, keyLength);
+            entry.lyricText = BinaryFormat::readUtf16(p, textLength);
+            if (expired(entry, now)) continue;
+            m_textUnits += entry.lyricText.size();
+            m_entries.insert(key, entry);
+        }
+        qDebug() << "歌词查询缓存已加载:" << m_entries.size() << "条";
+    }
+
+    void save()
+    {
+        m_saveTimer->stop();
+        m_touched = false;
+        QDir().mkpath(QFileInfo(m_path).absolutePath());
+        QSaveFile file(m_path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qDebug() << "无法写入歌词查询缓存:" << m_path;
+            return;
+        }
+
+        file.write(BinaryFormat::header("QMLR", VERSION, HEADER_SIZE, {static_cast<quint32>(m_entries.size())}));
+
+        QByteArray buffer;
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+            buffer.resize(ENTRY_SIZE);
+            uchar *out = reinterpret_cast<uchar *>(buffer.data());
+            qToLittleEndian<qint64>(it->storedAt, out);
+            qToLittleEndian<qint64>(it->lastUsed, out + 8);
+            qToLittleEndian<quint32>(static_cast<quint32>(it.key().size()), out + 16);
+            qToLittleEndian<quint32>(static_cast<quint32>(it->lyricText.size()), out + 20);
+            BinaryFormat::appendUtf16(buffer, it.key());
+            BinaryFormat::appendUtf16(buffer, it->lyricText);
+            file.write(buffer);
+        }
+        file.commit();
+    }
+};
+
+#endif // LYRICRESPONSECACHE_H
@@ -0,0 +1,234 @@
+#ifndef LYRICSEARCHDIALOG_H
+#define LYRICSEARCHDIALOG_H
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QListWidget>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QTimer>
+#include <QFileInfo>
+#include <QFileDialog>
+#include <QStandardPaths>
+#include "lyricsearchindex.h"
+
+// 歌词搜索对话框：边输入边搜索，双击结果跳转到该句播放
+class LyricSearchDialog : public QDialog
+{
+    Q_OBJECT
+
+private:
+    static const int DEBOUNCE_MS = 150;   // 输入停顿多久后发起查询
+
+    LyricSearchIndex *m_index;          // 搜索服务（由播放器持有）
+    QLineEdit *m_searchEdit;            // 搜索输入框
+    QListWidget *m_resultList;          // 搜索结果列表
+    QLabel *m_statusLabel;              // 状态标签
+    QLabel *m_progressLabel;            // 索引进度
+    QTimer *m_debounceTimer;            // 输入防抖
+    QList<LyricSearchHit> m_hits;       // 当前结果
+    quint64 m_generation = 0;           // 当前查询序号
+
+public:
+    explicit LyricSearchDialog(LyricSearchIndex *index, QWidget *parent = nullptr)
+        : QDialog(parent)
+        , m_index(index)
+    {
+        setWindowTitle("歌词搜索");
+        setMinimumSize(700, 500);
+        setupUI();
+
+        m_debounceTimer = new QTimer(this);
+        m_debounceTimer->setSingleShot(true);
+        m_debounceTimer->setInterval(DEBOUNCE_MS);
+        connect(m_debounceTimer, &QTimer::timeout, this, &LyricSearchDialog::onSearch);
+        connect(m_searchEdit, &QLineEdit::textChanged, m_debounceTimer, qOverload<>(&QTimer::start));
+        connect(m_searchEdit, &QLineEdit::returnPressed, this, &LyricSearchDialog::onSearch);
+
+        connect(m_index, &LyricSearchIndex::resultsReady, this, &LyricSearchDialog::onResults);
+        connect(m_index, &LyricSearchIndex::progress, this, &LyricSearchDialog::onProgress);
+        onProgress(m_index->indexedCount(), m_index->pendingCount());
+    }
+
+signals:
+    void hitSelected(const LyricSearchHit &hit);
+
+private:
+    void setupUI()
+    {
+        QVBoxLayout *mainLayout = new QVBoxLayout(this);
+        mainLayout->setSpacing(15);
+        mainLayout->setContentsMargins(20, 20, 20, 20);
+
+        // 与在线搜索对话框相同的样式
+        setStyleSheet(
+            "QDialog { "
+            "   background-color: #2b2b2b; "
+            "}"
+            "QLineEdit { "
+            "   background-color: #1e1e1e; "
+            "   color: #ffffff; "
+            "   border: 2px solid #444; "
+            "   border-radius: 8px; "
+            "   padding: 10px; "
+            "   font-size: 14pt; "
+            "}"
+            "QLineEdit:focus { "
+            "   border: 2px solid #64b5f6; "
+            "}"
+            "QPushButton { "
+            "   background-color: #0d47a1; "
+            "   color: white; "
+            "   border: none; "
+            "   padding: 10px 20px; "
+            "   border-radius: 8px; "
+            "   font-weight: bold; "
+            "   font-size: 12pt; "
+            "}"
+            "QPushButton:hover { "
+            "   background-color: #1565c0; "
+            "}"
+            "QPushButton:pressed { "
+            "   background-color: #0a3d91; "
+            "}"
+            "QListWidget { "
+            "   background-color: #1e1e1e; "
+            "   color: #ffffff; "
+            "   border: 2px solid #444; "
+            "   border-radius: 8px; "
+            "   padding: 5px; "
+            "   font-size: 11pt; "
+            "}"
+            "QListWidget::item { "
+            "   padding: 8px; "
+            "   border-bottom: 1px solid #333; "
+            "   border-radius: 4px; "
+            "}"
+            "QListWidget::item:hover { "
+            "   background-color: #3a3a3a; "
+            "}"
+            "QListWidget::item:selected { "
+            "   background-color: #0d47a1; "
+            "   color: white; "
+            "}"
+            "QLabel { "
+            "   color: #ffffff; "
+            "   font-size: 11pt; "
+            "}"
+        );
+
+        // 标题
+        QLabel *titleLabel = new QLabel("📝 歌词搜索", this);
+        titleLabel->setStyleSheet(
+            "font-size: 18pt; "
+            "font-weight: bold; "
+            "color: #64b5f6; "
+            "padding: 10px;"
+        );
+        titleLabel->setAlignment(Qt::AlignCenter);
+        mainLayout->addWidget(titleLabel);
+
+        m_searchEdit = new QLineEdit(this);
+        m_searchEdit->setPlaceholderText("输入一句歌词（至少两个字）...");
+        mainLayout->addWidget(m_searchEdit);
+
+        // 状态标签
+        m_statusLabel = new QLabel("输入歌词片段开始搜索", this);
+        m_statusLabel->setStyleSheet("color: #64b5f6; font-style: italic;");
+        m_statusLabel->setAlignment(Qt::AlignCenter);
+        mainLayout->addWidget(m_statusLabel);
+
+        // 结果列表
+        m_resultList = new QListWidget(this);
+        mainLayout->addWidget(m_resultList);
+
+        // 底部：索引进度与按钮
+        QHBoxLayout *buttonLayout = new QHBoxLayout();
+        m_progressLabel = new QLabel(this);
+        m_progressLabel->setStyleSheet("color: #888; font-size: 9pt;");
+        buttonLayout->addWidget(m_progressLabel);
+        buttonLayout->addStretch();
+
+        QPushButton *folderButton = new QPushButton("📁 索引文件夹", this);
+        QPushButton *playButton = new QPushButton("▶️ 跳转播放", this);
+        QPushButton *closeButton = new QPushButton("关闭", this);
+        buttonLayout->addWidget(folderButton);
+        buttonLayout->addWidget(playButton);
+        buttonLayout->addWidget(closeButton);
+        mainLayout->addLayout(buttonLayout);
+
+        connect(folderButton, &QPushButton::clicked, this, &LyricSearchDialog::onAddFolder);
+        connect(m_resultList, &QListWidget::itemDoubleClicked, this, &LyricSearchDialog::onPlaySelected);
+        connect(playButton, &QPushButton::clicked, this, &LyricSearchDialog::onPlaySelected);
+        connect(closeButton, &QPushButton::clicked, this, &QDialog::reject);
+    }
+
+    static QString formatTime(qint64 ms)
+    {
+        const qint64 seconds = ms / 1000;
+        return QString("%1:%2").arg(seconds / 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+    }
+
+private slots:
+    void onSearch()
+    {
+        m_debounceTimer->stop();
+        const QString query = m_searchEdit->text().trimmed();
+        if (LyricSearchWorker::normalize(query).size() < 2) {
+            m_generation = 0;
+            m_hits.clear();
+            m_resultList->clear();
+            m_statusLabel->setText("输入歌词片段开始搜索");
+            return;
+        }
+        m_generation = m_index->search(query);
+    }
+
+    void onResults(quint64 generation, const QList<LyricSearchHit> &hits, bool truncated, qint64 elapsedNs)
+    {
+        if (generation != m_generation) return;
+        m_hits = hits;
+        m_resultList->clear();
+        for (const LyricSearchHit &hit : hits) {
+            m_resultList->addItem(QString("%1  %2\n      %3")
+                                  .arg(formatTime(hit.timestamp), hit.text, QFileInfo(hit.audioPath).fileName()));
+        }
+        const QString elapsed = QString::number(elapsedNs / 1e6, 'f', 1);
+        if (truncated) {
+            m_statusLabel->setText(QString("至少找到 %1 句（未全部列出，用时 %2 ms），输入更长的片段可缩小范围")
+                                   .arg(hits.size()).arg(elapsed));
+        } else {
+            m_statusLabel->setText(QString("找到 %1 句，用时 %2 ms").arg(hits.size()).arg(elapsed));
+        }
+    }
+
+    // 把播放列表以外的音乐库目录加入索引
+    void onAddFolder()
+    {
+        const QString dir = QFileDialog::getExistingDirectory(this, "选择要索引的音乐文件夹",
+            QStandardPaths::writableLocation(QStandardPaths::MusicLocation));
+        if (dir.isEmpty()) return;
+        m_index->addDirectory(dir);
+    }
+
+    void onProgress(int indexed, int pending)
+    {
+        if (pending > 0) {
+            m_progressLabel->setText(QString("正在索引：已完成 %1 首，剩余 %2 首").arg(indexed).arg(pending));
+        } else {
+            m_progressLabel->setText(QString("已索引 %1 首").arg(indexed));
+        }
+    }
+
+    void onPlaySelected()
+    {
+        const int row = m_resultList->currentRow();
+        if (row < 0 || row >= m_hits.size()) return;
+        emit hitSelected(m_hits[row]);
+        accept();
+    }
+};
+
+#endif // LYRICSEARCHDIALOG_H
@@ -0,0 +1,608 @@
+#ifndef LYRICSEARCHINDEX_H
+#define LYRICSEARCHINDEX_H
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QStringList>
+#include <QCache>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include "lyricparser.h"
+#include "lyricfileindex.h"
+#include "binaryformat.h"
+
+// 一条歌词搜索结果
+struct LyricSearchHit
+{
+    QString audioPath;      // 音频文件
+    qint64 timestamp = 0;   // 匹配行的时间（毫秒）
+    QString text;           // 匹配行的原文
+};
+
+// 后台线程中的歌词全文索引
+// 文本先做兼容分解（全角转半角）、转小写并去掉空白与标点，再按相邻两字切分（二元组）建立倒排表：
+// 二元组 -> 按升序排列的文档号。中日韩文本不需要分词，英文也同样适用。
+// 查询时取查询串的全部二元组求交集得到候选文档，再读取候选歌词（经二进制缓存）逐行确认子串匹配；
+// 确认过的歌词留在内存中（按行数限量），边输入边搜索时后续查询不再读盘。
+// 候选太多、在时间上限内确认不完或结果超过上限时，结果标记为不完整，由界面提示。
+// 曲目来自播放列表与音乐库目录（递归扫描）；新曲目分批索引，每批之间让出事件循环以便查询插队；
+// 索引定期以小端二进制写入磁盘，启动时内存映射读回。
+class LyricSearchWorker : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const quint32 VERSION = 1;
+    static const int HEADER_SIZE = 16;
+    static const int BATCH_BUDGET_MS = 20;      // 每批索引的时间片
+    static const int SEARCH_BUDGET_MS = 40;     // 候选确认的时间上限
+    static const int SAVE_INTERVAL_MS = 60000;  // 索引过程中的保存间隔
+    static const int VERIFIED_CACHE_LINES = 200000; // 内存中保留的已确认歌词行数
+    static constexpr quint32 INVALID_ID = 0xFFFFFFFFu;
+
+    // 一个已索引的歌词文件
+    struct Document
+    {
+        QString audioPath;
+        QString lrcPath;
+        qint64 modified = 0;    // 歌词文件修改时间
+        qint64 size = 0;        // 歌词文件大小
+        bool alive = true;      // 被替换或删除后为 false（倒排表中的旧文档号在保存时清理）
+    };
+
+    // 读取过的候选歌词：原文与规范化后的文本
+    struct VerifiedLyrics
+    {
+        QList<LyricLine> lines;
+        QStringList normalized;
+    };
+
+    // 待扫描的目录
+    struct ScanRoot
+    {
+        QString path;
+        bool recursive;
+    };
+
+    const std::atomic<quint64> &m_latestQuery;  // 最新查询序号（由 LyricSearchIndex 写入）
+    QString m_indexPath;
+    LyricFileIndex *m_files = nullptr;          // 歌词文件查找（在工作线程中创建）
+
+    QVector<Document> m_docs;
+    QHash<QString, quint32> m_docByAudio;       // 音频路径 -> 文档号
+    QHash<quint32, QVector<quint32>> m_postings; // 二元组 -> 文档号（升序）
+    int m_deadDocs = 0;
+    QCache<quint32, VerifiedLyrics> m_verified; // 文档号 -> 歌词（开销为行数）
+
+    QList<ScanRoot> m_scanQueue;                // 待扫描的目录
+    QSet<QString> m_scannedRoots;               // 本次运行中已扫描过的目录
+    std::unique_ptr<QDirIterator> m_scan;       // 正在扫描的目录
+
+    QStringList m_pending;                      // 待索引的音频
+    QSet<QString> m_pendingSet;
+    int m_pendingHead = 0;
+    bool m_batchQueued = false;
+    bool m_dirty = false;
+    QElapsedTimer m_saveClock;
+
+public:
+    explicit LyricSearchWorker(const std::atomic<quint64> &latestQuery)
+        : m_latestQuery(latestQuery)
+        , m_verified(VERIFIED_CACHE_LINES)
+    {
+        m_indexPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/lyricsearch.idx";
+    }
+
+    // 规范化：兼容分解、转小写，只保留字母与数字
+    static QString normalize(const QString &text)
+    {
+        const QString decomposed = text.normalized(QString::NormalizationForm_KC);
+        QString result;
+        result.reserve(decomposed.size());
+        for (const QChar c : decomposed) {
+            if (c.isLetterOrNumber()) result.append(c.toLower());
+        }
+        return result;
+    }
+
+public slots:
+    void initialize()
+    {
+        m_files = new LyricFileIndex(this);
+        QElapsedTimer timer;
+        timer.start();
+        if (load()) {
+            qDebug() << "歌词搜索索引已加载:" << aliveCount() << "首，" << m_postings.size()
+                     << "个二元组，耗时" << timer.elapsed() << "ms";
+        }
+        m_saveClock.start();
+        emit progress(aliveCount(), 0);
+    }
+
+    // 加入待索引的曲目（已索引且歌词文件未变化的会被跳过）
+    void addTracks(const QStringList &audioPaths)
+    {
+        for (const QString &path : audioPaths) enqueue(path);
+        scheduleBatch();
+    }
+
+    // 扫描目录中的音频文件并加入索引（分批进行，同一目录本次运行只扫描一次）
+    void addDirectory(const QString &dirPath, bool recursive)
+    {
+        const QString path = QDir(dirPath).absolutePath();
+        if (m_scannedRoots.contains(path) || !QFileInfo(path).isDir()) return;
+        m_scannedRoots.insert(path);
+        m_scanQueue.append(ScanRoot{path, recursive});
+        scheduleBatch();
+    }
+
+    void search(const QString &query, quint64 generation, int limit)
+    {
+        // 输入过程中积压的旧查询直接跳过
+        if (generation != m_latestQuery.load(std::memory_order_acquire)) return;
+
+        QElapsedTimer timer;
+        timer.start();
+        QList<LyricSearchHit> hits;
+        bool truncated = false;     // 还有更多结果或候选没有确认完
+
+        const QString needle = normalize(query);
+        const QVector<quint32> candidates = candidatesFor(needle);
+        for (quint32 id : candidates) {
+            if (timer.elapsed() > SEARCH_BUDGET_MS) {
+                truncated = true;
+                break;
+            }
+            if (!m_docs[id].alive) continue;
+
+            const VerifiedLyrics *lyrics = verifiedLyrics(id);
+            if (!lyrics) continue;
+            for (int i = 0; i < lyrics->lines.size() && !truncated; ++i) {
+                if (!lyrics->normalized[i].contains(needle)) continue;
+                if (hits.size() >= limit) {
+                    truncated = true;
+                } else {
+                    hits.append(LyricSearchHit{m_docs[id].audioPath, lyrics->lines[i].timestamp, lyrics->lines[i].text});
+                }
+            }
+            if (truncated) break;
+        }
+
+        emit searchFinished(generation, hits, truncated, timer.nsecsElapsed());
+    }
+
+signals:
+    void searchFinished(quint64 generation, const QList<LyricSearchHit> &hits, bool truncated, qint64 elapsedNs);
+    void progress(int indexed, int pending);
+
+private slots:
+    // 处理一批待索引曲目，用完时间片后让出事件循环
+    void processBatch()
+    {
+        m_batchQueued = false;
+        QElapsedTimer timer;
+        timer.start();
+        while (timer.elapsed() < BATCH_BUDGET_MS) {
+            if (m_pendingHead < m_pending.size()) {
+                const QString path = m_pending[m_pendingHead++];
+                m_pendingSet.remove(path);
+                indexTrack(path);
+            } else if (!scanNext()) {
+                break;
+            }
+        }
+
+        const int remaining = m_pending.size() - m_pendingHead;
+        emit progress(aliveCount(), remaining);
+
+        if (remaining > 0 || hasScanWork()) {
+            if (m_dirty && m_saveClock.elapsed() > SAVE_INTERVAL_MS) save();
+            scheduleBatch();
+        } else {
+            m_pending.clear();
+            m_pendingHead = 0;
+            if (m_dirty) save();
+        }
+    }
+
+private:
+    void scheduleBatch()
+    {
+        if (m_batchQueued || (m_pendingHead >= m_pending.size() && !hasScanWork())) return;
+        m_batchQueued = true;
+        QMetaObject::invokeMethod(this, &LyricSearchWorker::processBatch, Qt::QueuedConnection);
+    }
+
+    void enqueue(const QString &audioPath)
+    {
+        if (m_pendingSet.contains(audioPath)) return;
+        m_pendingSet.insert(audioPath);
+        m_pending.append(audioPath);
+    }
+
+    bool hasScanWork() const { return m_scan || !m_scanQueue.isEmpty(); }
+
+    // 从正在扫描的目录取出下一个音频文件加入待索引队列，没有可扫描的目录时返回 false
+    bool scanNext()
+    {
+        static const QStringList AUDIO_FILTERS = {"*.mp3", "*.wav", "*.flac", "*.ogg", "*.m4a", "*.aac"};
+        while (true) {
+            if (!m_scan) {
+                if (m_scanQueue.isEmpty()) return false;
+                const ScanRoot root = m_scanQueue.takeFirst();
+                m_scan.reset(new QDirIterator(root.path, AUDIO_FILTERS, QDir::Files,
+                                              root.recursive ? QDirIterator::Subdirectories
+                                                             : QDirIterator::NoIteratorFlags));
+            }
+            if (m_scan->hasNext()) {
+                enqueue(m_scan->next());
+                return true;
+            }
+            m_scan.reset();
+        }
+    }
+
+    // 取得候选文档的歌词（先查内存，再经二进制缓存读取）
+    const VerifiedLyrics *verifiedLyrics(quint32 id)
+    {
+        if (const VerifiedLyrics *cached = m_verified.object(id)) return cached;
+
+        VerifiedLyrics *lyrics = new VerifiedLyrics;
+        lyrics->lines = LyricParser::loadLrcFile(m_docs[id].lrcPath);
+        lyrics->normalized.reserve(lyrics->lines.size());
+        for (const LyricLine &line : std::as_const(lyrics->lines)) {
+            lyrics->normalized.append(normalize(line.text));
+        }
+        const qsizetype cost = qMax<qsizetype>(1, lyrics->lines.size());
+        // 超过总开销时 QCache 不保存并直接删除对象，此时无法返回
+        if (cost > m_verified.maxCost()) {
+            delete lyrics;
+            return nullptr;
+        }
+        m_verified.insert(id, lyrics, cost);
+        return lyrics;
+    }
+
+    int aliveCount() const { return m_docs.size() - m_deadDocs; }
+
+    static quint32 gramKey(const QChar a, const QChar b)
+    {
+        return (quint32(a.unicode()) << 16) | b.unicode();
+    }
+
+    // 取查询串所有二元组的倒排表求交集；查询不足两字时没有结果
+    QVector<quint32> candidatesFor(const QString &needle) const
+    {
+        if (needle.size() < 2) return {};
+
+        QVector<const QVector<quint32> *> lists;
+        QSet<quint32> seen;
+        for (int i = 0; i + 1 < needle.size(); ++i) {
+            const quint32 key = gramKey(needle[i], needle[i + 1]);
+            if (seen.contains(key)) continue;
+            seen.insert(key);
+            auto it = m_postings.constFind(key);
+            if (it == m_postings.constEnd()) return {};
+            lists.append(&it.value());
+        }
+
+        // 从最短的表开始，交集只会越来越小
+        std::sort(lists.begin(), lists.end(), [](const QVector<quint32> *a, const QVector<quint32> *b) {
+            return a->size() < b->size();
+        });
+        QVector<quint32> result = *lists.first();
+        QVector<quint32> scratch;
+        for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+            scratch.resize(qMin(result.size(), lists[i]->size()));
+            auto end = std::set_intersection(result.cbegin(), result.cend(),
+                                             lists[i]->cbegin(), lists[i]->cend(), scratch.begin());
+            scratch.resize(end - scratch.begin());
+            result.swap(scratch);
+        }
+        return result;
+    }
+
+    // 索引一首曲目：歌词文件未变化时跳过，变化或消失时作废旧文档
+    void indexTrack(const QString &audioPath)
+    {
+        const QString lrcPath = m_files->find(audioPath);
+        auto existing = m_docByAudio.constFind(audioPath);
+
+        qint64 modified = 0, size = 0;
+        if (!lrcPath.isEmpty()) {
+            const QFileInfo info(lrcPath);
+            modified = info.lastModified().toMSecsSinceEpoch();
+            size = info.size();
+        }
+
+        if (existing != m_docByAudio.constEnd()) {
+            const Document &doc = m_docs[existing.value()];
+            if (doc.lrcPath == lrcPath && doc.modified == modified && doc.size == size) return;
+            retire(existing.value());
+        }
+        if (lrcPath.isEmpty()) return;
+
+        const QList<LyricLine> lyrics = LyricParser::loadLrcFile(lrcPath);
+        if (lyrics.isEmpty()) return;
+
+        const quint32 id = static_cast<quint32>(m_docs.size());
+        Document doc;
+        doc.audioPath = audioPath;
+        doc.lrcPath = lrcPath;
+        doc.modified = modified;
+        doc.size = size;
+        m_docs.append(doc);
+        m_docByAudio.insert(audioPath, id);
+
+        QSet<quint32> grams;
+        for (const LyricLine &line : lyrics) {
+            const QString text = normalize(line.text);
+            for (int i = 0; i + 1 < text.size(); ++i) {
+                grams.insert(gramKey(text[i], text[i + 1]));
+            }
+        }
+        // 新文档号总是最大的，追加后倒排表仍然有序
+        for (quint32 key : grams) {
+            m_postings[key].append(id);
+        }
+        m_dirty = true;
+    }
+
+    void retire(quint32 id)
+    {
+        Document &doc = m_docs[id];
+        if (!doc.alive) return;
+        doc.alive = false;
+        ++m_deadDocs;
+        m_verified.remove(id);
+        m_docByAudio.remove(doc.audioPath);
+        m_dirty = true;
+    }
+
+    // 清理作废文档：重新编号并从倒排表中删除
+    void compact()
+    {
+        if (m_deadDocs == 0) return;
+        QVector<quint32> remap(m_docs.size(), INVALID_ID);
+        QVector<Document> docs;
+        docs.reserve(aliveCount());
+        for (int i = 0; i < m_docs.size(); ++i) {
+            if (!m_docs[i].alive) continue;
+            remap[i] = static_cast<quint32>(docs.size());
+            docs.append(m_docs[i]);
+        }
+
+        for (auto it = m_postings.begin(); it != m_postings.end();) {
+            QVector<quint32> &ids = it.value();
+            int out = 0;
+            for (quint32 id : ids) {
+                if (remap[id] != INVALID_ID) ids[out++] = remap[id];
+            }
+            ids.resize(out);
+            if (ids.isEmpty()) {
+                it = m_postings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        m_docs = docs;
+        m_docByAudio.clear();
+        for (int i = 0; i < m_docs.size(); ++i) {
+            m_docByAudio.insert(m_docs[i].audioPath, static_cast<quint32>(i));
+        }
+        m_deadDocs = 0;
+        m_verified.clear();     // 文档号已变化
+    }
+
+    // 索引文件格式（小端）：
+    //   "QMLS" | quint32 版本 | quint32 文档数 | quint32 二元组数
+    //   | 文档[文档数]：qint64 修改时间 | qint64 大小 | quint32 音频路径长度 | quint32 歌词路径长度 | UTF-16 路径…
+    //   | 倒排表[二元组数]：quint32 二元组 | quint32 文档数 | quint32 文档号[…]
+    bool save()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        compact();
+
+        QDir().mkpath(QFileInfo(m_indexPath).absolutePath());
+        QSaveFile file(m_indexPath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qDebug() << "无法写入歌词搜索索引:" << m_indexPath;
+            return false;
+        }
+
+        file.write(BinaryFormat::header("QMLS", VERSION, HEADER_SIZE,
+                                        {static_cast<quint32>(m_docs.size()), static_cast<quint32>(m_postings.size())}));
+
+        QByteArray buffer;
+        for (const Document &doc : m_docs) {
+            uchar fields[24];
+            qToLittleEndian<qint64>(doc.modified, fields);
+            qToLittleEndian<qint64>(doc.size, fields + 8);
+            qToLittleEndian<quint32>(static_cast<quint32>(doc.audioPath.size()), fields + 16);
+            qToLittleEndian<quint32>(static_cast<quint32>(doc.lrcPath.size()), fields + 20);
+            buffer.append(reinterpret_cast<const char *>(fields), sizeof(fields));
+            BinaryFormat::appendUtf16(buffer, doc.audioPath);
+            BinaryFormat::appendUtf16(buffer, doc.lrcPath);
+        }
+        file.write(buffer);
+
+        for (auto it = m_postings.cbegin(); it != m_postings.cend(); ++it) {
+            const QVector<quint32> &ids = it.value();
+            buffer.resize(8 + ids.size() * 4);
+            uchar *out = reinterpret_cast<uchar *>(buffer.data());
+            qToLittleEndian<quint32>(it.key(), out);
+            qToLittleEndian<quint32>(static_cast<quint32>(ids.size()), out + 4);
+            qToLittleEndian<quint32>(ids.constData(), ids.size(), out + 8);
+            file.write(buffer);
+        }
+
+        if (!file.commit()) return false;
+        m_dirty = false;
+        m_saveClock.restart();
+        qDebug() << "歌词搜索索引已保存:" << m_docs.size() << "首，耗时" << timer.elapsed() << "ms";
+        return true;
+    }
+
+    // 映射索引文件读回；格式不符时从空索引开始
+    bool load()
+    {
+        QFile file(m_indexPath);
+        if (!file.open(QIODevice::ReadOnly) || file.size() < HEADER_SIZE) return false;
+        const uchar *base = file.map(0, file.size());
+        if (!BinaryFormat::checkHeader(base, file.size(), "QMLS", VERSION, HEADER_SIZE)) return false;
+
+        const uchar *p = base + HEADER_SIZE;
+        const uchar *end = base + file.size();
+        const quint32 docCount = BinaryFormat::headerField(base, 0);
+        const quint32 gramCount = BinaryFormat::headerField(base, 1);
+
+        QVector<Document> docs;
+        docs.reserve(docCount);
+        for (quint32 i = 0; i < docCount; ++i) {
+            if (end - p < 24) return false;
+            Document doc;
+            doc.modified = qFromLittleEndian<qint64>(p);
+            doc.size = qFromLittleEndian<qint64>(p + 8);
+            const qint64 audioLength = qFromLittleEndian<quint32>(p + 16);
+            const qint64 lrcLength = qFromLittleEndian<quint32>(p + 20);
+            p += 24;
+            if (end - p < (audioLength + lrcLength) * 2) return false;
+            doc.audioPath = BinaryFormat::readUtf16(p, audioLength);
+            doc.lrcPath = BinaryFormat::readUtf16(p, lrcLength);
+            docs.append(doc);
+        }
+
+        QHash<quint32, QVector<quint32>> postings;
+        postings.reserve(gramCount);
+        for (quint32 i = 0; i < gramCount; ++i) {
+            if (end - p < 8) return false;
+            const quint32 key = qFromLittleEndian<quint32>(p);
+            const qint64 count = qFromLittleEndian<quint32>(p + 4);
+            p += 8;
+            if (end - p < count * 4) return false;
+            QVector<quint32> ids(count);
+            qFromLittleEndian<quint32>(p, count, ids.data());
+            p += count * 4;
+            postings.insert(key, ids);
+        }
+
+        m_docs = docs;
+        m_postings = postings;
+        m_deadDocs = 0;
+        m_verified.clear();
+        m_docByAudio.clear();
+        for (int i = 0; i < m_docs.size(); ++i) {
+            m_docByAudio.insert(m_docs[i].audioPath, static_cast<quint32>(i));
+        }
+        return true;
+    }
+};
+
+// 歌词全文搜索服务：索引与查询都在后台线程进行
+// 每次查询递增序号，输入过程中被取代的查询不执行，结果也不返回
+class LyricSearchIndex : public QObject
+{
+    Q_OBJECT
+
+private:
+    QThread m_thread;
+    LyricSearchWorker *m_worker;
+    std::atomic<quint64> m_generation{0};   // 最新查询序号
+    int m_indexed = 0;                      // 最近一次上报的索引进度
+    int m_pending = 0;
+
+public:
+    static const int DEFAULT_LIMIT = 100;   // 默认最多返回的结果数
+
+    explicit LyricSearchIndex(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+        qRegisterMetaType<QList<LyricSearchHit>>("QList<LyricSearchHit>");
+
+        m_worker = new LyricSearchWorker(m_generation);
+        m_worker->moveToThread(&m_thread);
+        connect(&m_thread, &QThread::started, m_worker, &LyricSearchWorker::initialize);
+        connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+        connect(m_worker, &LyricSearchWorker::searchFinished, this, &LyricSearchIndex::onSearchFinished);
+        connect(m_worker, &LyricSearchWorker::progress, this, &LyricSearchIndex::onProgress);
+        m_thread.setObjectName("LyricSearchIndex");
+        m_thread.start(QThread::LowPriority);
+    }
+
+    ~LyricSearchIndex()
+    {
+        m_generation.fetch_add(1, std::memory_order_acq_rel);
+        m_thread.quit();
+        m_thread.wait();
+    }
+
+    // 把曲目加入索引（后台分批处理，已索引且歌词未变化的跳过）
+    void addTracks(const QStringList &audioPaths)
+    {
+        if (audioPaths.isEmpty()) return;
+        QMetaObject::invokeMethod(m_worker, [worker = m_worker, audioPaths]() {
+            worker->addTracks(audioPaths);
+        }, Qt::QueuedConnection);
+    }
+
+    // 把目录中的音频加入索引（音乐库根目录递归扫描）
+    void addDirectory(const QString &dirPath, bool recursive = true)
+    {
+        if (dirPath.isEmpty()) return;
+        QMetaObject::invokeMethod(m_worker, [worker = m_worker, dirPath, recursive]() {
+            worker->addDirectory(dirPath, recursive);
+        }, Qt::QueuedConnection);
+    }
+
+    // 搜索歌词片段，返回本次查询的序号；结果通过 resultsReady 返回
+    quint64 search(const QString &query, int limit = DEFAULT_LIMIT)
+    {
+        const quint64 generation = m_generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+        QMetaObject::invokeMethod(m_worker, [worker = m_worker, query, generation, limit]() {
+            worker->search(query, generation, limit);
+        }, Qt::QueuedConnection);
+        return generation;
+    }
+
+    // 已索引的曲目数与待索引数
+    int indexedCount() const { return m_indexed; }
+    int pendingCount() const { return m_pending; }
+
+signals:
+    // truncated 为 true 时还有更多匹配（超过结果上限，或候选太多未在时间上限内确认完）
+    void resultsReady(quint64 generation, const QList<LyricSearchHit> &hits, bool truncated, qint64 elapsedNs);
+    void progress(int indexed, int pending);
+
+private slots:
+    void onSearchFinished(quint64 generation, const QList<LyricSearchHit> &hits, bool truncated, qint64 elapsedNs)
+    {
+        if (generation != m_generation.load(std::memory_order_acquire)) return;
+        emit resultsReady(generation, hits, truncated, elapsedNs);
+    }
+
+    void onProgress(int indexed, int pending)
+    {
+        m_indexed = indexed;
+        m_pending = pending;
+        emit progress(indexed, pending);
+    }
+};
+
+#endif // LYRICSEARCHINDEX_H
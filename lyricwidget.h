@@ -2,260 +2,621 @@
 #define LYRICWIDGET_H
 
 #include <QWidget>
-#include <QLabel>
-#include <QVBoxLayout>
-#include <QScrollArea>
 #include <QPainter>
-#include <QPropertyAnimation>
-#include <QGraphicsOpacityEffect>
+#include <QPaintEvent>
+#include <QTextLayout>
+#include <QGlyphRun>
+#include <QVariantAnimation>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
 #include <QDebug>
+#include <QHash>
+#include <QSharedPointer>
+#include <QEasingCurve>
+#include <cmath>
+#include <QPainterPath>
+#include <algorithm>
+#include <climits>
+#include "positionclock.h"
+
+// 逐字时间（增强型 LRC 的 <mm:ss.xx> 标签）
+struct LyricWord
+{
+    qint64 timestamp;  // 开始时间（毫秒）
+    int start;         // 在行文本中的起始位置（UTF-16）
+    int length;        // 字符数，0 表示结束标记
+};
 
 // 单行歌词结构
 struct LyricLine
 {
     qint64 timestamp;  // 时间戳（毫秒）
     QString text;      // 歌词文本
-    
+    QVector<LyricWord> words;  // 逐字时间，普通 LRC 为空
+
     LyricLine(qint64 time = 0, const QString& lyric = "")
         : timestamp(time), text(lyric) {}
 };
 
 // 歌词显示组件
+// 自绘多行滚动歌词：当前行居中放大高亮，上下各显示若干行，换行时连续滚动过去。
+// 每行只在首次可见时按统一字号排版并缓存字形，之后的滚动、放大与逐字高亮都只改变绘制变换和裁剪区域；
+// 离开可见范围的行释放排版缓存，内存与排版开销只和可见行数有关，与歌词总长度无关。
 class LyricWidget : public QWidget
 {
     Q_OBJECT
-    
+
+    friend class TestLyricWidget;           // 基准测试直接调用查找与定位滚动位置
+
 private:
+    // 单词在排版结果中的位置
+    struct WordSpan
+    {
+        int textLine;   // 所在的排版行
+        qreal x0;       // 起点 x
+        qreal x1;       // 终点 x
+    };
+
+    // 一行歌词的排版缓存
+    struct LineLayout
+    {
+        QTextLayout layout;
+        QList<QGlyphRun> glyphRuns;         // 缓存的字形
+        QVector<WordSpan> wordSpans;        // 逐字高亮用
+        QSizeF size;                        // 排版尺寸（未缩放）
+    };
+
     QList<LyricLine> m_lyrics;           // 歌词列表
     int m_currentLineIndex;              // 当前歌词行索引
-    qint64 m_currentPosition;            // 当前播放位置（毫秒）
-    
-    // UI组件
-    QLabel* m_prevLine;                  // 上一行歌词
-    QLabel* m_currentLine;               // 当前行歌词
-    QLabel* m_nextLine;                  // 下一行歌词
-    QLabel* m_noLyricLabel;              // 无歌词提示
-    
-    QPropertyAnimation* m_fadeAnimation; // 淡入淡出动画
-    
+    PositionClock m_clock;               // 插值后的播放位置（已扣除输出延迟）
+
+    // 绘制
+    static const int OUTER_MARGIN = 20;  // 外边距
+    static const int INNER_MARGIN_X = 30; // 歌词框内水平边距
+    static const int LINE_SPACING = 16;  // 行间距
+    static const int CURRENT_PADDING = 10; // 当前行高亮背景的内边距
+    static const int BASE_POINT_SIZE = 15; // 排版字号
+    static constexpr qreal CURRENT_SCALE = 1.3; // 当前行放大倍数
+    static const int CACHE_MARGIN = 2;   // 可见范围外额外保留的排版行数
+    QHash<int, QSharedPointer<LineLayout>> m_layouts; // 行号 -> 排版缓存（仅可见行附近）
+    int m_layoutWidth;                   // 排版宽度，变化时清空缓存
+    QRect m_currentRect;                 // 当前行的绘制区域（逐字高亮只重绘这里）
+
+    // 滚动动画：m_scrollPos 为居中的（小数）行号
+    static const int MAX_SCROLL_LINES = 3;   // 跨越更多行（跳转）时直接定位
+    QVariantAnimation* m_scrollAnimation;
+    double m_scrollPos;
+
+    // 节拍同步：滚动在下一拍处结束
+    static const int DEFAULT_SCROLL_MS = 300;    // 无节拍信息时的滚动时长
+    static const int MIN_SCROLL_MS = 150;        // 最短滚动时长
+    static const int MAX_CURSOR_STEPS = 4;   // 顺序推进的最大步数，超过则按跳转处理
+    QElapsedTimer m_beatClock;           // 距最近一拍的时间
+    double m_beatPeriodMs;               // 节拍周期，0 表示未知
+
+    // 逐字高亮：按插值时钟 60fps 刷新当前行
+    static const int SWEEP_INTERVAL = 16;        // 刷新间隔
+    static const int LAST_WORD_MS = 1500;        // 没有结束标记时最后一个字的最长时长
+    QTimer* m_sweepTimer;                // 逐字高亮刷新定时器
+    QTimer* m_lineTimer;                 // 在下一行的时间点触发换行（不依赖位置上报的频率）
+
+    // 帧统计
+    QElapsedTimer m_fpsClock;            // 帧率统计计时
+    int m_frameCount;                    // 统计周期内的绘制帧数
+    double m_effectiveFps;               // 实际绘制帧率
+    qint64 m_lastPaintNs;                // 最近一帧绘制耗时
+    double m_averagePaintNs;             // 平滑后的平均绘制耗时
+
 public:
     explicit LyricWidget(QWidget* parent = nullptr)
         : QWidget(parent)
         , m_currentLineIndex(-1)
-        , m_currentPosition(0)
+        , m_layoutWidth(0)
+        , m_scrollPos(-1.0)
+        , m_beatPeriodMs(0.0)
+        , m_frameCount(0)
+        , m_effectiveFps(0.0)
+        , m_lastPaintNs(0)
+        , m_averagePaintNs(0.0)
     {
-        setupUI();
+        m_scrollAnimation = new QVariantAnimation(this);
+        m_scrollAnimation->setEasingCurve(QEasingCurve::OutCubic);
+        connect(m_scrollAnimation, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) {
+            m_scrollPos = value.toDouble();
+            update();
+        });
+        connect(m_scrollAnimation, &QVariantAnimation::finished, this, &LyricWidget::updateFrameStats);
+
+        m_sweepTimer = new QTimer(this);
+        m_sweepTimer->setInterval(SWEEP_INTERVAL);
+        m_sweepTimer->setTimerType(Qt::PreciseTimer);
+        connect(m_sweepTimer, &QTimer::timeout, this, &LyricWidget::onSweepTick);
+
+        m_lineTimer = new QTimer(this);
+        m_lineTimer->setSingleShot(true);
+        m_lineTimer->setTimerType(Qt::PreciseTimer);
+        connect(m_lineTimer, &QTimer::timeout, this, &LyricWidget::refresh);
+
+        setAttribute(Qt::WA_OpaquePaintEvent, false);
     }
-    
+
     // 设置歌词列表
     void setLyrics(const QList<LyricLine>& lyrics)
     {
         m_lyrics = lyrics;
         m_currentLineIndex = -1;
-        m_currentPosition = 0;
-        
-        if (m_lyrics.isEmpty()) {
-            showNoLyric();
-        } else {
-            hideNoLyric();
-            updateDisplay();
-        }
+        m_scrollAnimation->stop();
+        m_scrollPos = -1.0;
+        m_layouts.clear();
+        refresh();
+        update();
     }
-    
+
     // 清空歌词
     void clear()
     {
         m_lyrics.clear();
         m_currentLineIndex = -1;
-        m_currentPosition = 0;
-        showNoLyric();
+        m_scrollAnimation->stop();
+        m_scrollPos = -1.0;
+        m_sweepTimer->stop();
+        m_lineTimer->stop();
+        m_layouts.clear();
+        updateFrameStats();
+        update();
     }
-    
-    // 更新播放位置
+
+    // 输出延迟补偿（毫秒），蓝牙等高延迟设备上让歌词与听到的声音对齐
+    void setLatency(int ms)
+    {
+        m_clock.setLatency(ms);
+        refresh();
+    }
+
+    int latency() const { return m_clock.latency(); }
+
+    // 插值时钟（供调试与测量换行误差）
+    const PositionClock &clock() const { return m_clock; }
+
+    // 实际绘制帧率（动画期间每秒统计一次，静止时为 0）
+    double effectiveFps() const { return m_effectiveFps; }
+
+    // 最近一帧 / 平均每帧绘制耗时（纳秒）
+    qint64 lastPaintCostNs() const { return m_lastPaintNs; }
+    double averagePaintCostNs() const { return m_averagePaintNs; }
+
+    // 当前缓存的排版行数（只与可见行数有关）
+    int cachedLayoutCount() const { return m_layouts.size(); }
+
+signals:
+    void effectiveFpsChanged(double fps);
+
+public slots:
+    // 更新播放位置（QMediaPlayer::positionChanged）
     void updatePosition(qint64 position)
     {
-        m_currentPosition = position;
-        
-        if (m_lyrics.isEmpty()) return;
-        
-        // 查找当前应该显示的歌词行
-        int newIndex = findCurrentLine(position);
-        
-        if (newIndex != m_currentLineIndex && newIndex >= 0) {
-            m_currentLineIndex = newIndex;
-            updateDisplay();
-            animateCurrentLine();
+        m_clock.report(position);
+        refresh();
+    }
+
+    // 播放状态变化：暂停时时钟停止外推
+    void setPlaying(bool playing)
+    {
+        m_clock.setRunning(playing);
+        refresh();
+    }
+
+    // 播放速率变化
+    void setPlaybackRate(qreal rate)
+    {
+        m_clock.setRate(rate);
+        refresh();
+    }
+
+    // 接收节拍（来自 SpectrumWidget::beatDetected）
+    void onBeat(float strength, double bpm)
+    {
+        Q_UNUSED(strength);
+        m_beatPeriodMs = bpm > 0.0 ? 60000.0 / bpm : 0.0;
+        m_beatClock.restart();
+    }
+
+protected:
+    void resizeEvent(QResizeEvent *event) override
+    {
+        QWidget::resizeEvent(event);
+        update();
+    }
+
+    void paintEvent(QPaintEvent *event) override
+    {
+        Q_UNUSED(event);
+        QElapsedTimer paintTimer;
+        paintTimer.start();
+        ++m_frameCount;
+        sampleFps();
+
+        QPainter painter(this);
+        painter.setRenderHint(QPainter::Antialiasing);
+
+        // 歌词框
+        const QRectF box = QRectF(rect()).adjusted(OUTER_MARGIN, OUTER_MARGIN, -OUTER_MARGIN, -OUTER_MARGIN);
+        QLinearGradient gradient(box.topLeft(), box.bottomLeft());
+        gradient.setColorAt(0, QColor(13, 71, 161, 26));
+        gradient.setColorAt(1, QColor(21, 101, 192, 13));
+        painter.setPen(QPen(QColor(100, 181, 246, 77), 2));
+        painter.setBrush(gradient);
+        painter.drawRoundedRect(box, 15, 15);
+
+        if (m_lyrics.isEmpty()) {
+            QFont hintFont = font();
+            hintFont.setPointSize(18);
+            hintFont.setBold(true);
+            painter.setFont(hintFont);
+            painter.setPen(QColor(255, 255, 255, 128));
+            painter.drawText(box, Qt::AlignCenter, "🎵 暂无歌词");
+            m_currentRect = QRect();
+            recordPaintCost(paintTimer.nsecsElapsed());
+            return;
         }
+
+        // 放大后的当前行也要放得下
+        const int width = qMax(1, static_cast<int>((box.width() - 2 * INNER_MARGIN_X) / CURRENT_SCALE));
+        if (width != m_layoutWidth) {
+            m_layouts.clear();
+            m_layoutWidth = width;
+        }
+
+        QPainterPath clipPath;
+        clipPath.addRoundedRect(box, 15, 15);
+        painter.setClipPath(clipPath);
+
+        // 居中的小数行号 f：行 base 的中心在 f 从 base 走到 base+1 的过程中向上移动一个行距
+        const double f = m_scrollPos;
+        const int base = static_cast<int>(std::floor(f));
+        const double frac = f - base;
+        const qreal centerY = box.center().y();
+        const qreal baseY = centerY - frac * centerDistance(base, base + 1, f);
+
+        // 自中心向上、向下逐行放置，直到超出歌词框
+        int first = base;
+        int last = base;
+        m_currentRect = QRect();
+        drawLine(painter, box, base, baseY, f);
+        for (qreal y = baseY; ; --first) {
+            y -= centerDistance(first - 1, first, f);
+            if (first - 1 < 0 || y + extent(first - 1, f) / 2 < box.top()) break;
+            drawLine(painter, box, first - 1, y, f);
+        }
+        for (qreal y = baseY; ; ++last) {
+            y += centerDistance(last, last + 1, f);
+            if (last + 1 >= m_lyrics.size() || y - extent(last + 1, f) / 2 > box.bottom()) break;
+            drawLine(painter, box, last + 1, y, f);
+        }
+
+        // 释放可见范围外的排版缓存
+        for (auto it = m_layouts.begin(); it != m_layouts.end();) {
+            if (it.key() < first - CACHE_MARGIN || it.key() > last + CACHE_MARGIN) {
+                it = m_layouts.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        recordPaintCost(paintTimer.nsecsElapsed());
     }
-    
+
 private:
-    void setupUI()
+    // 查找当前时间对应的歌词行（最后一个时间戳 <= position 的行，歌词已按时间排序）
+    // 正常播放时从上次的行号向后推进几步即可命中；推进不到（跳转）时二分查找
+    int findCurrentLine(qint64 position) const
+    {
+        const int count = m_lyrics.size();
+        if (count == 0 || position < m_lyrics.first().timestamp) return -1;
+
+        int index = m_currentLineIndex;
+        if (index >= 0 && index < count && m_lyrics[index].timestamp <= position) {
+            for (int step = 0; step < MAX_CURSOR_STEPS; ++step) {
+                if (index + 1 >= count || m_lyrics[index + 1].timestamp > position) {
+                    return index;
+                }
+                ++index;
+            }
+        }
+
+        auto it = std::upper_bound(m_lyrics.cbegin(), m_lyrics.cend(), position,
+                                   [](qint64 value, const LyricLine &line) {
+                                       return value < line.timestamp;
+                                   });
+        return static_cast<int>(it - m_lyrics.cbegin()) - 1;
+    }
+
+    bool currentHasWords() const
+    {
+        return m_currentLineIndex >= 0 && m_currentLineIndex < m_lyrics.size()
+               && !m_lyrics[m_currentLineIndex].words.isEmpty();
+    }
+
+    // 行 index 的突出程度：居中时为 1，距中心一行及以上为 0
+    static double emphasis(int index, double f)
+    {
+        return qMax(0.0, 1.0 - std::fabs(index - f));
+    }
+
+    // 行 index 在当前缩放下的高度（不存在的行按空行计）
+    qreal extent(int index, double f)
     {
-        QVBoxLayout* mainLayout = new QVBoxLayout(this);
-        mainLayout->setContentsMargins(20, 20, 20, 20);
-        mainLayout->setSpacing(15);
-        
-        // 创建歌词显示区域
-        QWidget* lyricContainer = new QWidget(this);
-        lyricContainer->setStyleSheet(
-            "QWidget { "
-            "   background: qlineargradient(x1:0, y1:0, x2:0, y2:1, "
-            "       stop:0 rgba(13, 71, 161, 0.1), "
-            "       stop:1 rgba(21, 101, 192, 0.05)); "
-            "   border-radius: 15px; "
-            "   border: 2px solid rgba(100, 181, 246, 0.3); "
-            "}"
-        );
-        
-        QVBoxLayout* lyricLayout = new QVBoxLayout(lyricContainer);
-        lyricLayout->setContentsMargins(30, 40, 30, 40);
-        lyricLayout->setSpacing(20);
-        lyricLayout->setAlignment(Qt::AlignCenter);
-        
-        // 上一行歌词
-        m_prevLine = new QLabel(lyricContainer);
-        m_prevLine->setAlignment(Qt::AlignCenter);
-        m_prevLine->setWordWrap(true);
-        m_prevLine->setMinimumWidth(600);
-        m_prevLine->setStyleSheet(
-            "QLabel { "
-            "   color: rgba(255, 255, 255, 0.4); "
-            "   font-size: 14pt; "
-            "   font-weight: normal; "
-            "   padding: 5px; "
-            "}"
-        );
-        lyricLayout->addWidget(m_prevLine);
-        
-        // 当前行歌词（高亮）
-        m_currentLine = new QLabel(lyricContainer);
-        m_currentLine->setAlignment(Qt::AlignCenter);
-        m_currentLine->setWordWrap(true);
-        m_currentLine->setMinimumWidth(600);
-        m_currentLine->setStyleSheet(
-            "QLabel { "
-            "   color: #64b5f6; "
-            "   font-size: 20pt; "
-            "   font-weight: bold; "
-            "   padding: 10px; "
-            "   background: rgba(100, 181, 246, 0.1); "
-            "   border-radius: 10px; "
-            "}"
-        );
-        
-        // 添加透明度效果用于动画
-        QGraphicsOpacityEffect* opacityEffect = new QGraphicsOpacityEffect(m_currentLine);
-        m_currentLine->setGraphicsEffect(opacityEffect);
-        
-        m_fadeAnimation = new QPropertyAnimation(opacityEffect, "opacity", this);
-        m_fadeAnimation->setDuration(300);
-        m_fadeAnimation->setStartValue(0.3);
-        m_fadeAnimation->setEndValue(1.0);
-        
-        lyricLayout->addWidget(m_currentLine);
-        
-        // 下一行歌词
-        m_nextLine = new QLabel(lyricContainer);
-        m_nextLine->setAlignment(Qt::AlignCenter);
-        m_nextLine->setWordWrap(true);
-        m_nextLine->setMinimumWidth(600);
-        m_nextLine->setStyleSheet(
-            "QLabel { "
-            "   color: rgba(255, 255, 255, 0.4); "
-            "   font-size: 14pt; "
-            "   font-weight: normal; "
-            "   padding: 5px; "
-            "}"
-        );
-        lyricLayout->addWidget(m_nextLine);
-        
-        mainLayout->addWidget(lyricContainer);
-        
-        // 无歌词提示
-        m_noLyricLabel = new QLabel("🎵 暂无歌词", this);
-        m_noLyricLabel->setAlignment(Qt::AlignCenter);
-        m_noLyricLabel->setStyleSheet(
-            "QLabel { "
-            "   color: rgba(255, 255, 255, 0.5); "
-            "   font-size: 18pt; "
-            "   font-weight: bold; "
-            "   padding: 50px; "
-            "}"
-        );
-        mainLayout->addWidget(m_noLyricLabel);
-        
-        showNoLyric();
+        const qreal scale = 1.0 + (CURRENT_SCALE - 1.0) * emphasis(index, f);
+        const LineLayout *line = layoutFor(index);
+        const qreal height = line ? line->size.height() : QFontMetricsF(lyricFont()).height();
+        return height * scale;
     }
-    
-    // 查找当前时间对应的歌词行
-    int findCurrentLine(qint64 position)
+
+    // 相邻两行中心的距离
+    qreal centerDistance(int upper, int lower, double f)
     {
-        if (m_lyrics.isEmpty()) return -1;
-        
-        // 从后往前查找第一个时间戳小于等于当前位置的歌词
-        for (int i = m_lyrics.size() - 1; i >= 0; --i) {
-            if (m_lyrics[i].timestamp <= position) {
-                return i;
+        return extent(upper, f) / 2 + LINE_SPACING + extent(lower, f) / 2;
+    }
+
+    QFont lyricFont() const
+    {
+        QFont f = font();
+        f.setPointSize(BASE_POINT_SIZE);
+        f.setBold(true);
+        return f;
+    }
+
+    // 取得行的排版缓存，首次可见时排版
+    const LineLayout *layoutFor(int index)
+    {
+        if (index < 0 || index >= m_lyrics.size() || m_layoutWidth <= 0) return nullptr;
+        auto it = m_layouts.constFind(index);
+        if (it != m_layouts.constEnd()) return it->data();
+
+        const LyricLine &line = m_lyrics[index];
+        QSharedPointer<LineLayout> cache(new LineLayout);
+        cache->layout.setText(line.text);
+        cache->layout.setFont(lyricFont());
+
+        QTextOption option(Qt::AlignHCenter);
+        option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+        cache->layout.setTextOption(option);
+
+        qreal height = 0;
+        cache->layout.beginLayout();
+        for (QTextLine textLine = cache->layout.createLine(); textLine.isValid();
+             textLine = cache->layout.createLine()) {
+            textLine.setLineWidth(m_layoutWidth);
+            textLine.setPosition(QPointF(0, height));
+            height += textLine.height();
+        }
+        cache->layout.endLayout();
+        cache->size = QSizeF(m_layoutWidth, qMax(height, QFontMetricsF(lyricFont()).height()));
+        cache->glyphRuns = cache->layout.glyphRuns();
+
+        // 预先算出每个字的起止 x，高亮时只需插值
+        for (const LyricWord &word : line.words) {
+            const QTextLine textLine = cache->layout.lineForTextPosition(word.start);
+            if (!textLine.isValid()) {
+                cache->wordSpans.append(WordSpan{-1, 0, 0});
+                continue;
             }
+            const int endPos = qMin(word.start + word.length, textLine.textStart() + textLine.textLength());
+            cache->wordSpans.append(WordSpan{textLine.lineNumber(),
+                                             textLine.cursorToX(word.start),
+                                             textLine.cursorToX(endPos)});
         }
-        
-        return -1;
+
+        m_layouts.insert(index, cache);
+        return cache.data();
     }
-    
-    // 更新显示内容
-    void updateDisplay()
+
+    static QColor mix(const QColor &a, const QColor &b, double t)
     {
-        if (m_currentLineIndex < 0 || m_currentLineIndex >= m_lyrics.size()) {
-            m_prevLine->clear();
-            m_currentLine->clear();
-            m_nextLine->clear();
-            return;
+        return QColor::fromRgbF(a.redF() + (b.redF() - a.redF()) * t,
+                                a.greenF() + (b.greenF() - a.greenF()) * t,
+                                a.blueF() + (b.blueF() - a.blueF()) * t,
+                                a.alphaF() + (b.alphaF() - a.alphaF()) * t);
+    }
+
+    // 以 centerY 为中心绘制一行：按突出程度插值缩放与颜色，靠近边缘的行逐渐淡出
+    void drawLine(QPainter &painter, const QRectF &box, int index, qreal centerY, double f)
+    {
+        const LineLayout *line = layoutFor(index);
+        if (!line) return;
+
+        const double w = emphasis(index, f);
+        const qreal scale = 1.0 + (CURRENT_SCALE - 1.0) * w;
+        const qreal edgeFade = qBound(0.0, 1.0 - std::fabs(centerY - box.center().y()) / (box.height() / 2), 1.0);
+
+        painter.save();
+        painter.setOpacity(qMax(w, edgeFade));
+
+        // 高亮背景随突出程度淡入
+        const QSizeF scaled = line->size * scale;
+        const QRectF lineRect(box.center().x() - scaled.width() / 2, centerY - scaled.height() / 2,
+                              scaled.width(), scaled.height());
+        if (w > 0.0) {
+            const QRectF highlight = lineRect.adjusted(-CURRENT_PADDING, -CURRENT_PADDING,
+                                                       CURRENT_PADDING, CURRENT_PADDING);
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(QColor(100, 181, 246, qRound(26 * w)));
+            painter.drawRoundedRect(highlight, 10, 10);
         }
-        
-        // 上一行
-        if (m_currentLineIndex > 0) {
-            m_prevLine->setText(m_lyrics[m_currentLineIndex - 1].text);
-        } else {
-            m_prevLine->clear();
+        if (index == m_currentLineIndex) {
+            m_currentRect = lineRect.adjusted(-CURRENT_PADDING, -CURRENT_PADDING,
+                                              CURRENT_PADDING, CURRENT_PADDING).toAlignedRect().adjusted(-1, -1, 1, 1);
         }
-        
-        // 当前行
-        m_currentLine->setText(m_lyrics[m_currentLineIndex].text);
-        
-        // 下一行
-        if (m_currentLineIndex < m_lyrics.size() - 1) {
-            m_nextLine->setText(m_lyrics[m_currentLineIndex + 1].text);
+
+        // 缩放只改变绘制变换，不重新排版
+        painter.translate(lineRect.topLeft());
+        painter.scale(scale, scale);
+
+        const QColor dim(255, 255, 255, 102);
+        const QColor sung(0x64, 0xb5, 0xf6);
+        if (index == m_currentLineIndex && !line->wordSpans.isEmpty()) {
+            drawSweep(painter, *line, index, mix(dim, QColor(255, 255, 255, 178), w), sung);
         } else {
-            m_nextLine->clear();
+            drawPlain(painter, *line, mix(dim, sung, w));
+        }
+        painter.restore();
+    }
+
+    // 用缓存字形绘制整行
+    static void drawPlain(QPainter &painter, const LineLayout &cache, const QColor &color)
+    {
+        painter.setPen(color);
+        for (const QGlyphRun &run : cache.glyphRuns) {
+            painter.drawGlyphRun(QPointF(0, 0), run);
+        }
+    }
+
+    // 逐字高亮：先画未唱部分，再按裁剪区域叠加已唱部分
+    void drawSweep(QPainter &painter, const LineLayout &cache, int index,
+                   const QColor &unsung, const QColor &sung)
+    {
+        drawPlain(painter, cache, unsung);
+
+        // 找到正在唱的字及其进度
+        const LyricLine &line = m_lyrics[index];
+        const qint64 position = m_clock.position();
+        int word = -1;
+        for (int i = 0; i < line.words.size() && line.words[i].timestamp <= position; ++i) {
+            word = i;
+        }
+        if (word < 0) return;
+
+        const qint64 start = line.words[word].timestamp;
+        qint64 end = start + LAST_WORD_MS;
+        if (word + 1 < line.words.size()) {
+            end = line.words[word + 1].timestamp;
+        } else if (index + 1 < m_lyrics.size()) {
+            end = qMin(end, m_lyrics[index + 1].timestamp);
         }
+        const double progress = end > start ? qBound(0.0, double(position - start) / (end - start), 1.0) : 1.0;
+
+        const WordSpan &span = cache.wordSpans[word];
+        if (span.textLine < 0) return;
+
+        // 之前的排版行全部高亮，当前排版行高亮到插值位置
+        QPainterPath clip;
+        for (int i = 0; i <= span.textLine; ++i) {
+            const QRectF lineRect = cache.layout.lineAt(i).rect();
+            qreal right = lineRect.right();
+            if (i == span.textLine) {
+                right = span.x0 + (span.x1 - span.x0) * progress;
+            }
+            clip.addRect(QRectF(lineRect.left(), lineRect.top(), right - lineRect.left(), lineRect.height()));
+        }
+
+        painter.save();
+        painter.setClipPath(clip, Qt::IntersectClip);
+        drawPlain(painter, cache, sung);
+        painter.restore();
     }
-    
-    // 播放当前行动画
-    void animateCurrentLine()
+
+    // 滚动到新的当前行：节拍已锁定时让滚动恰好在下一拍结束，跨越多行（跳转）时直接定位
+    void scrollTo(int index)
     {
-        if (m_fadeAnimation->state() == QAbstractAnimation::Running) {
-            m_fadeAnimation->stop();
+        m_scrollAnimation->stop();
+        if (std::fabs(index - m_scrollPos) > MAX_SCROLL_LINES) {
+            m_scrollPos = index;
+            update();
+            return;
         }
-        m_fadeAnimation->start();
+
+        int duration = DEFAULT_SCROLL_MS;
+        const qint64 sinceBeat = m_beatClock.isValid() ? m_beatClock.elapsed() : -1;
+        // 超过 4 拍没有收到节拍（暂停、安静段落）时视为失锁
+        if (m_beatPeriodMs > 0.0 && sinceBeat >= 0 && sinceBeat < 4 * m_beatPeriodMs) {
+            const double period = m_beatPeriodMs;
+            double untilBeat = period - std::fmod(double(sinceBeat), period);
+            if (untilBeat < MIN_SCROLL_MS) untilBeat += period;
+            duration = static_cast<int>(untilBeat);
+        }
+        m_scrollAnimation->setDuration(duration);
+        m_scrollAnimation->setStartValue(m_scrollPos);
+        m_scrollAnimation->setEndValue(double(index));
+        m_scrollAnimation->start();
+        updateFrameStats();
     }
-    
-    // 显示无歌词提示
-    void showNoLyric()
+
+    void recordPaintCost(qint64 ns)
     {
-        m_prevLine->hide();
-        m_currentLine->hide();
-        m_nextLine->hide();
-        m_noLyricLabel->show();
+        m_lastPaintNs = ns;
+        m_averagePaintNs = m_averagePaintNs <= 0.0
+            ? ns
+            : m_averagePaintNs * 0.95 + ns * 0.05;
     }
-    
-    // 隐藏无歌词提示
-    void hideNoLyric()
+
+    // 每秒统计一次实际绘制帧率
+    void sampleFps()
+    {
+        if (!m_fpsClock.isValid()) return;
+        const qint64 elapsed = m_fpsClock.elapsed();
+        if (elapsed < 1000) return;
+        setEffectiveFps(m_frameCount * 1000.0 / elapsed);
+        m_frameCount = 0;
+        m_fpsClock.restart();
+    }
+
+    void setEffectiveFps(double fps)
+    {
+        if (qFuzzyCompare(fps + 1.0, m_effectiveFps + 1.0)) return;
+        m_effectiveFps = fps;
+        emit effectiveFpsChanged(fps);
+    }
+
+private slots:
+    // 动画（滚动或逐字高亮）开始时开始统计帧率，全部停止后归零
+    void updateFrameStats()
+    {
+        const bool animating = m_scrollAnimation->state() == QAbstractAnimation::Running
+                               || m_sweepTimer->isActive();
+        if (animating && !m_fpsClock.isValid()) {
+            m_fpsClock.start();
+            m_frameCount = 0;
+        } else if (!animating && m_fpsClock.isValid()) {
+            m_fpsClock.invalidate();
+            setEffectiveFps(0.0);
+        }
+    }
+
+    // 按插值时钟刷新当前行，并把换行定时器设在下一行的时间点
+    void refresh()
+    {
+        m_lineTimer->stop();
+        if (m_lyrics.isEmpty()) return;
+
+        // 查找当前应该显示的歌词行，行号不变时只推进逐字高亮
+        const int newIndex = findCurrentLine(m_clock.position());
+        const bool lineChanged = newIndex != m_currentLineIndex;
+        if (lineChanged) {
+            m_currentLineIndex = newIndex;
+            scrollTo(newIndex);
+        }
+
+        if (newIndex + 1 < m_lyrics.size()) {
+            const qint64 wait = m_clock.msUntil(m_lyrics[newIndex + 1].timestamp);
+            if (wait >= 0) m_lineTimer->start(static_cast<int>(qMin<qint64>(wait, INT_MAX)));
+        }
+
+        if (currentHasWords() && m_clock.isRunning()) {
+            if (!m_sweepTimer->isActive()) m_sweepTimer->start();
+        } else if (m_sweepTimer->isActive() || lineChanged) {
+            // 没有逐字时间或已暂停：只在换行、或逐字高亮刚停下（定格最后一帧）时重绘当前行
+            m_sweepTimer->stop();
+            update(m_currentRect);
+        }
+        updateFrameStats();
+    }
+
+    // 逐字高亮刷新：滚动中整体重绘，否则只重绘当前行
+    void onSweepTick()
     {
-        m_noLyricLabel->hide();
-        m_prevLine->show();
-        m_currentLine->show();
-        m_nextLine->show();
+        if (m_scrollAnimation->state() == QAbstractAnimation::Running) return;
+        update(m_currentRect);
     }
 };
 
@@ -0,0 +1,197 @@
+#ifndef NETWORKDIAGNOSTICSDIALOG_H
+#define NETWORKDIAGNOSTICSDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QTimer>
+#include "networkresilience.h"
+#include "lyricdownloader.h"
+
+// 网络诊断对话框：各主机的熔断状态与请求统计、各歌词来源的响应时间，每秒刷新
+class NetworkDiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+private:
+    static const int REFRESH_MS = 1000;
+
+    LyricDownloader *m_downloader;      // 可为空（不显示歌词来源）
+    QTableWidget *m_hostTable;          // 主机熔断状态
+    QTableWidget *m_providerTable;      // 歌词来源响应时间
+    QLabel *m_summaryLabel;             // 歌词下载与缓存统计
+    QTimer *m_refreshTimer;
+
+public:
+    explicit NetworkDiagnosticsDialog(LyricDownloader *downloader, QWidget *parent = nullptr)
+        : QDialog(parent)
+        , m_downloader(downloader)
+    {
+        setWindowTitle("网络诊断");
+        setMinimumSize(860, 520);
+        setupUI();
+
+        m_refreshTimer = new QTimer(this);
+        connect(m_refreshTimer, &QTimer::timeout, this, &NetworkDiagnosticsDialog::refresh);
+        m_refreshTimer->start(REFRESH_MS);
+        refresh();
+    }
+
+private:
+    void setupUI()
+    {
+        QVBoxLayout *mainLayout = new QVBoxLayout(this);
+        mainLayout->setSpacing(10);
+        mainLayout->setContentsMargins(20, 20, 20, 20);
+
+        setStyleSheet(
+            "QDialog { "
+            "   background-color: #2b2b2b; "
+            "}"
+            "QLabel { "
+            "   color: #ffffff; "
+            "   font-size: 10pt; "
+            "}"
+            "QTableWidget { "
+            "   background-color: #1e1e1e; "
+            "   color: #ffffff; "
+            "   gridline-color: #333; "
+            "   border: 2px solid #444; "
+            "   border-radius: 8px; "
+            "}"
+            "QHeaderView::section { "
+            "   background-color: #333; "
+            "   color: #64b5f6; "
+            "   border: none; "
+            "   padding: 4px; "
+            "}"
+            "QPushButton { "
+            "   background-color: #0d47a1; "
+            "   color: white; "
+            "   border: none; "
+            "   padding: 8px 20px; "
+            "   border-radius: 8px; "
+            "   font-weight: bold; "
+            "}"
+            "QPushButton:hover { "
+            "   background-color: #1565c0; "
+            "}"
+        );
+
+        QLabel *hostLabel = new QLabel("主机状态（连续失败 3 次熔断，冷却后半开探测）：", this);
+        hostLabel->setStyleSheet("font-weight: bold; color: #64b5f6;");
+        mainLayout->addWidget(hostLabel);
+
+        m_hostTable = createTable({"主机", "状态", "连续失败", "请求", "成功", "失败", "重试", "熔断拒绝", "最近耗时", "恢复探测"});
+        mainLayout->addWidget(m_hostTable, 1);
+
+        QLabel *providerLabel = new QLabel("歌词来源（按此顺序优先查询）：", this);
+        providerLabel->setStyleSheet("font-weight: bold; color: #64b5f6;");
+        mainLayout->addWidget(providerLabel);
+
+        m_providerTable = createTable({"来源", "地址", "样本", "中位数", "90 分位", "失败"});
+        mainLayout->addWidget(m_providerTable, 1);
+
+        m_summaryLabel = new QLabel(this);
+        mainLayout->addWidget(m_summaryLabel);
+
+        QHBoxLayout *buttonLayout = new QHBoxLayout();
+        buttonLayout->addStretch();
+        QPushButton *resetButton = new QPushButton("重置熔断器", this);
+        QPushButton *closeButton = new QPushButton("关闭", this);
+        buttonLayout->addWidget(resetButton);
+        buttonLayout->addWidget(closeButton);
+        mainLayout->addLayout(buttonLayout);
+
+        connect(resetButton, &QPushButton::clicked, this, [this]() {
+            NetworkResilience::instance()->reset();
+            refresh();
+        });
+        connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
+    }
+
+    QTableWidget *createTable(const QStringList &headers)
+    {
+        QTableWidget *table = new QTableWidget(0, headers.size(), this);
+        table->setHorizontalHeaderLabels(headers);
+        table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+        table->horizontalHeader()->setStretchLastSection(true);
+        table->verticalHeader()->hide();
+        table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        table->setSelectionMode(QAbstractItemView::NoSelection);
+        return table;
+    }
+
+    static void setRow(QTableWidget *table, int row, const QStringList &values)
+    {
+        for (int column = 0; column < values.size(); ++column) {
+            QTableWidgetItem *item = table->item(row, column);
+            if (!item) {
+                item = new QTableWidgetItem();
+                table->setItem(row, column, item);
+            }
+            item->setText(values[column]);
+        }
+    }
+
+private slots:
+    void refresh()
+    {
+        const QList<NetworkResilience::HostStatus> hosts = NetworkResilience::instance()->snapshot();
+        m_hostTable->setRowCount(hosts.size());
+        for (int row = 0; row < hosts.size(); ++row) {
+            const NetworkResilience::HostStatus &status = hosts[row];
+            setRow(m_hostTable, row, {
+                status.host,
+                NetworkResilience::stateName(status.state),
+                QString::number(status.consecutiveFailures),
+                QString::number(status.requests),
+                QString::number(status.successes),
+                QString::number(status.failures),
+                QString::number(status.retries),
+                QString::number(status.rejections),
+                QString("%1 ms").arg(status.lastLatencyMs),
+                status.state == CircuitBreaker::Open ? QString("%1 秒后").arg((status.reopenInMs + 999) / 1000) : QString("-")
+            });
+            const QColor color = status.state == CircuitBreaker::Closed ? QColor("#81c784")
+                                 : status.state == CircuitBreaker::Open ? QColor("#e57373") : QColor("#ffb74d");
+            m_hostTable->item(row, 1)->setForeground(color);
+        }
+
+        if (!m_downloader) return;
+
+        const QList<LyricProvider *> providers = m_downloader->rankedProviders();
+        m_providerTable->setRowCount(providers.size());
+        for (int row = 0; row < providers.size(); ++row) {
+            const LatencyHistogram &latency = providers[row]->latency();
+            const bool sampled = latency.sampleCount() > 0;
+            setRow(m_providerTable, row, {
+                providers[row]->name(),
+                providers[row]->baseUrl().toString(),
+                QString::number(latency.sampleCount()),
+                sampled ? QString("≤ %1 ms").arg(latency.quantile(0.5)) : QString("-"),
+                sampled ? QString("≤ %1 ms").arg(latency.quantile(0.9)) : QString("-"),
+                QString::number(latency.failureCount())
+            });
+        }
+
+        const LyricResponseCache *cache = m_downloader->cache();
+        m_summaryLabel->setText(QString("歌词下载：查询 %1 次，成功 %2，失败 %3，取消 %4，进行中 %5　|　"
+                                        "查询缓存：命中 %6，未找到命中 %7，未命中 %8，条目 %9")
+                                .arg(m_downloader->requestCount())
+                                .arg(m_downloader->succeededCount())
+                                .arg(m_downloader->failedCount())
+                                .arg(m_downloader->cancelledCount())
+                                .arg(m_downloader->activeCount())
+                                .arg(cache->hitCount())
+                                .arg(cache->negativeHitCount())
+                                .arg(cache->missCount())
+                                .arg(cache->entryCount()));
+    }
+};
+
+#endif // NETWORKDIAGNOSTICSDIALOG_H
@@ -0,0 +1,464 @@
+#ifndef NETWORKRESILIENCE_H
+#define NETWORKRESILIENCE_H
+
+#include <QObject>
+#include <QCoreApplication>
+#include <QPointer>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QDebug>
+#include <functional>
+
+// 一次请求（含重试）的最终结果
+struct NetworkResult
+{
+    QNetworkReply::NetworkError error = QNetworkReply::NoError;
+    int httpStatus = 0;
+    QByteArray body;
+    QString errorString;
+    bool rejected = false;      // 熔断中，请求没有发出
+    int attempts = 0;           // 实际发出的次数
+
+    bool ok() const { return !rejected && error == QNetworkReply::NoError; }
+};
+
+// 单个主机的熔断器
+// 关闭：正常放行，连续失败达到阈值后打开；
+// 打开：直接拒绝，冷却结束后转为半开；
+// 半开：只放行一个探测请求，成功则关闭，失败则重新打开并加倍冷却时间
+class CircuitBreaker
+{
+public:
+    enum State { Closed, Open, HalfOpen };
+
+private:
+    static const int FAILURE_THRESHOLD = 3;     // 连续失败多少次后打开
+    static const int MAX_COOLDOWN_MS = 60000;   // 冷却时间上限
+
+    State m_state = Closed;
+    int m_consecutiveFailures = 0;
+    qint64 m_baseCooldownMs;        // 首次打开的冷却时间
+    qint64 m_cooldownMs;
+    qint64 m_openUntil = 0;         // 打开状态的截止时刻
+    bool m_probeInFlight = false;   // 半开状态下的探测请求是否已发出
+
+public:
+    static const int BASE_COOLDOWN_MS = 5000;   // 默认的首次冷却时间
+
+    // 统计
+    qint64 requests = 0;            // 发出的请求数（含重试）
+    qint64 successes = 0;
+    qint64 failures = 0;
+    qint64 retries = 0;
+    qint64 rejections = 0;          // 熔断拒绝的请求数
+    qint64 lastLatencyMs = 0;       // 最近一次请求的耗时
+
+    explicit CircuitBreaker(qint64 baseCooldownMs = BASE_COOLDOWN_MS)
+        : m_baseCooldownMs(baseCooldownMs)
+        , m_cooldownMs(baseCooldownMs)
+    {
+    }
+
+    // 当前状态（打开状态冷却结束后视为半开）
+    State state(qint64 nowMs) const
+    {
+        if (m_state == Open && nowMs >= m_openUntil) return HalfOpen;
+        return m_state;
+    }
+
+    int consecutiveFailures() const { return m_consecutiveFailures; }
+    qint64 openUntil() const { return m_openUntil; }
+
+    // 是否放行一个请求；半开时放行的请求即为探测请求
+    bool allow(qint64 nowMs)
+    {
+        if (m_state == Open && nowMs >= m_openUntil) {
+            m_state = HalfOpen;
+            m_probeInFlight = false;
+        }
+        if (m_state == Closed) return true;
+        if (m_state == HalfOpen && !m_probeInFlight) {
+            m_probeInFlight = true;
+            return true;
+        }
+        ++rejections;
+        return false;
+    }
+
+    void onSuccess()
+    {
+        ++successes;
+        m_state = Closed;
+        m_consecutiveFailures = 0;
+        m_cooldownMs = m_baseCooldownMs;
+        m_probeInFlight = false;
+    }
+
+    void onFailure(qint64 nowMs)
+    {
+        ++failures;
+        ++m_consecutiveFailures;
+        if (m_state == HalfOpen) {
+            // 探测失败：服务仍不可用，冷却时间加倍
+            m_cooldownMs = qMin<qint64>(m_cooldownMs * 2, MAX_COOLDOWN_MS);
+            open(nowMs);
+        } else if (m_state == Closed && m_consecutiveFailures >= FAILURE_THRESHOLD) {
+            open(nowMs);
+        }
+    }
+
+    // 探测请求被调用方放弃（没有结果），允许下一个请求继续探测
+    void onAbandoned()
+    {
+        if (m_state == HalfOpen) m_probeInFlight = false;
+    }
+
+private:
+    void open(qint64 nowMs)
+    {
+        m_state = Open;
+        m_openUntil = nowMs + m_cooldownMs;
+        m_probeInFlight = false;
+    }
+};
+
+class NetworkResilience;
+
+// 一个带重试的请求；调用方可随时 abort()，之后不再回调
+// 每次发出限时（超时即中止，计入熔断，不再重试），整个请求另有截止时间，到期时中止进行中的那次
+class ResilientRequest : public QObject
+{
+    Q_OBJECT
+
+    friend class NetworkResilience;
+
+public:
+    using Handler = std::function<void(const NetworkResult &result)>;
+
+private:
+    QPointer<NetworkResilience> m_resilience;
+    QPointer<QNetworkAccessManager> m_manager;
+    QNetworkRequest m_request;
+    QString m_host;
+    Handler m_handler;
+    QPointer<QNetworkReply> m_reply;
+    QTimer *m_retryTimer;
+    QTimer *m_attemptTimer;         // 单次请求超时
+    QTimer *m_deadlineTimer;        // 整体截止
+    QElapsedTimer m_started;        // 首次发出的时刻
+    QElapsedTimer m_attemptClock;
+    NetworkResult m_lastResult;     // 最近一次失败（等待重试时到期则返回它）
+    int m_attempts = 0;
+    bool m_timedOut = false;        // 进行中的请求因超时被中止
+    bool m_done = false;
+
+    ResilientRequest(NetworkResilience *resilience, QNetworkAccessManager *manager,
+                     const QNetworkRequest &request, const Handler &handler, QObject *parent)
+        : QObject(parent)
+        , m_resilience(resilience)
+        , m_manager(manager)
+        , m_request(request)
+        , m_host(request.url().host())
+        , m_handler(handler)
+    {
+        m_retryTimer = new QTimer(this);
+        m_retryTimer->setSingleShot(true);
+        connect(m_retryTimer, &QTimer::timeout, this, &ResilientRequest::send);
+        m_attemptTimer = new QTimer(this);
+        m_attemptTimer->setSingleShot(true);
+        connect(m_attemptTimer, &QTimer::timeout, this, &ResilientRequest::onTimeout);
+        m_deadlineTimer = new QTimer(this);
+        m_deadlineTimer->setSingleShot(true);
+        connect(m_deadlineTimer, &QTimer::timeout, this, &ResilientRequest::onTimeout);
+    }
+
+public:
+    inline ~ResilientRequest();
+
+    void abort();
+
+private:
+    inline void send();
+    inline void onReplyFinished(QNetworkReply *reply);
+    inline void onTimeout();
+
+    void finish(const NetworkResult &result)
+    {
+        if (m_done) return;
+        m_done = true;
+        m_retryTimer->stop();
+        m_attemptTimer->stop();
+        m_deadlineTimer->stop();
+        const Handler handler = m_handler;
+        deleteLater();
+        if (handler) handler(result);
+    }
+};
+
+// 网络请求的容错层：指数退避加随机抖动的重试、按主机的熔断器与半开探测
+// 全局共享一个实例（熔断状态需要跨对话框、跨下载器保留），随应用对象销毁
+class NetworkResilience : public QObject
+{
+    Q_OBJECT
+
+    friend class ResilientRequest;
+
+public:
+    // 某个主机的诊断信息
+    struct HostStatus
+    {
+        QString host;
+        CircuitBreaker::State state = CircuitBreaker::Closed;
+        int consecutiveFailures = 0;
+        qint64 reopenInMs = 0;      // 打开状态下距离半开的剩余时间
+        qint64 requests = 0;
+        qint64 successes = 0;
+        qint64 failures = 0;
+        qint64 retries = 0;
+        qint64 rejections = 0;
+        qint64 lastLatencyMs = 0;
+    };
+
+private:
+    static const int MAX_ATTEMPTS = 3;          // 每个请求最多发出的次数
+    static const int BASE_BACKOFF_MS = 250;     // 退避基数（第 n 次重试上限为 基数 × 2^n）
+    static constexpr int MAX_BACKOFF_MS = 4000; // 单次退避上限
+    static const int ATTEMPT_TIMEOUT_MS = 4000; // 单次请求超时（超时不重试）
+    static const int DEADLINE_MS = 8000;        // 整个请求（含重试）的截止时间
+
+    QHash<QString, CircuitBreaker> m_breakers;  // 主机 -> 熔断器
+    QElapsedTimer m_clock;
+    int m_attemptTimeoutMs = ATTEMPT_TIMEOUT_MS;
+    int m_deadlineMs = DEADLINE_MS;
+    int m_cooldownMs = CircuitBreaker::BASE_COOLDOWN_MS;
+
+    explicit NetworkResilience(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+        m_clock.start();
+    }
+
+public:
+    static NetworkResilience *instance()
+    {
+        static QPointer<NetworkResilience> shared;
+        if (!shared) shared = new NetworkResilience(QCoreApplication::instance());
+        return shared;
+    }
+
+    // 发出 GET 请求（失败时按退避重试，熔断中立即失败），结果异步交给 handler
+    // context 销毁时请求随之中止
+    ResilientRequest *get(QNetworkAccessManager *manager, const QNetworkRequest &request,
+                          QObject *context, const ResilientRequest::Handler &handler)
+    {
+        ResilientRequest *task = new ResilientRequest(this, manager, request, handler, context);
+        QMetaObject::invokeMethod(task, &ResilientRequest::send, Qt::QueuedConnection);
+        return task;
+    }
+
+    QList<HostStatus> snapshot() const
+    {
+        QList<HostStatus> result;
+        const qint64 now = m_clock.elapsed();
+        for (auto it = m_breakers.cbegin(); it != m_breakers.cend(); ++it) {
+            const CircuitBreaker &breaker = it.value();
+            HostStatus status;
+            status.host = it.key();
+            status.state = breaker.state(now);
+            status.consecutiveFailures = breaker.consecutiveFailures();
+            status.reopenInMs = status.state == CircuitBreaker::Open ? breaker.openUntil() - now : 0;
+            status.requests = breaker.requests;
+            status.successes = breaker.successes;
+            status.failures = breaker.failures;
+            status.retries = breaker.retries;
+            status.rejections = breaker.rejections;
+            status.lastLatencyMs = breaker.lastLatencyMs;
+            result.append(status);
+        }
+        return result;
+    }
+
+    static QString stateName(CircuitBreaker::State state)
+    {
+        switch (state) {
+        case CircuitBreaker::Closed: return "正常";
+        case CircuitBreaker::Open: return "熔断";
+        case CircuitBreaker::HalfOpen: return "半开";
+        }
+        return QString();
+    }
+
+    // 重置所有熔断器与统计
+    void reset() { m_breakers.clear(); }
+
+    // 调整超时（测试用）；之后发出的请求生效
+    void setTimeouts(int attemptTimeoutMs, int deadlineMs)
+    {
+        m_attemptTimeoutMs = attemptTimeoutMs;
+        m_deadlineMs = deadlineMs;
+    }
+    int attemptTimeout() const { return m_attemptTimeoutMs; }
+    int deadline() const { return m_deadlineMs; }
+
+    // 调整熔断器首次打开的冷却时间（测试用）；之后新建的熔断器生效，已有的在 reset() 后生效
+    void setCooldown(int baseCooldownMs) { m_cooldownMs = baseCooldownMs; }
+    int cooldown() const { return m_cooldownMs; }
+
+signals:
+    void stateChanged(const QString &host, CircuitBreaker::State state);
+
+private:
+    qint64 now() const { return m_clock.elapsed(); }
+
+    CircuitBreaker &breaker(const QString &host)
+    {
+        auto it = m_breakers.find(host);
+        if (it == m_breakers.end()) it = m_breakers.insert(host, CircuitBreaker(m_cooldownMs));
+        return it.value();
+    }
+
+    // 记录结果并在状态变化时通知
+    void report(const QString &host, bool success)
+    {
+        CircuitBreaker &b = breaker(host);
+        const CircuitBreaker::State before = b.state(now());
+        if (success) {
+            b.onSuccess();
+        } else {
+            b.onFailure(now());
+        }
+        const CircuitBreaker::State after = b.state(now());
+        if (after != before) {
+            qDebug() << "熔断器状态变化:" << host << stateName(before) << "->" << stateName(after);
+            emit stateChanged(host, after);
+        }
+    }
+
+    // 可重试的失败：连接失败、超时、服务端 5xx 与 429；其余 4xx 说明服务可达，不重试也不计入熔断
+    static bool isTransientFailure(const NetworkResult &result)
+    {
+        if (result.httpStatus >= 500 || result.httpStatus == 429) return true;
+        if (result.httpStatus >= 400) return false;
+        return result.error != QNetworkReply::NoError;
+    }
+
+    // 第 attempt 次重试前的等待：0 到 基数 × 2^attempt 之间均匀随机（"完全抖动"，避免重试同步）
+    static int backoffMs(int attempt)
+    {
+        const int cap = qMin(MAX_BACKOFF_MS, BASE_BACKOFF_MS << qMin(attempt, 10));
+        return QRandomGenerator::global()->bounded(cap + 1);
+    }
+};
+
+inline void ResilientRequest::send()
+{
+    if (m_done) return;
+    if (!m_manager || !m_resilience) {
+        NetworkResult result;
+        result.error = QNetworkReply::OperationCanceledError;
+        result.errorString = "网络管理器已销毁";
+        finish(result);
+        return;
+    }
+
+    if (m_attempts == 0) {
+        m_started.start();
+        m_deadlineTimer->start(m_resilience->m_deadlineMs);
+    }
+
+    CircuitBreaker &breaker = m_resilience->breaker(m_host);
+    if (!breaker.allow(m_resilience->now())) {
+        NetworkResult result;
+        result.rejected = true;
+        result.error = QNetworkReply::ServiceUnavailableError;
+        result.errorString = "服务暂不可用（熔断中）";
+        result.attempts = m_attempts;
+        finish(result);
+        return;
+    }
+
+    ++m_attempts;
+    ++breaker.requests;
+    if (m_attempts > 1) ++breaker.retries;
+    m_attemptClock.start();
+    m_attemptTimer->start(m_resilience->m_attemptTimeoutMs);
+    QNetworkReply *reply = m_manager->get(m_request);
+    m_reply = reply;
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { onReplyFinished(reply); });
+}
+
+inline void ResilientRequest::onReplyFinished(QNetworkReply *reply)
+{
+    reply->deleteLater();
+    if (m_done || m_reply != reply) return;
+    m_reply = nullptr;
+    m_attemptTimer->stop();
+
+    NetworkResult result;
+    result.error = reply->error();
+    result.httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    result.errorString = m_timedOut ? QString("请求超时") : reply->errorString();
+    result.body = reply->readAll();
+    result.attempts = m_attempts;
+
+    const bool transient = NetworkResilience::isTransientFailure(result);
+    if (m_resilience) {
+        m_resilience->breaker(m_host).lastLatencyMs = m_attemptClock.elapsed();
+        m_resilience->report(m_host, !transient);
+    }
+
+    // 超时说明服务端很慢，重试只会再等一个超时，直接返回并让熔断器尽快生效
+    if (transient && !m_timedOut && m_resilience && m_attempts < NetworkResilience::MAX_ATTEMPTS) {
+        const int delay = NetworkResilience::backoffMs(m_attempts);
+        if (m_started.elapsed() + delay < m_resilience->m_deadlineMs) {
+            qDebug() << "请求失败，" << delay << "ms 后重试:" << m_request.url().toString() << result.errorString;
+            m_lastResult = result;
+            m_retryTimer->start(delay);
+            return;
+        }
+    }
+    finish(result);
+}
+
+// 单次超时或整体到期：中止进行中的请求（按超时失败处理）；正在等待重试时返回上一次的失败
+inline void ResilientRequest::onTimeout()
+{
+    if (m_done) return;
+    if (m_reply) {
+        m_timedOut = true;
+        m_reply->abort();   // 随后 finished 交给 onReplyFinished
+    } else {
+        finish(m_lastResult);
+    }
+}
+
+inline void ResilientRequest::abort()
+{
+    if (m_done) return;
+    m_done = true;
+    m_retryTimer->stop();
+    m_attemptTimer->stop();
+    m_deadlineTimer->stop();
+    QPointer<QNetworkReply> reply = m_reply;
+    m_reply = nullptr;
+    if (reply) {
+        // 进行中的请求可能是半开探测，放弃后让后续请求继续探测
+        if (m_resilience) m_resilience->breaker(m_host).onAbandoned();
+        reply->abort();
+    }
+    deleteLater();
+}
+
+// 随 context 一起销毁时按放弃处理
+inline ResilientRequest::~ResilientRequest()
+{
+    if (!m_done) abort();
+}
+
+#endif // NETWORKRESILIENCE_H
@@ -19,6 +19,7 @@
 #include <QDebug>
 #include <QUrl>
 #include <QUrlQuery>
+#include "networkresilience.h"
 
 // 歌曲信息结构
 struct SongInfo
@@ -58,8 +59,6 @@ public:
         setupUI();
         
         m_networkManager = new QNetworkAccessManager(this);
-        connect(m_networkManager, &QNetworkAccessManager::finished,
-                this, &OnlineMusicSearch::onSearchFinished);
     }
     
     // 获取选中的歌曲信息
@@ -258,28 +257,25 @@ private slots:
                          "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36");
         request.setRawHeader("Referer", "http://music.163.com");
         
-        m_networkManager->get(request);
+        // 经容错层发出：失败时退避重试，超时与服务不可用时尽快返回
+        NetworkResilience::instance()->get(m_networkManager, request, this,
+            [this](const NetworkResult& result) { onSearchFinished(result); });
     }
     
-    void onSearchFinished(QNetworkReply* reply)
+    void onSearchFinished(const NetworkResult& result)
     {
         m_progressBar->hide();
         m_searchButton->setEnabled(true);
         
-        if (reply->error() != QNetworkReply::NoError) {
-            m_statusLabel->setText("搜索失败：" + reply->errorString());
+        if (!result.ok()) {
+            m_statusLabel->setText("搜索失败：" + result.errorString);
             
             // 显示模拟数据用于演示
             showDemoResults();
-            
-            reply->deleteLater();
             return;
         }
         
-        QByteArray data = reply->readAll();
-        reply->deleteLater();
-        
-        parseSearchResults(data);
+        parseSearchResults(result.body);
     }
     
     void parseSearchResults(const QByteArray& data)
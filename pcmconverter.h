@@ -0,0 +1,71 @@
+#ifndef PCMCONVERTER_H
+#define PCMCONVERTER_H
+
+#include <QAudioBuffer>
+#include <QAudioFormat>
+
+// PCM 采样格式转换：把 QAudioBuffer 中任意采样格式的数据转为 [-1, 1] 浮点
+class PcmConverter
+{
+public:
+    // 转为交错浮点：输出 frames * channelCount 个样本
+    static bool toFloat(const QAudioBuffer &buffer, int firstFrame, int frames, float *out)
+    {
+        const int channels = buffer.format().channelCount();
+        return dispatch(buffer, firstFrame, frames, [&](auto data, float scale, float bias) {
+            const int samples = frames * channels;
+            for (int i = 0; i < samples; ++i) {
+                out[i] = (static_cast<float>(data[i]) + bias) * scale;
+            }
+        });
+    }
+
+    // 各声道取平均混缩为单声道：输出 frames 个样本
+    static bool toMono(const QAudioBuffer &buffer, int firstFrame, int frames, float *out)
+    {
+        const int channels = buffer.format().channelCount();
+        return dispatch(buffer, firstFrame, frames, [&](auto data, float scale, float bias) {
+            const float gain = scale / channels;
+            for (int f = 0; f < frames; ++f) {
+                float sum = 0.0f;
+                for (int c = 0; c < channels; ++c) {
+                    sum += static_cast<float>(data[f * channels + c]) + bias;
+                }
+                out[f] = sum * gain;
+            }
+        });
+    }
+
+private:
+    // 按采样格式取得数据指针与归一化参数，不支持的格式返回 false
+    template <typename Fn>
+    static bool dispatch(const QAudioBuffer &buffer, int firstFrame, int frames, Fn fn)
+    {
+        const QAudioFormat format = buffer.format();
+        const int channels = format.channelCount();
+        if (channels <= 0 || frames <= 0 || firstFrame < 0
+            || firstFrame + frames > buffer.frameCount()) {
+            return false;
+        }
+
+        const int first = firstFrame * channels;
+        switch (format.sampleFormat()) {
+        case QAudioFormat::UInt8:
+            fn(buffer.constData<quint8>() + first, 1.0f / 128.0f, -128.0f);
+            return true;
+        case QAudioFormat::Int16:
+            fn(buffer.constData<qint16>() + first, 1.0f / 32768.0f, 0.0f);
+            return true;
+        case QAudioFormat::Int32:
+            fn(buffer.constData<qint32>() + first, 1.0f / 2147483648.0f, 0.0f);
+            return true;
+        case QAudioFormat::Float:
+            fn(buffer.constData<float>() + first, 1.0f, 0.0f);
+            return true;
+        default:
+            return false;
+        }
+    }
+};
+
+#endif // PCMCONVERTER_H
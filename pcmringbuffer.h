@@ -0,0 +1,100 @@
+#ifndef PCMRINGBUFFER_H
+#define PCMRINGBUFFER_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+// 单生产者 / 单消费者无锁 PCM 环形缓冲
+// 生产者（解码线程）只追加，写满后直接覆盖最旧的数据，永不阻塞；
+// 消费者（GUI 定时器）只读取最新的一段窗口，读取期间若被覆盖则放弃本次读取。
+// 双方均为 wait-free：没有互斥锁、没有重试循环，热路径不分配内存。
+class PcmRingBuffer
+{
+private:
+    static constexpr int CACHE_LINE = 64;
+
+    // 生产者已完成写入的帧序号（发布给消费者）
+    alignas(CACHE_LINE) std::atomic<quint64> m_writeIndex;
+    // 生产者即将写到的帧序号（写入数据前先声明，用于消费者检测覆盖）
+    alignas(CACHE_LINE) std::atomic<quint64> m_claimIndex;
+    // 只读配置，与两个索引分处不同缓存行
+    alignas(CACHE_LINE) const quint64 m_capacity;
+    const quint64 m_mask;
+    std::unique_ptr<std::atomic<float>[]> m_frames;
+
+public:
+    // capacity 会向上取整为 2 的幂
+    explicit PcmRingBuffer(int capacity)
+        : m_writeIndex(0)
+        , m_claimIndex(0)
+        , m_capacity(roundUpPowerOfTwo(capacity))
+        , m_mask(m_capacity - 1)
+        , m_frames(new std::atomic<float>[m_capacity])
+    {
+        for (quint64 i = 0; i < m_capacity; ++i) {
+            m_frames[i].store(0.0f, std::memory_order_relaxed);
+        }
+    }
+
+    PcmRingBuffer(const PcmRingBuffer &) = delete;
+    PcmRingBuffer &operator=(const PcmRingBuffer &) = delete;
+
+    int capacity() const { return static_cast<int>(m_capacity); }
+
+    // 累计写入的帧数（任意线程可读）
+    quint64 framesWritten() const { return m_writeIndex.load(std::memory_order_acquire); }
+
+    // 生产者：追加 frames 帧，超过容量时只保留最后 capacity 帧
+    void write(const float *data, int frames)
+    {
+        if (frames <= 0) return;
+        if (static_cast<quint64>(frames) > m_capacity) {
+            data += frames - m_capacity;
+            frames = static_cast<int>(m_capacity);
+        }
+
+        const quint64 start = m_writeIndex.load(std::memory_order_relaxed);
+        const quint64 end = start + frames;
+
+        // 先声明要覆盖的范围，再写数据（seqlock 式发布）
+        m_claimIndex.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < frames; ++i) {
+            m_frames[(start + i) & m_mask].store(data[i], std::memory_order_relaxed);
+        }
+
+        m_writeIndex.store(end, std::memory_order_release);
+    }
+
+    // 消费者：复制最新的 frames 帧。数据不足或读取期间被覆盖时返回 false，
+    // 调用方保留上一帧结果即可，下一次读取会拿到更新的数据
+    bool readLatest(float *dest, int frames) const
+    {
+        if (frames <= 0 || static_cast<quint64>(frames) > m_capacity) return false;
+
+        const quint64 end = m_writeIndex.load(std::memory_order_acquire);
+        if (end < static_cast<quint64>(frames)) return false;
+        const quint64 start = end - frames;
+
+        for (int i = 0; i < frames; ++i) {
+            dest[i] = m_frames[(start + i) & m_mask].load(std::memory_order_relaxed);
+        }
+
+        // 若生产者已声明覆盖到 start 之后的槽位，本次复制可能混入新数据
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 claimed = m_claimIndex.load(std::memory_order_relaxed);
+        return claimed <= start + m_capacity;
+    }
+
+private:
+    static quint64 roundUpPowerOfTwo(int value)
+    {
+        quint64 result = 1;
+        while (result < static_cast<quint64>(qMax(value, 1))) result <<= 1;
+        return result;
+    }
+};
+
+#endif // PCMRINGBUFFER_H
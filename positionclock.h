@@ -0,0 +1,101 @@
+#ifndef POSITIONCLOCK_H
+#define POSITIONCLOCK_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+#include <cmath>
+
+// 插值播放位置时钟
+// QMediaPlayer::positionChanged 上报稀疏且带抖动；本类以最近的上报为锚点按经过时间外推，
+// 小误差逐步修正（不跳变），大误差（跳转、缓冲）直接对齐，并减去输出延迟得到"听到的"位置。
+// 所有方法都有显式传入当前时间的重载，便于用模拟时钟驱动
+class PositionClock
+{
+private:
+    static const int SNAP_MS = 150;             // 误差超过该值直接对齐
+    static const int MAX_EXTRAPOLATE_MS = 1000; // 超过该时间没有上报则停止外推（卡顿）
+    static constexpr double SLEW = 0.05;        // 小误差每次上报修正的比例（±20ms 抖动下误差不超过 10ms）
+
+    QElapsedTimer m_timer;
+    double m_anchorPosition = 0.0;   // 锚点处的媒体位置（毫秒）
+    qint64 m_anchorTime = 0;         // 锚点时刻（m_timer 毫秒）
+    qint64 m_lastReportTime = -1;    // 最近一次上报时刻
+    double m_rate = 1.0;             // 播放速率
+    bool m_running = false;          // 是否正在播放
+    int m_latencyMs = 0;             // 输出延迟补偿
+
+public:
+    PositionClock() { m_timer.start(); }
+
+    // 当前时刻（毫秒，单调）
+    qint64 now() const { return m_timer.elapsed(); }
+
+    // 输出延迟：音频从上报位置到真正被听到的时间（蓝牙设备通常 150~300ms）
+    void setLatency(int ms) { m_latencyMs = qMax(0, ms); }
+    int latency() const { return m_latencyMs; }
+
+    bool isRunning() const { return m_running; }
+
+    void setRunning(bool running) { setRunning(running, now()); }
+    void setRunning(bool running, qint64 nowMs)
+    {
+        if (running == m_running) return;
+        // 先把锚点推进到当前时刻，再切换状态
+        m_anchorPosition = mediaPosition(nowMs);
+        m_anchorTime = nowMs;
+        m_lastReportTime = nowMs;
+        m_running = running;
+    }
+
+    void setRate(double rate) { setRate(rate, now()); }
+    void setRate(double rate, qint64 nowMs)
+    {
+        m_anchorPosition = mediaPosition(nowMs);
+        m_anchorTime = nowMs;
+        m_rate = rate > 0.0 ? rate : 1.0;
+    }
+
+    // 播放器上报的位置
+    void report(qint64 position) { report(position, now()); }
+    void report(qint64 position, qint64 nowMs)
+    {
+        const double predicted = mediaPosition(nowMs);
+        const double error = position - predicted;
+        if (!m_running || m_lastReportTime < 0 || qAbs(error) > SNAP_MS) {
+            m_anchorPosition = position;
+        } else {
+            m_anchorPosition = predicted + error * SLEW;
+        }
+        m_anchorTime = nowMs;
+        m_lastReportTime = nowMs;
+    }
+
+    // 听到的位置（媒体位置减去输出延迟）
+    qint64 position() const { return position(now()); }
+    qint64 position(qint64 nowMs) const
+    {
+        return qMax<qint64>(0, qRound64(mediaPosition(nowMs)) - m_latencyMs);
+    }
+
+    // 听到的位置到达 target 还需多少毫秒（暂停时返回 -1）
+    qint64 msUntil(qint64 target) const { return msUntil(target, now()); }
+    qint64 msUntil(qint64 target, qint64 nowMs) const
+    {
+        if (!m_running) return -1;
+        return qMax<qint64>(0, static_cast<qint64>(std::ceil((target - position(nowMs)) / m_rate)));
+    }
+
+private:
+    // 外推的媒体位置
+    double mediaPosition(qint64 nowMs) const
+    {
+        if (!m_running) return m_anchorPosition;
+        qint64 elapsed = nowMs - m_anchorTime;
+        if (m_lastReportTime >= 0) {
+            elapsed = qMin(elapsed, m_lastReportTime + MAX_EXTRAPOLATE_MS - m_anchorTime);
+        }
+        return m_anchorPosition + qMax<qint64>(0, elapsed) * m_rate;
+    }
+};
+
+#endif // POSITIONCLOCK_H
@@ -0,0 +1,198 @@
+#ifndef SPECTRUMANALYZER_H
+#define SPECTRUMANALYZER_H
+
+#include <QVector>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <cmath>
+#include "spectrumbands.h"
+
+// 实数 FFT 频谱分析器
+// 流程：单声道 PCM -> Hann 窗 -> N 点实数 FFT（N/2 点复数基2 FFT + 拆分）-> 频带映射
+// 频带表在编译期生成（见 spectrumbands.h），setSampleRate() 只切换表指针，analyze() 热路径不分配内存
+class SpectrumAnalyzer
+{
+private:
+    int m_fftSize;                      // FFT 点数（2 的幂）
+    int m_half;                         // 复数 FFT 点数 N/2
+    int m_barCount;                     // 输出频谱条数量
+    int m_sampleRate;                   // 采样率
+    const BandTable *m_bandTable;       // 编译期频带表
+    const BandRange *m_ranges;          // 当前采样率对应的频带范围
+
+    QVector<float> m_window;            // Hann 窗系数
+    QVector<int> m_bitReverse;          // 位反转置换表（长度 N/2）
+    QVector<float> m_twiddleRe;         // 复数 FFT 旋转因子（长度 N/4）
+    QVector<float> m_twiddleIm;
+    QVector<float> m_splitRe;           // 实数拆分旋转因子 e^{-2πik/N}（长度 N/2）
+    QVector<float> m_splitIm;
+    QVector<float> m_re;                // 复数 FFT 工作区
+    QVector<float> m_im;
+    QVector<float> m_magnitude;         // 幅度谱（长度 N/2 + 1）
+
+    // 性能统计
+    qint64 m_lastCostNs;                // 最近一次分析耗时
+    double m_averageCostNs;             // 平滑后的平均耗时
+
+public:
+    // 频谱显示范围（dB）
+    static constexpr float MIN_DB = -70.0f;
+    static constexpr float MAX_DB = 0.0f;
+
+    // 条数与 FFT 点数由频带表决定，例如 BandLayout<BandScale::Mel, 128, 4096>::Table
+    explicit SpectrumAnalyzer(const BandTable &bands = BandLayout<BandScale::Log>::Table)
+        : m_fftSize(bands.fftSize)
+        , m_half(bands.fftSize / 2)
+        , m_barCount(bands.count)
+        , m_sampleRate(0)
+        , m_bandTable(&bands)
+        , m_ranges(nullptr)
+        , m_lastCostNs(0)
+        , m_averageCostNs(0.0)
+    {
+        // Hann 窗
+        m_window.resize(m_fftSize);
+        for (int i = 0; i < m_fftSize; ++i) {
+            m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / m_fftSize));
+        }
+
+        // 位反转表
+        int bits = 0;
+        while ((1 << bits) < m_half) ++bits;
+        m_bitReverse.resize(m_half);
+        for (int i = 0; i < m_half; ++i) {
+            int r = 0;
+            for (int b = 0; b < bits; ++b) {
+                if (i & (1 << b)) r |= 1 << (bits - 1 - b);
+            }
+            m_bitReverse[i] = r;
+        }
+
+        // 复数 FFT 旋转因子 e^{-2πik/(N/2)}
+        m_twiddleRe.resize(m_half / 2);
+        m_twiddleIm.resize(m_half / 2);
+        for (int k = 0; k < m_half / 2; ++k) {
+            double angle = -2.0 * M_PI * k / m_half;
+            m_twiddleRe[k] = static_cast<float>(std::cos(angle));
+            m_twiddleIm[k] = static_cast<float>(std::sin(angle));
+        }
+
+        // 实数拆分旋转因子 e^{-2πik/N}
+        m_splitRe.resize(m_half);
+        m_splitIm.resize(m_half);
+        for (int k = 0; k < m_half; ++k) {
+            double angle = -2.0 * M_PI * k / m_fftSize;
+            m_splitRe[k] = static_cast<float>(std::cos(angle));
+            m_splitIm[k] = static_cast<float>(std::sin(angle));
+        }
+
+        m_re.resize(m_half);
+        m_im.resize(m_half);
+        m_magnitude.resize(m_half + 1);
+
+        setSampleRate(44100);
+    }
+
+    int fftSize() const { return m_fftSize; }
+    int barCount() const { return m_barCount; }
+    int sampleRate() const { return m_sampleRate; }
+
+    // 最近一次 / 平均单次分析耗时（纳秒），用于确认 CPU 占用
+    qint64 lastCostNs() const { return m_lastCostNs; }
+    double averageCostNs() const { return m_averageCostNs; }
+
+    // 设置采样率：选用最接近的预生成频带表
+    void setSampleRate(int sampleRate)
+    {
+        if (sampleRate <= 0 || sampleRate == m_sampleRate) return;
+        m_sampleRate = sampleRate;
+        m_ranges = m_bandTable->forSampleRate(sampleRate);
+    }
+
+    // 分析一帧：samples 长度必须为 fftSize()，bars 长度为 barCount()，输出范围 [0, 1]
+    void analyze(const float *samples, float *bars)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        // 加窗并按偶/奇打包为复数序列 z[k] = x[2k] + i·x[2k+1]，同时做位反转置换
+        const float *w = m_window.constData();
+        float *re = m_re.data();
+        float *im = m_im.data();
+        const int *rev = m_bitReverse.constData();
+        for (int k = 0; k < m_half; ++k) {
+            int j = rev[k];
+            re[j] = samples[2 * k] * w[2 * k];
+            im[j] = samples[2 * k + 1] * w[2 * k + 1];
+        }
+
+        fftInPlace(re, im);
+
+        // 拆分得到实数序列的频谱：
+        // X[k] = (Z[k] + conj(Z[M-k])) / 2 - i·W^k·(Z[k] - conj(Z[M-k])) / 2
+        float *mag = m_magnitude.data();
+        const float *sr = m_splitRe.constData();
+        const float *si = m_splitIm.constData();
+        mag[0] = std::fabs(re[0] + im[0]);
+        mag[m_half] = std::fabs(re[0] - im[0]);
+        for (int k = 1; k < m_half; ++k) {
+            const float zr = re[k], zi = im[k];
+            const float cr = re[m_half - k], ci = -im[m_half - k];
+            const float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);     // 偶部
+            const float dr = 0.5f * (zr - cr), di = 0.5f * (zi - ci);     // 奇部 * i
+            // 奇部 O = -i·D，再乘旋转因子
+            const float or_ = di, oi = -dr;
+            const float tr = or_ * sr[k] - oi * si[k];
+            const float ti = or_ * si[k] + oi * sr[k];
+            const float xr = er + tr, xi = ei + ti;
+            mag[k] = std::sqrt(xr * xr + xi * xi);
+        }
+
+        // 映射到频谱条：取频带内最大幅度，乘以频带增益，换算为 dB 后归一化
+        // Hann 窗相干增益为 0.5，满幅正弦的峰值幅度为 N/4
+        const float norm = 4.0f / m_fftSize;
+        const float range = MAX_DB - MIN_DB;
+        const BandRange *ranges = m_ranges;
+        for (int b = 0; b < m_barCount; ++b) {
+            float peak = 0.0f;
+            for (int k = ranges[b].firstBin; k <= ranges[b].lastBin; ++k) {
+                peak = qMax(peak, mag[k]);
+            }
+            float db = 20.0f * std::log10(peak * ranges[b].weight * norm + 1e-9f);
+            bars[b] = qBound(0.0f, (db - MIN_DB) / range, 1.0f);
+        }
+
+        m_lastCostNs = timer.nsecsElapsed();
+        m_averageCostNs = m_averageCostNs <= 0.0
+            ? m_lastCostNs
+            : m_averageCostNs * 0.95 + m_lastCostNs * 0.05;
+    }
+
+private:
+    // 迭代式基2 复数 FFT（输入已按位反转排列）
+    void fftInPlace(float *re, float *im)
+    {
+        const float *twr = m_twiddleRe.constData();
+        const float *twi = m_twiddleIm.constData();
+        for (int size = 2; size <= m_half; size <<= 1) {
+            const int halfSize = size >> 1;
+            const int step = m_half / size;
+            for (int start = 0; start < m_half; start += size) {
+                for (int j = 0; j < halfSize; ++j) {
+                    const float wr = twr[j * step];
+                    const float wi = twi[j * step];
+                    const int a = start + j;
+                    const int b = a + halfSize;
+                    const float tr = re[b] * wr - im[b] * wi;
+                    const float ti = re[b] * wi + im[b] * wr;
+                    re[b] = re[a] - tr;
+                    im[b] = im[a] - ti;
+                    re[a] += tr;
+                    im[a] += ti;
+                }
+            }
+        }
+    }
+};
+
+#endif // SPECTRUMANALYZER_H
@@ -0,0 +1,193 @@
+#ifndef SPECTRUMBANDS_H
+#define SPECTRUMBANDS_H
+
+#include <array>
+
+// 频带划分方式
+enum class BandScale
+{
+    Log,            // 对数等分
+    Octave,         // 1/1 倍频程（ISO 基 2 中心频率）
+    ThirdOctave,    // 1/3 倍频程
+    Mel             // Mel 刻度等分
+};
+
+// 单个频谱条对应的 FFT bin 范围与增益
+struct BandRange
+{
+    int firstBin;   // 起始 bin
+    int lastBin;    // 结束 bin（含）
+    float weight;   // 幅度增益：+3dB/倍频程（相对 1kHz）补偿音乐频谱的自然下倾
+};
+
+// 频带表描述：按常见采样率各生成一份，运行时只做指针选择
+struct BandTable
+{
+    static constexpr int RATE_COUNT = 4;
+    static constexpr int RATES[RATE_COUNT] = {44100, 48000, 88200, 96000};
+
+    int count;                              // 频谱条数量
+    int fftSize;                            // 对应的 FFT 点数
+    const BandRange *ranges[RATE_COUNT];    // 与 RATES 一一对应
+
+    // 选择与采样率最接近的一份表
+    const BandRange *forSampleRate(int sampleRate) const
+    {
+        int best = 0;
+        for (int i = 1; i < RATE_COUNT; ++i) {
+            int d = RATES[i] - sampleRate;
+            int bestD = RATES[best] - sampleRate;
+            if ((d < 0 ? -d : d) < (bestD < 0 ? -bestD : bestD)) best = i;
+        }
+        return ranges[best];
+    }
+};
+
+// 编译期频带计算（C++17 constexpr，标准库数学函数在此不可用，故自行实现）
+class SpectrumBands
+{
+public:
+    static constexpr double MIN_FREQ = 40.0;       // 频带下限（Hz）
+    static constexpr double MAX_FREQ = 16000.0;    // 频带上限（Hz）
+    static constexpr double LN2 = 0.69314718055994530942;
+
+    // 自然对数：x = m·2^k，m ∈ [1, 2)，ln(m) 用 atanh 级数
+    static constexpr double ln(double x)
+    {
+        int k = 0;
+        while (x >= 2.0) { x /= 2.0; ++k; }
+        while (x < 1.0) { x *= 2.0; --k; }
+        const double z = (x - 1.0) / (x + 1.0);
+        const double z2 = z * z;
+        double term = z;
+        double sum = 0.0;
+        for (int n = 1; n < 60; n += 2) {
+            sum += term / n;
+            term *= z2;
+        }
+        return 2.0 * sum + k * LN2;
+    }
+
+    // 指数：x = k·ln2 + r，|r| <= ln2/2，exp(r) 用泰勒级数
+    static constexpr double exp(double x)
+    {
+        const int k = static_cast<int>(x / LN2 + (x >= 0 ? 0.5 : -0.5));
+        const double r = x - k * LN2;
+        double term = 1.0;
+        double sum = 1.0;
+        for (int n = 1; n < 30; ++n) {
+            term *= r / n;
+            sum += term;
+        }
+        double scale = 1.0;
+        for (int i = 0; i < (k < 0 ? -k : k); ++i) scale *= 2.0;
+        return k < 0 ? sum / scale : sum * scale;
+    }
+
+    static constexpr double pow(double base, double exponent) { return exp(exponent * ln(base)); }
+    static constexpr double log2(double x) { return ln(x) / LN2; }
+
+    static constexpr int floorToInt(double x)
+    {
+        int i = static_cast<int>(x);
+        return (x < i) ? i - 1 : i;
+    }
+    static constexpr int ceilToInt(double x)
+    {
+        int i = static_cast<int>(x);
+        return (x > i) ? i + 1 : i;
+    }
+
+    static constexpr double hzToMel(double hz) { return 2595.0 * ln(1.0 + hz / 700.0) / ln(10.0); }
+    static constexpr double melToHz(double mel) { return 700.0 * (pow(10.0, mel / 2595.0) - 1.0); }
+
+    // 1/N 倍频程：中心频率 1000·2^(k/N) 落在 [MIN_FREQ, MAX_FREQ] 内的 k 范围
+    static constexpr int octaveFirstIndex(int fraction) { return ceilToInt(fraction * log2(MIN_FREQ / 1000.0)); }
+    static constexpr int octaveLastIndex(int fraction) { return floorToInt(fraction * log2(MAX_FREQ / 1000.0)); }
+    static constexpr int octaveBandCount(int fraction)
+    {
+        return octaveLastIndex(fraction) - octaveFirstIndex(fraction) + 1;
+    }
+
+    // 第 band 条的下边缘与上边缘（Hz）
+    static constexpr double lowerEdge(BandScale scale, int count, int band)
+    {
+        switch (scale) {
+        case BandScale::Octave:
+        case BandScale::ThirdOctave: {
+            const int fraction = (scale == BandScale::Octave) ? 1 : 3;
+            const double center = 1000.0 * pow(2.0, double(octaveFirstIndex(fraction) + band) / fraction);
+            return center * pow(2.0, -0.5 / fraction);
+        }
+        case BandScale::Mel: {
+            const double lo = hzToMel(MIN_FREQ);
+            const double hi = hzToMel(MAX_FREQ);
+            return melToHz(lo + (hi - lo) * band / count);
+        }
+        case BandScale::Log:
+        default:
+            return MIN_FREQ * pow(MAX_FREQ / MIN_FREQ, double(band) / count);
+        }
+    }
+    static constexpr double upperEdge(BandScale scale, int count, int band)
+    {
+        if (scale == BandScale::Octave || scale == BandScale::ThirdOctave) {
+            const int fraction = (scale == BandScale::Octave) ? 1 : 3;
+            return lowerEdge(scale, count, band) * pow(2.0, 1.0 / fraction);
+        }
+        return lowerEdge(scale, count, band + 1);
+    }
+};
+
+// 编译期生成的频带表
+// Log / Mel 的条数由 Bars 指定；倍频程布局的条数由频率范围决定，Bars 被忽略
+// 用法：SpectrumWidget(parent, BandLayout<BandScale::Mel, 256, 4096>::Table)
+template <BandScale Scale, int Bars = 64, int FftSize = 2048>
+struct BandLayout
+{
+    static_assert(FftSize >= 16 && (FftSize & (FftSize - 1)) == 0, "FftSize 必须是 2 的幂");
+
+    static constexpr int Count =
+        Scale == BandScale::Octave      ? SpectrumBands::octaveBandCount(1) :
+        Scale == BandScale::ThirdOctave ? SpectrumBands::octaveBandCount(3) : Bars;
+    static_assert(Count > 0, "频谱条数量必须大于 0");
+
+    // 低频处一个 bin 可能跨越多条，起始 bin 强制大于上一条的结束 bin，
+    // 保证各条 bin 严格递增、不出现重复的列（bin 用尽时才停在最高 bin）
+    template <int SampleRate>
+    static constexpr std::array<BandRange, Count> build()
+    {
+        std::array<BandRange, Count> ranges{};
+        const double binHz = double(SampleRate) / FftSize;
+        const int maxBin = FftSize / 2;
+        int prevLast = 0;
+        for (int b = 0; b < Count; ++b) {
+            const double low = SpectrumBands::lowerEdge(Scale, Count, b);
+            const double high = SpectrumBands::upperEdge(Scale, Count, b);
+            int first = SpectrumBands::floorToInt(low / binHz);
+            first = first > prevLast + 1 ? first : prevLast + 1;
+            int last = SpectrumBands::ceilToInt(high / binHz) - 1;
+            last = last < first ? first : last;
+            first = first > maxBin ? maxBin : first;
+            last = last > maxBin ? maxBin : last;
+            prevLast = last < maxBin - 1 ? last : maxBin - 1;
+
+            const double center = SpectrumBands::pow(2.0, (SpectrumBands::log2(low) + SpectrumBands::log2(high)) / 2.0);
+            const float weight = static_cast<float>(SpectrumBands::pow(center / 1000.0, 0.5));
+            ranges[b] = BandRange{first, last, weight};
+        }
+        return ranges;
+    }
+
+    static constexpr std::array<BandRange, Count> Ranges44100 = build<44100>();
+    static constexpr std::array<BandRange, Count> Ranges48000 = build<48000>();
+    static constexpr std::array<BandRange, Count> Ranges88200 = build<88200>();
+    static constexpr std::array<BandRange, Count> Ranges96000 = build<96000>();
+
+    static constexpr BandTable Table = {
+        Count, FftSize,
+        { Ranges44100.data(), Ranges48000.data(), Ranges88200.data(), Ranges96000.data() }
+    };
+};
+
+#endif // SPECTRUMBANDS_H
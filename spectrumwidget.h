@@ -3,20 +3,27 @@
 
 #include <QWidget>
 #include <QPainter>
+#include <QPixmap>
+#include <QRegion>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QPaintEvent>
 #include <QTimer>
-#include <QRandomGenerator>
 #include <QLinearGradient>
 #include <QtMath>
 #include <QMediaPlayer>
-#include <QAudioSink>
+#include "spectrumanalyzer.h"
+#include "audiotap.h"
 
 // 音频频谱可视化组件（Qt6 版本）
 class SpectrumWidget : public QWidget
 {
     Q_OBJECT
 
+    friend class TestSpectrumWidget;        // 基准测试直接设置条高
+
 private:
-    static const int BAR_COUNT = 64;        // 频谱条数量
+    int m_barCount;                         // 频谱条数量（由频带表决定）
     QVector<double> m_barHeights;           // 每个频谱条的高度
     QVector<double> m_targetHeights;        // 目标高度（用于平滑动画）
     QVector<double> m_peakHeights;          // 峰值高度
@@ -24,6 +31,10 @@ private:
     
     QTimer *m_updateTimer;                  // 更新定时器
     QMediaPlayer *m_player;                 // 关联的播放器
+    AudioTap *m_audioTap;                   // 解码 PCM 抽头
+    SpectrumAnalyzer m_analyzer;            // FFT 频谱分析器
+    QVector<float> m_samples;               // 分析窗口样本
+    QVector<float> m_bands;                 // 分析结果（每条 0~1）
     
     bool m_isPlaying;                       // 是否正在播放
     int m_colorOffset;                      // 颜色偏移（用于渐变动画）
@@ -33,33 +44,81 @@ private:
     int m_barSpacing;                       // 频谱条间距
     QColor m_backgroundColor;               // 背景色
     
+    // 精灵图集：每个色相步进一列满高渐变条，底部一行为峰值帽
+    static const int HUE_STEP = 3;          // 色相步进（度），与颜色动画步长一致
+    static const int HUE_STEPS = 360 / HUE_STEP;
+    static const int PEAK_CAP_HEIGHT = 3;   // 峰值帽高度
+    QPixmap m_barAtlas;                     // 预渲染图集
+    QSize m_atlasKey;                       // 图集对应的（条宽，条区高度）
+    
+    // 帧率调度：不可见时停止，空闲时降频，只重绘变化的区域
+    static const int ACTIVE_INTERVAL = 50;  // 播放时 20fps
+    static const int IDLE_INTERVAL = 125;   // 空闲（呼吸灯）时 8fps
+    QVector<int> m_drawnBarTop;             // 已提交重绘的条顶部 y
+    QVector<int> m_drawnPeakTop;            // 已提交重绘的峰值帽 y（-1 表示未显示）
+    QVector<int> m_drawnColumn;             // 已提交重绘的色相列
+    bool m_fullRepaint;                     // 下一帧需要整体重绘
+    double m_breathPhase;                   // 呼吸灯相位
+    QWidget *m_watchedWindow;               // 监听最小化的顶层窗口
+    QElapsedTimer m_fpsClock;               // 帧率统计计时
+    int m_frameCount;                       // 统计周期内的绘制帧数
+    double m_effectiveFps;                  // 实际绘制帧率
+    
+    // 节拍联动：锁定 BPM 后颜色只在节拍处跳变，条高随节拍脉冲
+    static const int BEAT_HUE_SHIFT = 30;   // 每拍色相跳变（度，HUE_STEP 的整数倍）
+    static constexpr double BEAT_BOOST = 0.25;  // 节拍脉冲对目标高度的放大量
+    static constexpr double PULSE_DECAY = 0.7;  // 脉冲每帧衰减
+    double m_bpm;                           // 当前 BPM，0 表示未锁定
+    double m_beatPulse;                     // 节拍脉冲 0~1
+    
 public:
-    explicit SpectrumWidget(QWidget *parent = nullptr)
+    // 频带布局在编译期选定，例如 BandLayout<BandScale::ThirdOctave>::Table
+    explicit SpectrumWidget(QWidget *parent = nullptr,
+                            const BandTable &bands = BandLayout<BandScale::Log, 64>::Table)
         : QWidget(parent)
+        , m_barCount(bands.count)
+        , m_player(nullptr)
+        , m_analyzer(bands)
         , m_isPlaying(false)
         , m_colorOffset(0)
         , m_barWidth(8)
         , m_barSpacing(2)
         , m_backgroundColor(QColor(20, 20, 30))
-        , m_player(nullptr)
+        , m_fullRepaint(true)
+        , m_breathPhase(0.0)
+        , m_watchedWindow(nullptr)
+        , m_frameCount(0)
+        , m_effectiveFps(0.0)
+        , m_bpm(0.0)
+        , m_beatPulse(0.0)
     {
         // 初始化频谱数据，设置初始高度避免完全为0
-        m_barHeights.resize(BAR_COUNT);
-        m_targetHeights.resize(BAR_COUNT);
-        m_peakHeights.resize(BAR_COUNT);
-        m_peakHoldTime.resize(BAR_COUNT);
+        m_barHeights.resize(m_barCount);
+        m_targetHeights.resize(m_barCount);
+        m_peakHeights.resize(m_barCount);
+        m_peakHoldTime.resize(m_barCount);
         
-        for (int i = 0; i < BAR_COUNT; ++i) {
+        for (int i = 0; i < m_barCount; ++i) {
             m_barHeights[i] = 0.12;
             m_targetHeights[i] = 0.12;
             m_peakHeights[i] = 0.12;
             m_peakHoldTime[i] = 0;
         }
+        m_drawnBarTop.fill(-1, m_barCount);
+        m_drawnPeakTop.fill(-1, m_barCount);
+        m_drawnColumn.fill(-1, m_barCount);
+        
+        m_samples.resize(m_analyzer.fftSize());
+        m_bands.resize(m_barCount);
+        m_audioTap = new AudioTap(this);
+        connect(m_audioTap, &AudioTap::beatDetected, this, &SpectrumWidget::onBeat);
+        connect(m_audioTap, &AudioTap::tempoChanged, this, [this](double bpm) {
+            m_bpm = bpm;
+        });
         
-        // 设置定时器
+        // 设置定时器（显示后由 updatePacing() 按可见性和播放状态启动）
         m_updateTimer = new QTimer(this);
         connect(m_updateTimer, &QTimer::timeout, this, &SpectrumWidget::updateSpectrum);
-        m_updateTimer->start(50); // 20fps
         
         // 设置最小尺寸
         setMinimumHeight(150);
@@ -78,103 +137,325 @@ public:
     // 关联媒体播放器
     void setMediaPlayer(QMediaPlayer *player)
     {
+        // 支持切换播放器（无缝播放时两个播放器轮换）
+        if (m_player) {
+            disconnect(m_player, nullptr, this, nullptr);
+        }
         m_player = player;
         
-        // Qt6 中音频探针已被移除，这里使用简化的模拟频谱
-        // 实际项目中可以使用 QAudioSink 和自定义音频处理
+        // Qt6 中音频探针已被移除，由 AudioTap 独立解码同一音源提供 PCM
+        m_audioTap->setMediaPlayer(m_player);
         if (m_player) {
             connect(m_player, &QMediaPlayer::playbackStateChanged, this, 
                     [this](QMediaPlayer::PlaybackState state) {
-                m_isPlaying = (state == QMediaPlayer::PlayingState);
-                if (!m_isPlaying) {
-                    resetSpectrum();
-                }
+                setPlaying(state == QMediaPlayer::PlayingState);
             });
         }
     }
     
+    int barCount() const { return m_barCount; }
+    
+    // 单帧频谱分析的平均耗时（纳秒）
+    double analysisCostNs() const { return m_analyzer.averageCostNs(); }
+    
+    // 实际绘制帧率（每秒统计一次，停止刷新时为 0）
+    double effectiveFps() const { return m_effectiveFps; }
+    
+    // 当前 BPM 估计与节拍检测平均每块耗时（纳秒）
+    double bpm() const { return m_bpm; }
+    qint64 beatCostNs() const { return m_audioTap->beatCostNs(); }
+    
     // 设置播放状态
     void setPlaying(bool playing)
     {
+        if (playing == m_isPlaying) return;
         m_isPlaying = playing;
         if (!playing) {
             resetSpectrum();
         }
+        // 标题文字随播放状态出现/消失，需要整体重绘
+        m_fullRepaint = true;
+        updatePacing();
     }
     
+signals:
+    void effectiveFpsChanged(double fps);
+    // 播放中检测到节拍，供其他组件同步动画
+    void beatDetected(float strength, double bpm);
+    
 protected:
+    void showEvent(QShowEvent *event) override
+    {
+        QWidget::showEvent(event);
+        
+        // 监听顶层窗口的最小化/还原
+        if (m_watchedWindow != window()) {
+            if (m_watchedWindow) m_watchedWindow->removeEventFilter(this);
+            m_watchedWindow = window();
+            m_watchedWindow->installEventFilter(this);
+        }
+        m_fullRepaint = true;
+        updatePacing();
+    }
+    
+    void hideEvent(QHideEvent *event) override
+    {
+        QWidget::hideEvent(event);
+        updatePacing();
+    }
+    
+    void resizeEvent(QResizeEvent *event) override
+    {
+        QWidget::resizeEvent(event);
+        updateBarGeometry();
+        m_fullRepaint = true;
+    }
+    
+    bool eventFilter(QObject *obj, QEvent *event) override
+    {
+        if (obj == m_watchedWindow && event->type() == QEvent::WindowStateChange) {
+            updatePacing();
+        }
+        return QWidget::eventFilter(obj, event);
+    }
+    
     void paintEvent(QPaintEvent *event) override
     {
         Q_UNUSED(event);
+        ++m_frameCount;
         
         QPainter painter(this);
-        painter.setRenderHint(QPainter::Antialiasing);
         
         // 绘制背景
         painter.fillRect(rect(), m_backgroundColor);
         
-        // 计算频谱条的总宽度
-        int totalWidth = BAR_COUNT * (m_barWidth + m_barSpacing) - m_barSpacing;
-        int startX = (width() - totalWidth) / 2;
+        const int areaHeight = height() - 20;
+        if (areaHeight <= 0) return;
+        ensureBarAtlas(areaHeight);
+        const qreal dpr = m_barAtlas.devicePixelRatio();
         
-        // 绘制频谱条
-        for (int i = 0; i < BAR_COUNT; ++i) {
-            int x = startX + i * (m_barWidth + m_barSpacing);
-            
-            // 强制确保最小高度
-            double displayHeight = qMax(0.12, m_barHeights[i]);
-            int barHeight = static_cast<int>(displayHeight * (height() - 20));
-            barHeight = qMax(8, barHeight);
-            int y = height() - barHeight - 10;
-            
-            // 创建渐变色
-            double hue = fmod((i * 360.0 / BAR_COUNT + m_colorOffset), 360.0) / 360.0;
-            QColor color1 = QColor::fromHsvF(hue, 0.95, 1.0);
-            QColor color2 = QColor::fromHsvF(hue, 0.75, 0.8);
+        // 从图集中裁剪子矩形贴图，不再逐帧创建渐变；只绘制与重绘区域相交的条
+        const QRect dirty = event->rect();
+        for (int i = 0; i < m_barCount; ++i) {
+            int x = barX(i);
+            if (x + m_barWidth <= dirty.left() || x > dirty.right()) continue;
+            qreal atlasX = hueColumn(i) * m_barWidth * dpr;
             
-            QLinearGradient gradient(x, y + barHeight, x, y);
-            gradient.setColorAt(0, color1);
-            gradient.setColorAt(1, color2);
-            
-            // 绘制频谱条
-            painter.setBrush(gradient);
-            painter.setPen(Qt::NoPen);
-            painter.drawRoundedRect(x, y, m_barWidth, barHeight, 2, 2);
+            // 绘制频谱条：取该色相列底部 barHeight 像素
+            int y = barTop(i);
+            int barHeight = height() - 10 - y;
+            painter.drawPixmap(QRectF(x, y, m_barWidth, barHeight), m_barAtlas,
+                               QRectF(atlasX, (areaHeight - barHeight) * dpr,
+                                      m_barWidth * dpr, barHeight * dpr));
             
             // 绘制峰值指示器
-            double peakDisplayHeight = qMax(0.12, m_peakHeights[i]);
-            if (peakDisplayHeight > 0.12) {
-                int peakY = height() - static_cast<int>(peakDisplayHeight * (height() - 20)) - 10;
-                QColor peakColor = QColor::fromHsvF(hue, 1.0, 1.0);
-                painter.setBrush(peakColor);
-                painter.drawRoundedRect(x, peakY - 2, m_barWidth, 3, 1, 1);
+            int peakY = peakTop(i);
+            if (peakY >= 0) {
+                painter.drawPixmap(QRectF(x, peakY, m_barWidth, PEAK_CAP_HEIGHT), m_barAtlas,
+                                   QRectF(atlasX, areaHeight * dpr,
+                                          m_barWidth * dpr, PEAK_CAP_HEIGHT * dpr));
             }
         }
         
         // 绘制标题
         if (!m_isPlaying) {
+            painter.setRenderHint(QPainter::Antialiasing);
             painter.setPen(QColor(150, 150, 170, 180));
             painter.setFont(QFont("Microsoft YaHei", 11));
             painter.drawText(rect().adjusted(0, -30, 0, 0), Qt::AlignCenter, "♪ 音频频谱可视化 ♪");
         }
     }
     
+private:
+    // 条数较多时按宽度收窄条宽与间距（最宽 8 像素），保证所有条都能放下
+    void updateBarGeometry()
+    {
+        m_barSpacing = m_barCount > 128 ? 1 : 2;
+        m_barWidth = qBound(1, (width() + m_barSpacing) / m_barCount - m_barSpacing, 8);
+    }
+    
+    // 第 i 条的左侧 x
+    int barX(int i) const
+    {
+        int totalWidth = m_barCount * (m_barWidth + m_barSpacing) - m_barSpacing;
+        return (width() - totalWidth) / 2 + i * (m_barWidth + m_barSpacing);
+    }
+    
+    // 第 i 条的顶部 y（强制确保最小高度）
+    int barTop(int i) const
+    {
+        const int areaHeight = qMax(8, height() - 20);
+        double displayHeight = qMax(0.12, m_barHeights[i]);
+        int barHeight = qBound(8, static_cast<int>(displayHeight * areaHeight), areaHeight);
+        return height() - barHeight - 10;
+    }
+    
+    // 第 i 条峰值帽的顶部 y，不显示时返回 -1
+    int peakTop(int i) const
+    {
+        double peakDisplayHeight = qMax(0.12, m_peakHeights[i]);
+        if (peakDisplayHeight <= 0.12) return -1;
+        return qMax(0, height() - static_cast<int>(peakDisplayHeight * (height() - 20)) - 12);
+    }
+    
+    // 是否真正显示在屏幕上（所在页面可见且窗口未最小化）
+    bool isOnScreen() const
+    {
+        return isVisible() && !window()->isMinimized();
+    }
+    
+    // 根据可见性与播放状态调整定时器：不可见停止，空闲降频
+    void updatePacing()
+    {
+        if (!isOnScreen()) {
+            if (m_updateTimer->isActive()) {
+                m_updateTimer->stop();
+                setEffectiveFps(0.0);
+            }
+            return;
+        }
+        
+        const int interval = m_isPlaying ? ACTIVE_INTERVAL : IDLE_INTERVAL;
+        if (!m_updateTimer->isActive() || m_updateTimer->interval() != interval) {
+            m_updateTimer->start(interval);
+            m_fpsClock.start();
+            m_frameCount = 0;
+        }
+    }
+    
+    // 每秒统计一次实际绘制帧率
+    void sampleFps()
+    {
+        const qint64 elapsed = m_fpsClock.elapsed();
+        if (elapsed < 1000) return;
+        setEffectiveFps(m_frameCount * 1000.0 / elapsed);
+        m_frameCount = 0;
+        m_fpsClock.restart();
+    }
+    
+    void setEffectiveFps(double fps)
+    {
+        if (qFuzzyCompare(fps + 1.0, m_effectiveFps + 1.0)) return;
+        m_effectiveFps = fps;
+        emit effectiveFpsChanged(fps);
+    }
+    
+    // 只把几何或颜色发生变化的条加入重绘区域
+    void scheduleRepaint()
+    {
+        if (m_fullRepaint) {
+            m_fullRepaint = false;
+            for (int i = 0; i < m_barCount; ++i) {
+                m_drawnBarTop[i] = barTop(i);
+                m_drawnPeakTop[i] = peakTop(i);
+                m_drawnColumn[i] = hueColumn(i);
+            }
+            update();
+            return;
+        }
+        
+        const int bottom = height() - 10;
+        QRegion dirty;
+        for (int i = 0; i < m_barCount; ++i) {
+            const int x = barX(i);
+            const int top = barTop(i);
+            const int peak = peakTop(i);
+            const int column = hueColumn(i);
+            
+            if (column != m_drawnColumn[i]) {
+                // 颜色变化：整条重绘
+                int from = qMin(top, m_drawnBarTop[i]);
+                if (peak >= 0) from = qMin(from, peak);
+                if (m_drawnPeakTop[i] >= 0) from = qMin(from, m_drawnPeakTop[i]);
+                dirty += QRect(x, from, m_barWidth, bottom - from);
+            } else {
+                // 图集渐变与底部对齐，高度变化只影响新旧顶部之间的条带
+                if (top != m_drawnBarTop[i]) {
+                    int from = qMin(top, m_drawnBarTop[i]);
+                    dirty += QRect(x, from, m_barWidth, qAbs(top - m_drawnBarTop[i]));
+                }
+                if (peak != m_drawnPeakTop[i]) {
+                    if (m_drawnPeakTop[i] >= 0) dirty += QRect(x, m_drawnPeakTop[i], m_barWidth, PEAK_CAP_HEIGHT);
+                    if (peak >= 0) dirty += QRect(x, peak, m_barWidth, PEAK_CAP_HEIGHT);
+                }
+            }
+            
+            m_drawnBarTop[i] = top;
+            m_drawnPeakTop[i] = peak;
+            m_drawnColumn[i] = column;
+        }
+        
+        if (!dirty.isEmpty()) {
+            update(dirty);
+        }
+    }
+    
+    // 第 i 条当前色相对应的图集列
+    int hueColumn(int i) const
+    {
+        int hue = (i * 360 / m_barCount + m_colorOffset) % 360;
+        return hue / HUE_STEP;
+    }
+    
+    // 尺寸或条宽变化时重建图集（每个色相一列渐变条 + 峰值帽）
+    void ensureBarAtlas(int areaHeight)
+    {
+        const QSize key(m_barWidth, areaHeight);
+        const qreal dpr = devicePixelRatioF();
+        if (!m_barAtlas.isNull() && m_atlasKey == key && m_barAtlas.devicePixelRatio() == dpr) {
+            return;
+        }
+        m_atlasKey = key;
+        
+        const int atlasWidth = HUE_STEPS * m_barWidth;
+        const int atlasHeight = areaHeight + PEAK_CAP_HEIGHT;
+        m_barAtlas = QPixmap(QSize(atlasWidth, atlasHeight) * dpr);
+        m_barAtlas.setDevicePixelRatio(dpr);
+        m_barAtlas.fill(Qt::transparent);
+        
+        QPainter painter(&m_barAtlas);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        
+        for (int column = 0; column < HUE_STEPS; ++column) {
+            const int x = column * m_barWidth;
+            const double hue = column * HUE_STEP / 360.0;
+            
+            QLinearGradient gradient(x, areaHeight, x, 0);
+            gradient.setColorAt(0, QColor::fromHsvF(hue, 0.95, 1.0));
+            gradient.setColorAt(1, QColor::fromHsvF(hue, 0.75, 0.8));
+            painter.setBrush(gradient);
+            painter.drawRoundedRect(x, 0, m_barWidth, areaHeight, 2, 2);
+            
+            painter.setBrush(QColor::fromHsvF(hue, 1.0, 1.0));
+            painter.drawRoundedRect(x, areaHeight, m_barWidth, PEAK_CAP_HEIGHT, 1, 1);
+        }
+    }
+    
 private slots:
     // 更新频谱显示
     void updateSpectrum()
     {
-        m_colorOffset = (m_colorOffset + 3) % 360;
+        sampleFps();
         
         if (m_isPlaying) {
-            // 模拟音频频谱（实际项目中应该从音频数据计算）
-            for (int i = 0; i < BAR_COUNT; ++i) {
-                // 生成随机目标高度（模拟音频波动）
-                double randomValue = QRandomGenerator::global()->bounded(100) / 100.0;
-                double baseHeight = 0.2 + randomValue * 0.6;
-                
-                // 添加一些频率相关的变化
-                double freqFactor = 1.0 - (i / (double)BAR_COUNT) * 0.5;
-                m_targetHeights[i] = baseHeight * freqFactor;
+            // 颜色只在播放时轮转，空闲时保持不变以便局部重绘；
+            // 锁定 BPM 后改由节拍驱动（见 onBeat）
+            if (m_bpm <= 0.0) {
+                m_colorOffset = (m_colorOffset + HUE_STEP) % 360;
+            }
+            const double boost = 1.0 + BEAT_BOOST * m_beatPulse;
+            m_beatPulse *= PULSE_DECAY;
+            
+            // 取播放头处的 PCM 做 FFT；暂无数据（如网络音源）时目标高度归零
+            bool hasAudio = m_audioTap->copyLatest(m_samples.data(), m_samples.size());
+            if (hasAudio) {
+                m_analyzer.setSampleRate(m_audioTap->sampleRate());
+                m_analyzer.analyze(m_samples.constData(), m_bands.data());
+            }
+            
+            for (int i = 0; i < m_barCount; ++i) {
+                m_targetHeights[i] = hasAudio ? qMin(1.0, m_bands[i] * boost) : 0.0;
                 
                 // 平滑过渡
                 double diff = m_targetHeights[i] - m_barHeights[i];
@@ -200,33 +481,47 @@ private slots:
                 }
             }
         } else {
-            // 呼吸灯效果
-            static int breathCounter = 0;
-            breathCounter++;
-            double breathValue = 0.15 + 0.08 * qSin(breathCounter * 0.05);
+            // 呼吸灯效果（按实际刷新间隔推进，降频后速度不变）
+            const double ticks = m_updateTimer->interval() / double(ACTIVE_INTERVAL);
+            m_breathPhase += 0.05 * ticks;
+            double breathValue = 0.15 + 0.08 * qSin(m_breathPhase);
+            double decay = qPow(0.92, ticks);
             
-            for (int i = 0; i < BAR_COUNT; ++i) {
-                m_barHeights[i] *= 0.92;
+            for (int i = 0; i < m_barCount; ++i) {
+                m_barHeights[i] *= decay;
                 if (m_barHeights[i] < breathValue) {
                     m_barHeights[i] = breathValue;
                 }
                 
-                m_peakHeights[i] *= 0.92;
+                m_peakHeights[i] *= decay;
                 if (m_peakHeights[i] < breathValue) {
                     m_peakHeights[i] = breathValue;
                 }
             }
         }
         
-        update();
+        scheduleRepaint();
+    }
+    
+    // 节拍：色相跳变并触发脉冲
+    void onBeat(qint64 timeUs, float strength)
+    {
+        Q_UNUSED(timeUs);
+        if (!m_isPlaying) return;
+        m_beatPulse = qMax(m_beatPulse, double(strength));
+        if (m_bpm > 0.0) {
+            m_colorOffset = (m_colorOffset + BEAT_HUE_SHIFT) % 360;
+        }
+        emit beatDetected(strength, m_bpm);
     }
     
     // 重置频谱
     void resetSpectrum()
     {
-        for (int i = 0; i < BAR_COUNT; ++i) {
+        for (int i = 0; i < m_barCount; ++i) {
             m_targetHeights[i] = 0.0;
         }
+        m_beatPulse = 0.0;
     }
 };
 
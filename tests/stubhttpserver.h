@@ -0,0 +1,129 @@
+#ifndef STUBHTTPSERVER_H
+#define STUBHTTPSERVER_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QStringList>
+#include <functional>
+
+// 测试用的本地 HTTP 服务（只处理 GET）：按路径返回预设应答，也可以模拟不应答、直接断开连接
+// 支持长连接与流水线请求，与 QNetworkAccessManager 的默认行为一致
+class StubHttpServer
+{
+public:
+    enum Action
+    {
+        Respond,    // 返回 status 与 body
+        Hang,       // 不应答，连接保持打开（模拟超时）
+        Close       // 不应答，直接断开连接
+    };
+
+    struct Reply
+    {
+        Action action = Respond;
+        int status = 200;
+        QByteArray body;
+    };
+
+    // path 不含开头的 '/'，例如 "search"
+    using Handler = std::function<Reply(const QString &path, const QUrlQuery &query)>;
+
+    static Reply json(const QByteArray &body, int status = 200)
+    {
+        Reply reply;
+        reply.status = status;
+        reply.body = body;
+        return reply;
+    }
+
+    static Reply action(Action action)
+    {
+        Reply reply;
+        reply.action = action;
+        return reply;
+    }
+
+private:
+    QTcpServer m_server;
+    Handler m_handler;
+    QStringList m_requests;     // 收到的请求（路径加查询串，按到达顺序）
+
+public:
+    explicit StubHttpServer(const Handler &handler = Handler())
+        : m_handler(handler)
+    {
+        QObject::connect(&m_server, &QTcpServer::newConnection, &m_server, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+                QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() { onReadyRead(socket); });
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+    }
+
+    bool listen() { return m_server.listen(QHostAddress::LocalHost); }
+
+    void setHandler(const Handler &handler) { m_handler = handler; }
+
+    // 作为歌词来源基础地址使用，例如 "netease=" + baseUrl().toString()
+    QUrl baseUrl() const
+    {
+        return QUrl(QString("http://127.0.0.1:%1/").arg(m_server.serverPort()));
+    }
+
+    QStringList requests() const { return m_requests; }
+    void clearRequests() { m_requests.clear(); }
+
+    // 某个路径收到的请求数
+    int requestCount(const QString &path) const
+    {
+        int count = 0;
+        for (const QString &request : m_requests) {
+            if (request == path || request.startsWith(path + "?")) ++count;
+        }
+        return count;
+    }
+
+private:
+    void onReadyRead(QTcpSocket *socket)
+    {
+        // 已决定不应答的连接不再处理后续请求
+        if (socket->property("hung").toBool()) {
+            socket->readAll();
+            return;
+        }
+
+        QByteArray buffer = socket->property("buffer").toByteArray() + socket->readAll();
+        int end;
+        while ((end = buffer.indexOf("\r\n\r\n")) >= 0) {
+            const QByteArray head = buffer.left(end);
+            buffer.remove(0, end + 4);
+
+            // 请求行："GET /path?query HTTP/1.1"
+            const QList<QByteArray> parts = head.left(head.indexOf("\r\n")).split(' ');
+            const QUrl url(QString::fromUtf8(parts.value(1)));
+            const QString path = url.path().mid(1);
+            m_requests.append(url.hasQuery() ? path + "?" + url.query(QUrl::FullyDecoded) : path);
+
+            const Reply reply = m_handler ? m_handler(path, QUrlQuery(url)) : json(QByteArray(), 404);
+            if (reply.action == Close) {
+                socket->abort();
+                return;
+            }
+            if (reply.action == Hang) {
+                socket->setProperty("hung", true);
+                return;
+            }
+            QByteArray response = "HTTP/1.1 " + QByteArray::number(reply.status) + " Stub\r\n"
+                                  "Content-Type: application/json; charset=utf-8\r\n"
+                                  "Content-Length: " + QByteArray::number(reply.body.size()) + "\r\n"
+                                  "Connection: keep-alive\r\n\r\n";
+            socket->write(response + reply.body);
+        }
+        socket->setProperty("buffer", buffer);
+    }
+};
+
+#endif // STUBHTTPSERVER_H
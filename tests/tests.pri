@@ -0,0 +1,10 @@
+# 测试公共配置：各测试子项目 include 本文件
+QT       += testlib
+QT       -= gui
+
+CONFIG += c++17 testcase console
+CONFIG -= app_bundle
+
+# 被测代码均为头文件，直接引用项目根目录；测试公用的辅助头文件（如 stubhttpserver.h）在本目录
+# 用到的类含 Q_OBJECT 时，需在测试项目中把对应头文件列入 HEADERS，由 moc 处理
+INCLUDEPATH += $$PWD/.. $$PWD
@@ -0,0 +1,18 @@
+# 单元测试与基准测试
+# 运行：qmake tests.pro && make && make check
+# 基准测试结果随 make check 一并输出，也可单独运行测试程序并加 -bench 相关参数
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    tst_audioplayer \
+    tst_lyricdownloader \
+    tst_lyricfileindex \
+    tst_lyricparser \
+    tst_lyricprefetcher \
+    tst_lyricsearchindex \
+    tst_lyricwidget \
+    tst_networkresilience \
+    tst_pcmringbuffer \
+    tst_positionclock \
+    tst_spectrumanalyzer \
+    tst_spectrumwidget
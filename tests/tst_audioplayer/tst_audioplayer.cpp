@@ -0,0 +1,106 @@
+#include <QtTest>
+#include <QWidget>
+#include <QMediaDevices>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QSignalSpy>
+#include <QFile>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+#include "audioplayer.h"
+
+// AudioPlayer 无缝播放：连续播放几首短曲目，测量每次切换的曲间间隙
+// 间隙由播放器内的计时器与位置上报估算（受事件循环与上报间隔影响），不是按输出采样对齐的精确值
+class TestAudioPlayer : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int SAMPLE_RATE = 44100;
+    static const int CHANNELS = 2;
+    static const int TRACK_MS = 1500;
+    static const int TRACKS = 5;
+    static const int SETTLED_FROM = 2;      // 前两次切换用于自适应提前量，之后的才检查
+    static constexpr double MAX_GAP_MS = 50.0;
+
+    // 写一个 16 位 PCM WAV 正弦文件
+    static bool writeTone(const QString &path, double frequency, int durationMs)
+    {
+        const quint32 frames = quint32(qint64(SAMPLE_RATE) * durationMs / 1000);
+        const quint32 dataBytes = frames * CHANNELS * 2;
+        QByteArray wav(44 + dataBytes, Qt::Uninitialized);
+        uchar *p = reinterpret_cast<uchar *>(wav.data());
+        memcpy(p, "RIFF", 4);
+        qToLittleEndian<quint32>(36 + dataBytes, p + 4);
+        memcpy(p + 8, "WAVEfmt ", 8);
+        qToLittleEndian<quint32>(16, p + 16);
+        qToLittleEndian<quint16>(1, p + 20);                        // PCM
+        qToLittleEndian<quint16>(CHANNELS, p + 22);
+        qToLittleEndian<quint32>(SAMPLE_RATE, p + 24);
+        qToLittleEndian<quint32>(SAMPLE_RATE * CHANNELS * 2, p + 28);
+        qToLittleEndian<quint16>(CHANNELS * 2, p + 32);
+        qToLittleEndian<quint16>(16, p + 34);
+        memcpy(p + 36, "data", 4);
+        qToLittleEndian<quint32>(dataBytes, p + 40);
+
+        uchar *out = p + 44;
+        for (quint32 i = 0; i < frames; ++i) {
+            const qint16 sample = static_cast<qint16>(8000 * std::sin(2.0 * M_PI * frequency * i / SAMPLE_RATE));
+            for (int c = 0; c < CHANNELS; ++c, out += 2) qToLittleEndian<qint16>(sample, out);
+        }
+
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly) && file.write(wav) == wav.size();
+    }
+
+private slots:
+    void initTestCase()
+    {
+        // 缓存、预取队列等写到测试专用目录，不碰用户数据
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+    void measuresGapBetweenTracks()
+    {
+        if (QMediaDevices::audioOutputs().isEmpty()) {
+            QSKIP("没有音频输出设备");
+        }
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QStringList files;
+        for (int i = 0; i < TRACKS; ++i) {
+            const QString path = dir.filePath(QString("tone%1.wav").arg(i));
+            QVERIFY(writeTone(path, 220.0 * (i + 1), TRACK_MS));
+            files.append(path);
+        }
+
+        QWidget host;
+        AudioPlayer *player = new AudioPlayer(&host);
+        QSignalSpy spy(player, &AudioPlayer::transitionGapMeasured);
+        player->addFiles(files);
+
+        // 列表循环：第 1 首开始后依次切换 TRACKS - 1 次
+        QTRY_VERIFY_WITH_TIMEOUT(spy.count() >= TRACKS - 1, TRACKS * TRACK_MS + 10000);
+
+        for (int i = 0; i < spy.count(); ++i) {
+            const double gap = spy.at(i).at(0).toDouble();
+            const double lead = spy.at(i).at(1).toDouble();
+            const bool buffered = spy.at(i).at(2).toBool();
+            qInfo("第 %d 次切换：计时器测得间隙 %.1f ms，下次提前量 %.1f ms，切换前%s缓冲完成",
+                  i + 1, gap, lead, buffered ? "已" : "未");
+            // 预载播放器切换前必须已处于 BufferedMedia，否则间隙里包含了打开文件的时间
+            QVERIFY2(buffered, qPrintable(QString("第 %1 次切换时下一首尚未缓冲完成").arg(i + 1)));
+            if (i >= SETTLED_FROM) {
+                QVERIFY2(qAbs(gap) <= MAX_GAP_MS,
+                         qPrintable(QString("第 %1 次切换计时器测得间隙 %2 ms").arg(i + 1).arg(gap)));
+            }
+        }
+        QCOMPARE(player->lastTransitionGapMs(), spy.last().at(0).toDouble());
+    }
+};
+
+QTEST_MAIN(TestAudioPlayer)
+
+#include "tst_audioplayer.moc"
@@ -0,0 +1,27 @@
+include(../tests.pri)
+
+QT += gui widgets multimedia network
+
+TARGET = tst_audioplayer
+
+HEADERS += \
+    ../../audioplayer.h \
+    ../../audiotap.h \
+    ../../crossfader.h \
+    ../../loudnessscanner.h \
+    ../../lyricdownloader.h \
+    ../../lyricfileindex.h \
+    ../../lyricloader.h \
+    ../../lyricprefetcher.h \
+    ../../lyricprovider.h \
+    ../../lyricresponsecache.h \
+    ../../lyricsearchdialog.h \
+    ../../lyricsearchindex.h \
+    ../../lyricwidget.h \
+    ../../networkresilience.h \
+    ../../onlinemusicsearch.h \
+    ../../spectrumwidget.h \
+    ../../waveformoverview.h
+
+SOURCES += \
+    tst_audioplayer.cpp
@@ -0,0 +1,215 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QSignalSpy>
+#include <QNetworkProxy>
+#include <memory>
+#include "lyricdownloader.h"
+#include "stubhttpserver.h"
+
+// LyricDownloader：对本地模拟的网易云接口（搜索 + 取歌词）完整走一遍下载、缓存、保存与取消
+class TestLyricDownloader : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const qint64 SONG_ID = 186016;
+    static const int TIMEOUT_MS = 5000;
+    static constexpr const char *LYRIC = "[ti:晴天]\n[00:01.00]故事的小黄花\n[00:05.50]从出生那年就飘着\n";
+
+    struct Result
+    {
+        bool done = false;
+        QString lyricText;
+        QString error;
+        bool definitive = false;
+    };
+
+    StubHttpServer m_server;
+    QTemporaryDir m_dir;
+
+    // 搜索关键词含"没有"时返回空结果，含"坏"时返回 404，含"挂起"时不应答
+    static StubHttpServer::Reply handle(const QString &path, const QUrlQuery &query)
+    {
+        if (path == "search") {
+            const QString keywords = query.queryItemValue("keywords", QUrl::FullyDecoded);
+            if (keywords.contains("挂起")) return StubHttpServer::action(StubHttpServer::Hang);
+            if (keywords.contains("坏")) return StubHttpServer::json("{}", 404);
+            if (keywords.contains("没有")) return StubHttpServer::json(R"({"result":{"songs":[]},"code":200})");
+            return StubHttpServer::json(QString(R"({"result":{"songs":[{"id":%1,"name":"晴天"}]},"code":200})")
+                                        .arg(SONG_ID).toUtf8());
+        }
+        if (path == "lyric" && query.queryItemValue("id") == QString::number(SONG_ID)) {
+            QJsonObject lrc;
+            lrc["lyric"] = QString::fromUtf8(LYRIC);
+            QJsonObject root;
+            root["lrc"] = lrc;
+            root["code"] = 200;
+            return StubHttpServer::json(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        }
+        return StubHttpServer::json("{}", 404);
+    }
+
+    // 每个用例一个新的下载器，只使用模拟服务
+    std::unique_ptr<LyricDownloader> makeDownloader()
+    {
+        std::unique_ptr<LyricDownloader> downloader(new LyricDownloader);
+        downloader->configureProviders("netease=" + m_server.baseUrl().toString());
+        return downloader;
+    }
+
+    static Result fetch(LyricDownloader &downloader, const QString &title, const QString &artist)
+    {
+        Result result;
+        downloader.fetchLyric(title, artist, [&result](const QString &lyricText, const QString &error, bool definitive) {
+            result.done = true;
+            result.lyricText = lyricText;
+            result.error = error;
+            result.definitive = definitive;
+        });
+        QTest::qWaitFor([&result]() { return result.done; }, TIMEOUT_MS);
+        return result;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);     // 系统代理不应转发本地请求
+        QVERIFY(m_dir.isValid());
+        m_server.setHandler(&TestLyricDownloader::handle);
+        QVERIFY(m_server.listen());
+    }
+
+    void init()
+    {
+        LyricResponseCache cache;
+        cache.clear();              // 析构时写盘，各用例从空缓存开始
+        m_server.clearRequests();
+        NetworkResilience::instance()->reset();
+    }
+
+    // 先搜索歌曲 ID，再按 ID 取歌词
+    void downloadsFromProvider()
+    {
+        std::unique_ptr<LyricDownloader> downloader = makeDownloader();
+        const Result result = fetch(*downloader, "晴天", "周杰伦");
+        QVERIFY(result.done);
+        QCOMPARE(result.lyricText, QString::fromUtf8(LYRIC));
+        QVERIFY(result.error.isEmpty());
+        QVERIFY(result.definitive);
+        QCOMPARE(m_server.requests(), QStringList({"search?keywords=周杰伦 晴天&limit=1",
+                                                   QString("lyric?id=%1").arg(SONG_ID)}));
+        QCOMPARE(downloader->succeededCount(), qint64(1));
+    }
+
+    // 同一首歌再次查询命中缓存，不再联网；"未找到"同样缓存
+    void cachesAnswers()
+    {
+        std::unique_ptr<LyricDownloader> downloader = makeDownloader();
+        QCOMPARE(fetch(*downloader, "晴天", "周杰伦").lyricText, QString::fromUtf8(LYRIC));
+        QCOMPARE(fetch(*downloader, "没有这首", "").error, QString("未找到歌曲"));
+        const int requests = m_server.requests().size();
+
+        QCOMPARE(fetch(*downloader, "晴天", "周杰伦").lyricText, QString::fromUtf8(LYRIC));
+        const Result cached = fetch(*downloader, "没有这首", "");
+        QCOMPARE(cached.error, QString("未找到歌曲（缓存）"));
+        QVERIFY(cached.definitive);
+        QCOMPARE(m_server.requests().size(), requests);
+        QCOMPARE(downloader->cache()->hitCount(), qint64(1));
+        QCOMPARE(downloader->cache()->negativeHitCount(), qint64(1));
+    }
+
+    // 命中只在内存中刷新使用时间，不重写缓存文件（延迟保存为 2 秒）
+    void hitsDoNotRewriteCache()
+    {
+        const QString path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/lyricresponses.bin";
+        {
+            LyricResponseCache cache;
+            cache.store(LyricResponseCache::makeKey("晴天", "周杰伦"), QString::fromUtf8(LYRIC));
+        }
+        const QDateTime written = QFileInfo(path).lastModified();
+        QVERIFY(written.isValid());
+
+        LyricResponseCache cache;
+        QString text;
+        for (int i = 0; i < 100; ++i) {
+            QVERIFY(cache.lookup(LyricResponseCache::makeKey("晴天", "周杰伦"), text) == LyricResponseCache::Lookup::Found);
+        }
+        QTest::qWait(3000);
+        QCOMPARE(QFileInfo(path).lastModified(), written);
+        QCOMPARE(cache.hitCount(), qint64(100));
+    }
+
+    // 出错（不是明确答复）不写入缓存，下次重新联网
+    void doesNotCacheErrors()
+    {
+        std::unique_ptr<LyricDownloader> downloader = makeDownloader();
+        const Result first = fetch(*downloader, "坏掉的歌", "");
+        QVERIFY(first.error.startsWith("网络错误"));
+        QVERIFY(!first.definitive);
+        QVERIFY(fetch(*downloader, "坏掉的歌", "").error.startsWith("网络错误"));
+        QCOMPARE(m_server.requestCount("search"), 2);
+        QCOMPARE(downloader->failedCount(), qint64(2));
+    }
+
+    // 自动下载：按文件名解析歌名与艺术家，歌词保存在音频旁边
+    void savesNextToAudio()
+    {
+        std::unique_ptr<LyricDownloader> downloader = makeDownloader();
+        QSignalSpy finished(downloader.get(), &LyricDownloader::downloadFinished);
+        const QString audio = m_dir.filePath("周杰伦 - 晴天.mp3");
+        downloader->autoDownloadLyric(audio);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.size(), 1, TIMEOUT_MS);
+        QCOMPARE(finished[0][0].toString(), audio);
+        QVERIFY(finished[0][1].toBool());
+
+        QFile lrc(m_dir.filePath("周杰伦 - 晴天.lrc"));
+        QVERIFY(lrc.open(QIODevice::ReadOnly | QIODevice::Text));
+        QCOMPARE(QString::fromUtf8(lrc.readAll()), QString::fromUtf8(LYRIC));
+    }
+
+    // 取消后不再回调，进行中的请求被中止
+    void cancelSuppressesCallback()
+    {
+        std::unique_ptr<LyricDownloader> downloader = makeDownloader();
+        bool called = false;
+        const quint64 id = downloader->fetchLyric("挂起的歌", "", [&called](const QString &, const QString &, bool) {
+            called = true;
+        });
+        QTRY_COMPARE_WITH_TIMEOUT(m_server.requestCount("search"), 1, TIMEOUT_MS);
+        downloader->cancel(id);
+        QCOMPARE(downloader->activeCount(), 0);
+        QCOMPARE(downloader->cancelledCount(), qint64(1));
+        QTest::qWait(200);
+        QVERIFY(!called);
+    }
+
+    // 替换来源：没有任务在用的旧来源立即释放，仍在查询的旧来源等任务结束后释放
+    void releasesReplacedProviders()
+    {
+        std::unique_ptr<LyricDownloader> downloader = makeDownloader();
+        QPointer<LyricProvider> idle = downloader->providers().value(0);
+        QVERIFY(idle);
+        downloader->configureProviders("netease=" + m_server.baseUrl().toString());
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QVERIFY(!idle);
+
+        QPointer<LyricProvider> busy = downloader->providers().value(0);
+        const quint64 id = downloader->fetchLyric("挂起的歌", "", [](const QString &, const QString &, bool) {});
+        QTRY_COMPARE_WITH_TIMEOUT(m_server.requestCount("search"), 1, TIMEOUT_MS);
+        downloader->configureProviders("netease=" + m_server.baseUrl().toString());
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QVERIFY(busy);
+        QVERIFY(!downloader->providers().contains(busy.data()));
+
+        downloader->cancel(id);
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QVERIFY(!busy);
+        QCOMPARE(downloader->providers().size(), 1);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestLyricDownloader)
+
+#include "tst_lyricdownloader.moc"
@@ -0,0 +1,14 @@
+include(../tests.pri)
+
+QT += gui widgets network
+
+TARGET = tst_lyricdownloader
+
+HEADERS += \
+    ../../lyricdownloader.h \
+    ../../lyricprovider.h \
+    ../../lyricresponsecache.h \
+    ../../networkresilience.h
+
+SOURCES += \
+    tst_lyricdownloader.cpp
@@ -0,0 +1,144 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QElapsedTimer>
+#include "lyricfileindex.h"
+#include "lyricparser.h"
+
+// LyricFileIndex：五万首曲目的目录树上，与逐个 stat 的 findLyricFile 对照
+class TestLyricFileIndex : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int ALBUMS = 1000;
+    static const int TRACKS = 50;               // 每张专辑的曲目数，共五万首
+    static const int SAMPLE_STRIDE = 10;        // 基准每次迭代查找其中的十分之一
+
+    QTemporaryDir m_dir;
+    QStringList m_tracks;
+
+    static bool touchFile(const QString &path)
+    {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly);
+    }
+
+    // 专辑按序号轮流把歌词放在同目录、lyrics/、Lyrics/，或者没有歌词；偶数曲目才有歌词
+    bool buildTree()
+    {
+        for (int a = 0; a < ALBUMS; ++a) {
+            const QString album = m_dir.filePath(QString("artist%1/album%2").arg(a / 10).arg(a));
+            QString lrcDir = album;
+            if (a % 4 == 1) lrcDir = album + "/lyrics";
+            else if (a % 4 == 2) lrcDir = album + "/Lyrics";
+            if (!QDir().mkpath(lrcDir)) return false;
+
+            for (int t = 0; t < TRACKS; ++t) {
+                const QString base = QString("%1 - track %2").arg(t + 1, 2, 10, QChar('0')).arg(t + 1);
+                if (!touchFile(album + "/" + base + ".mp3")) return false;
+                if (a % 4 != 3 && t % 2 == 0 && !touchFile(lrcDir + "/" + base + ".lrc")) return false;
+                m_tracks.append(album + "/" + base + ".mp3");
+            }
+        }
+        return true;
+    }
+
+    QStringList sample() const
+    {
+        QStringList tracks;
+        for (int i = 0; i < m_tracks.size(); i += SAMPLE_STRIDE) tracks.append(m_tracks[i]);
+        return tracks;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY(buildTree());
+        qInfo("生成 %d 首曲目的目录树，耗时 %lld ms", int(m_tracks.size()), timer.elapsed());
+    }
+
+    // 每个目录只列举一次，结果与逐个 stat 一致
+    void matchesFindLyricFile()
+    {
+        LyricFileIndex index;
+        int found = 0;
+        for (const QString &track : std::as_const(m_tracks)) {
+            const QString expected = LyricParser::findLyricFile(track);
+            QCOMPARE(index.find(track), expected);
+            if (!expected.isEmpty()) ++found;
+        }
+        QCOMPARE(found, ALBUMS / 4 * 3 * TRACKS / 2);
+
+        // 专辑目录各一次，加上存在的歌词子目录
+        const qint64 listings = index.listingCount();
+        QCOMPARE(listings, qint64(ALBUMS + ALBUMS / 2));
+
+        // 第二遍全部命中内存
+        for (const QString &track : std::as_const(m_tracks)) index.find(track);
+        QCOMPARE(index.listingCount(), listings);
+        qInfo("%lld 次查找，列举目录 %lld 次，平均 %.2f µs",
+              index.lookupCount(), index.listingCount(), index.averageLookupNs() / 1000.0);
+    }
+
+    // 确知有新歌词文件时丢弃该专辑的列举结果
+    void rescansAfterInvalidate()
+    {
+        LyricFileIndex index;
+        const QString track = m_tracks[1];          // 第一张专辑的奇数曲目没有歌词
+        QVERIFY(index.find(track).isEmpty());
+
+        const QString lrc = QFileInfo(track).absolutePath() + "/" + QFileInfo(track).completeBaseName() + ".lrc";
+        QVERIFY(touchFile(lrc));
+        index.invalidateFor(track);
+        QCOMPARE(index.find(track), lrc);
+        QVERIFY(QFile::remove(lrc));
+    }
+
+    void benchmarkLookup_data()
+    {
+        QTest::addColumn<bool>("indexed");
+        QTest::addColumn<bool>("warm");
+        QTest::newRow("stat") << false << false;
+        QTest::newRow("index-cold") << true << false;
+        QTest::newRow("index-warm") << true << true;
+    }
+
+    // 每次迭代查找五千首（分布在全部专辑中）；cold 每次新建索引，包含列举目录的开销
+    void benchmarkLookup()
+    {
+        QFETCH(bool, indexed);
+        QFETCH(bool, warm);
+
+        const QStringList tracks = sample();
+        int found = 0;
+        if (!indexed) {
+            QBENCHMARK {
+                found = 0;
+                for (const QString &track : tracks) found += !LyricParser::findLyricFile(track).isEmpty();
+            }
+        } else if (!warm) {
+            QBENCHMARK {
+                LyricFileIndex index;
+                found = 0;
+                for (const QString &track : tracks) found += !index.find(track).isEmpty();
+            }
+        } else {
+            LyricFileIndex index;
+            for (const QString &track : tracks) index.find(track);
+            QBENCHMARK {
+                found = 0;
+                for (const QString &track : tracks) found += !index.find(track).isEmpty();
+            }
+        }
+        QVERIFY(found > 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestLyricFileIndex)
+
+#include "tst_lyricfileindex.moc"
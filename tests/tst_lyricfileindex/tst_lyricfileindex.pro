@@ -0,0 +1,11 @@
+include(../tests.pri)
+
+QT += gui widgets
+
+TARGET = tst_lyricfileindex
+
+HEADERS += \
+    ../../lyricfileindex.h
+
+SOURCES += \
+    tst_lyricfileindex.cpp
@@ -0,0 +1,243 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QRandomGenerator>
+#include <QElapsedTimer>
+#include <algorithm>
+#include "lyricparser.h"
+
+// 改写前的解析器（QTextStream 逐行解码 + 正则匹配时间标签），作为基准对照
+class LegacyLyricParser
+{
+public:
+    static QList<LyricLine> parseLrcFile(const QString &filePath)
+    {
+        QList<LyricLine> lyrics;
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return lyrics;
+
+        QTextStream in(&file);
+        in.setEncoding(QStringConverter::Utf8);
+        QRegularExpression timeRegex(R"(\[(\d{2}):(\d{2})(?:\.(\d{2,3}))?\])");
+
+        while (!in.atEnd()) {
+            QString line = in.readLine().trimmed();
+            if (line.isEmpty()) continue;
+
+            QRegularExpressionMatchIterator it = timeRegex.globalMatch(line);
+            QList<qint64> timestamps;
+            while (it.hasNext()) {
+                QRegularExpressionMatch match = it.next();
+                int minutes = match.captured(1).toInt();
+                int seconds = match.captured(2).toInt();
+                int milliseconds = 0;
+                if (!match.captured(3).isEmpty()) {
+                    QString msStr = match.captured(3);
+                    milliseconds = msStr.length() == 2 ? msStr.toInt() * 10 : msStr.toInt();
+                }
+                timestamps.append((minutes * 60 + seconds) * 1000 + milliseconds);
+            }
+
+            QString lyricText = line;
+            lyricText.remove(timeRegex);
+            if (lyricText.startsWith("[") && lyricText.contains(":")) continue;
+
+            for (qint64 timestamp : timestamps) {
+                lyrics.append(LyricLine(timestamp, lyricText));
+            }
+        }
+        return lyrics;
+    }
+};
+
+// LyricParser：语法覆盖与语料库基准（数千个 LRC 文件，对照改写前的正则解析器）
+class TestLyricParser : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int CORPUS_FILES = 3000;
+
+    QTemporaryDir m_dir;
+    QStringList m_corpus;
+
+    // 一首歌的歌词：元数据、两三位毫秒、副歌一行多个时间标签
+    static QByteArray makeLrc(int index)
+    {
+        QRandomGenerator random(quint32(index + 1));
+        QByteArray lrc;
+        lrc += "[ti:测试歌曲 " + QByteArray::number(index) + "]\n";
+        lrc += "[ar:测试歌手]\n[al:测试专辑]\n[by:tst_lyricparser]\n\n";
+
+        const int lines = 30 + random.bounded(60);
+        qint64 ms = 0;
+        for (int i = 0; i < lines; ++i) {
+            ms += 1500 + random.bounded(4000);
+            const bool threeDigits = random.bounded(4) == 0;
+            auto tag = [threeDigits](qint64 t) {
+                const QByteArray fraction = threeDigits
+                    ? QByteArray::number(t % 1000).rightJustified(3, '0')
+                    : QByteArray::number(t % 1000 / 10).rightJustified(2, '0');
+                return "[" + QByteArray::number(t / 60000).rightJustified(2, '0') + ":"
+                       + QByteArray::number(t / 1000 % 60).rightJustified(2, '0') + "." + fraction + "]";
+            };
+            QByteArray line = tag(ms);
+            if (random.bounded(8) == 0) {
+                // 副歌：同一行文本稍后再次出现
+                line += tag(ms + 60000 + random.bounded(30000));
+            }
+            line += "第" + QByteArray::number(i + 1) + "句歌词 lyric line " + QByteArray::number(i + 1);
+            lrc += line + (random.bounded(3) == 0 ? "\r\n" : "\n");
+        }
+        return lrc;
+    }
+
+    static QList<LyricLine> sortedByTime(QList<LyricLine> lyrics)
+    {
+        std::stable_sort(lyrics.begin(), lyrics.end(), [](const LyricLine &a, const LyricLine &b) {
+            return a.timestamp < b.timestamp;
+        });
+        return lyrics;
+    }
+
+    static QList<LyricLine> parse(const char *lrc)
+    {
+        return LyricParser::parseLrcData(lrc, qstrlen(lrc));
+    }
+
+    template <typename Parser>
+    int parseCorpus(Parser parser) const
+    {
+        int lines = 0;
+        for (const QString &path : m_corpus) lines += parser(path).size();
+        return lines;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        for (int i = 0; i < CORPUS_FILES; ++i) {
+            const QString path = m_dir.filePath(QString("song%1.lrc").arg(i));
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(makeLrc(i));
+            m_corpus.append(path);
+        }
+    }
+
+    void parsesTimeTagVariants()
+    {
+        const QList<LyricLine> lyrics = parse("[ti:标题]\n[1:02]a\n[01:02.5]b\n[01:02.50]c\n[01:02:500]d\n[100:00.000]e\n");
+        QCOMPARE(lyrics.size(), 5);
+        QCOMPARE(lyrics[0].timestamp, 62000);
+        QCOMPARE(lyrics[1].timestamp, 62500);
+        QCOMPARE(lyrics[2].timestamp, 62500);
+        QCOMPARE(lyrics[3].timestamp, 62500);
+        QCOMPARE(lyrics[4].timestamp, 6000000);
+        QCOMPARE(lyrics[0].text, QString("a"));
+    }
+
+    void sharesTextAcrossTagsAndSorts()
+    {
+        const QList<LyricLine> lyrics = parse("[00:10.00][00:30.00]副歌\n[00:20.00]主歌\n");
+        QCOMPARE(lyrics.size(), 3);
+        QCOMPARE(lyrics[0].text, QString("副歌"));
+        QCOMPARE(lyrics[1].text, QString("主歌"));
+        QCOMPARE(lyrics[2].timestamp, 30000);
+    }
+
+    void appliesOffsetTag()
+    {
+        const QList<LyricLine> lyrics = parse("[offset:+500]\n[00:01.00]x\n[00:00.20]y\n");
+        QCOMPARE(lyrics.size(), 2);
+        QCOMPARE(lyrics[0].timestamp, 0);      // 不会变成负数
+        QCOMPARE(lyrics[1].timestamp, 500);
+    }
+
+    void parsesWordTimings()
+    {
+        const QList<LyricLine> lyrics = parse("[00:01.00]<00:01.00>你<00:01.50>好<00:02.00>\n");
+        QCOMPARE(lyrics.size(), 1);
+        QCOMPARE(lyrics[0].text, QString("你好"));
+        QCOMPARE(lyrics[0].words.size(), 3);
+        QCOMPARE(lyrics[0].words[1].timestamp, 1500);
+        QCOMPARE(lyrics[0].words[1].start, 1);
+        QCOMPARE(lyrics[0].words[2].length, 0);  // 结束标记
+    }
+
+    // 一行多个时间标签：每份的逐字时间随各自的行时间平移
+    void shiftsWordTimingsOfRepeatedLines()
+    {
+        const QList<LyricLine> lyrics = parse("[00:10.00][01:10.00]<00:10.00>a<00:10.50>b<00:11.00>\n");
+        QCOMPARE(lyrics.size(), 2);
+        QCOMPARE(lyrics[0].words[0].timestamp, 10000);
+        QCOMPARE(lyrics[0].words[1].timestamp, 10500);
+        QCOMPARE(lyrics[1].timestamp, 70000);
+        QCOMPARE(lyrics[1].words[0].timestamp, 70000);
+        QCOMPARE(lyrics[1].words[1].timestamp, 70500);
+        QCOMPARE(lyrics[1].words[2].timestamp, 71000);
+        QCOMPARE(lyrics[1].text, QString("ab"));
+    }
+
+    // 在语料库上与改写前的解析器逐行一致
+    void matchesLegacyParserOnCorpus()
+    {
+        for (const QString &path : std::as_const(m_corpus)) {
+            const QList<LyricLine> expected = sortedByTime(LegacyLyricParser::parseLrcFile(path));
+            const QList<LyricLine> actual = LyricParser::parseLrcFile(path);
+            QCOMPARE(actual.size(), expected.size());
+            for (int i = 0; i < actual.size(); ++i) {
+                QCOMPARE(actual[i].timestamp, expected[i].timestamp);
+                QCOMPARE(actual[i].text, expected[i].text);
+            }
+        }
+    }
+
+    // 整个语料库各解析一遍，报告加速比
+    void reportsSpeedupOverLegacyParser()
+    {
+        // 预热文件缓存
+        const int lines = parseCorpus(&LyricParser::parseLrcFile);
+        QCOMPARE(parseCorpus(&LegacyLyricParser::parseLrcFile), lines);
+
+        QElapsedTimer timer;
+        timer.start();
+        parseCorpus(&LegacyLyricParser::parseLrcFile);
+        const qint64 legacyNs = timer.nsecsElapsed();
+        timer.restart();
+        parseCorpus(&LyricParser::parseLrcFile);
+        const qint64 singlePassNs = timer.nsecsElapsed();
+
+        qInfo("%d 个文件 %d 行：正则解析 %.1f ms，单遍扫描 %.1f ms，加速 %.1f 倍",
+              int(m_corpus.size()), lines, legacyNs / 1e6, singlePassNs / 1e6, double(legacyNs) / singlePassNs);
+        QVERIFY(singlePassNs < legacyNs);
+    }
+
+    void benchmarkCorpus_data()
+    {
+        QTest::addColumn<bool>("legacy");
+        QTest::newRow("regex") << true;
+        QTest::newRow("single-pass") << false;
+    }
+
+    // 每次迭代解析整个语料库
+    void benchmarkCorpus()
+    {
+        QFETCH(bool, legacy);
+        if (legacy) {
+            QBENCHMARK {
+                parseCorpus(&LegacyLyricParser::parseLrcFile);
+            }
+        } else {
+            QBENCHMARK {
+                parseCorpus(&LyricParser::parseLrcFile);
+            }
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestLyricParser)
+
+#include "tst_lyricparser.moc"
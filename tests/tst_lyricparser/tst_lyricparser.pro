@@ -0,0 +1,8 @@
+include(../tests.pri)
+
+QT += gui widgets
+
+TARGET = tst_lyricparser
+
+SOURCES += \
+    tst_lyricparser.cpp
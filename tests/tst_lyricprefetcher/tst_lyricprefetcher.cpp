@@ -0,0 +1,259 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QSignalSpy>
+#include <QNetworkProxy>
+#include <QElapsedTimer>
+#include "lyricprefetcher.h"
+#include "stubhttpserver.h"
+
+// LyricPrefetcher：经 LyricDownloader 对本地模拟接口批量预取
+// 明确答复（有歌词、确认没有）本轮内复用；暂时失败的曲目留在队列文件中，重启后 resume() 重试
+// 另按预取器的参数（同时 4 个任务，令牌桶每秒 2 个、容量 4）检查并发上限、限速与进度统计
+class TestLyricPrefetcher : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int TIMEOUT_MS = 10000;
+    static const int MAX_CONCURRENT = 4;
+    static const int BURST = 4;
+    static const int TOKEN_INTERVAL_MS = 500;   // 每秒 2 个令牌
+    static const int TOLERANCE_MS = 150;        // 定时器与事件循环的调度误差
+    static constexpr const char *LYRIC = "[00:01.00]预取到的歌词\n";
+
+    StubHttpServer m_server;
+    QTemporaryDir m_dir;
+    bool m_outage = true;       // "坏掉"这首歌的搜索是否出错（404，不是明确答复）
+    QElapsedTimer m_clock;
+    QList<qint64> m_arrivals;   // 搜索请求到达的时刻（m_clock 毫秒）
+
+    QString queuePath() const
+    {
+        return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/lyricprefetch.lst";
+    }
+
+    // 同名曲目放在两个目录中，查询应合并
+    QString track(const QString &dir, const QString &name) const
+    {
+        return m_dir.filePath(dir + "/" + name + ".mp3");
+    }
+
+    bool hasLyric(const QString &audioPath) const
+    {
+        return QFile::exists(audioPath.chopped(4) + ".lrc");
+    }
+
+    static bool touchFile(const QString &path, const QByteArray &data = QByteArray())
+    {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+    }
+
+    StubHttpServer::Reply handle(const QString &path, const QUrlQuery &query)
+    {
+        if (path == "search") {
+            if (m_clock.isValid()) m_arrivals.append(m_clock.elapsed());
+            const QString keywords = query.queryItemValue("keywords", QUrl::FullyDecoded);
+            if (keywords.contains("挂起")) return StubHttpServer::action(StubHttpServer::Hang);
+            if (keywords.contains("没有")) return StubHttpServer::json(R"({"result":{"songs":[]}})");
+            if (keywords.contains("坏掉") && m_outage) return StubHttpServer::json("{}", 404);
+            return StubHttpServer::json(R"({"result":{"songs":[{"id":7}]}})");
+        }
+        if (path == "lyric") {
+            QJsonObject lrc;
+            lrc["lyric"] = QString::fromUtf8(LYRIC);
+            QJsonObject root;
+            root["lrc"] = lrc;
+            return StubHttpServer::json(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        }
+        return StubHttpServer::json("{}", 404);
+    }
+
+    QStringList readQueue() const
+    {
+        QFile file(queuePath());
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return QStringList();
+        QStringList paths = QString::fromUtf8(file.readAll()).split('\n', Qt::SkipEmptyParts);
+        paths.sort();
+        return paths;
+    }
+
+    // 在新目录中生成 count 首不同的曲目（没有本地歌词）
+    QStringList makeTracks(const QString &dir, const QString &title, int count) const
+    {
+        QStringList tracks;
+        if (!QDir().mkpath(m_dir.filePath(dir))) return tracks;
+        for (int i = 0; i < count; ++i) {
+            const QString path = track(dir, QString("歌手%1 - %2%1").arg(i).arg(title));
+            if (touchFile(path)) tracks.append(path);
+        }
+        return tracks;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);
+        QFile::remove(queuePath());
+        {
+            LyricResponseCache cache;
+            cache.clear();
+        }
+
+        QVERIFY(m_dir.isValid());
+        for (const QString &dir : {"a", "b"}) {
+            QVERIFY(QDir().mkpath(m_dir.filePath(dir)));
+            for (const QString &name : {"歌手A - 有词", "歌手B - 没有", "歌手C - 坏掉"}) {
+                QVERIFY(touchFile(track(dir, name)));
+            }
+        }
+        QVERIFY(touchFile(track("a", "歌手D - 本地")));
+        QVERIFY(touchFile(m_dir.filePath("a/歌手D - 本地.lrc"), LYRIC));
+
+        m_server.setHandler([this](const QString &path, const QUrlQuery &query) { return handle(path, query); });
+        QVERIFY(m_server.listen());
+    }
+
+    void init()
+    {
+        NetworkResilience::instance()->reset();
+        m_server.clearRequests();
+        m_arrivals.clear();
+        m_clock.invalidate();
+    }
+
+    // 第一轮：接口对"坏掉"出错，这两首留在队列文件中，其余正常完成
+    // 第二轮：模拟重启后 resume()，接口恢复，只重试队列中的两首
+    void keepsTransientFailuresForResume()
+    {
+        const QStringList tracks = {
+            track("a", "歌手A - 有词"), track("a", "歌手B - 没有"), track("a", "歌手C - 坏掉"),
+            track("a", "歌手D - 本地"),
+            track("b", "歌手A - 有词"), track("b", "歌手B - 没有"), track("b", "歌手C - 坏掉"),
+        };
+
+        {
+            LyricDownloader downloader;
+            downloader.configureProviders("netease=" + m_server.baseUrl().toString());
+            LyricPrefetcher prefetcher(&downloader);
+            QSignalSpy finished(&prefetcher, &LyricPrefetcher::finished);
+            prefetcher.start(tracks);
+            QTRY_COMPARE_WITH_TIMEOUT(finished.size(), 1, TIMEOUT_MS);
+
+            QCOMPARE(prefetcher.fetchedCount(), 2);
+            QCOMPARE(prefetcher.skippedCount(), 1);
+            QCOMPARE(prefetcher.failedCount(), 2);
+            QCOMPARE(prefetcher.deferredCount(), 2);
+            QCOMPARE(prefetcher.completedCount(), int(tracks.size()));
+            QCOMPARE(prefetcher.taskCount(), 3);        // 同名曲目只查询一次
+            QCOMPARE(m_server.requestCount("search"), 3);
+        }
+        QVERIFY(hasLyric(track("a", "歌手A - 有词")));
+        QVERIFY(hasLyric(track("b", "歌手A - 有词")));
+        QVERIFY(!hasLyric(track("a", "歌手B - 没有")));
+        QVERIFY(!hasLyric(track("a", "歌手C - 坏掉")));
+        QCOMPARE(readQueue(), QStringList({track("a", "歌手C - 坏掉"), track("b", "歌手C - 坏掉")}));
+
+        m_outage = false;
+        m_server.clearRequests();
+        {
+            LyricDownloader downloader;
+            downloader.configureProviders("netease=" + m_server.baseUrl().toString());
+            LyricPrefetcher prefetcher(&downloader);
+            QSignalSpy finished(&prefetcher, &LyricPrefetcher::finished);
+            prefetcher.resume();
+            QVERIFY(prefetcher.isRunning());
+            QTRY_COMPARE_WITH_TIMEOUT(finished.size(), 1, TIMEOUT_MS);
+
+            QCOMPARE(prefetcher.totalCount(), 2);
+            QCOMPARE(prefetcher.fetchedCount(), 2);
+            QCOMPARE(prefetcher.deferredCount(), 0);
+            QCOMPARE(m_server.requestCount("search"), 1);
+        }
+        QVERIFY(hasLyric(track("a", "歌手C - 坏掉")));
+        QVERIFY(hasLyric(track("b", "歌手C - 坏掉")));
+        QVERIFY(!QFile::exists(queuePath()));
+    }
+
+    // 接口不应答时同时进行的查询不超过 4 个，令牌足够也不再发起
+    void limitsConcurrentTasks()
+    {
+        const QStringList tracks = makeTracks("hang", "挂起", 10);
+        QCOMPARE(tracks.size(), 10);
+
+        // 挂起的请求在观察期内不能超时，否则会腾出空位
+        NetworkResilience *resilience = NetworkResilience::instance();
+        const int attemptTimeout = resilience->attemptTimeout();
+        const int deadline = resilience->deadline();
+        resilience->setTimeouts(TIMEOUT_MS, TIMEOUT_MS);
+
+        LyricDownloader downloader;
+        downloader.configureProviders("netease=" + m_server.baseUrl().toString());
+        LyricPrefetcher prefetcher(&downloader);
+        prefetcher.start(tracks);
+        QTRY_COMPARE_WITH_TIMEOUT(m_server.requestCount("search"), MAX_CONCURRENT, TIMEOUT_MS);
+
+        // 等到令牌足够发起全部 10 个查询，但请求都挂起，没有空位
+        QTest::qWait((int(tracks.size()) - BURST) * TOKEN_INTERVAL_MS + TOLERANCE_MS);
+        QCOMPARE(m_server.requestCount("search"), MAX_CONCURRENT);
+        QCOMPARE(prefetcher.taskCount(), MAX_CONCURRENT);
+        QCOMPARE(prefetcher.completedCount(), 0);
+        prefetcher.stop();
+        QCOMPARE(downloader.activeCount(), 0);
+        QFile::remove(queuePath());
+        resilience->setTimeouts(attemptTimeout, deadline);
+    }
+
+    // 令牌桶：前 4 个查询立即发出，之后每 500ms 一个；进度信号与吞吐量与实际处理情况一致
+    void ratesTasksAndReportsProgress()
+    {
+        const int count = 10;
+        const QStringList tracks = makeTracks("rate", "限速", count);
+        QCOMPARE(tracks.size(), count);
+
+        LyricDownloader downloader;
+        downloader.configureProviders("netease=" + m_server.baseUrl().toString());
+        LyricPrefetcher prefetcher(&downloader);
+        QSignalSpy progress(&prefetcher, &LyricPrefetcher::progress);
+        QSignalSpy finished(&prefetcher, &LyricPrefetcher::finished);
+        m_clock.start();
+        prefetcher.start(tracks);
+        QTRY_COMPARE_WITH_TIMEOUT(finished.size(), 1, TIMEOUT_MS);
+        const qint64 elapsedMs = m_clock.elapsed();
+        const double throughput = prefetcher.throughput();
+
+        QCOMPARE(m_arrivals.size(), count);
+        for (int i = 0; i < count; ++i) {
+            const qint64 expected = qMax(0, i - BURST + 1) * TOKEN_INTERVAL_MS;
+            QVERIFY2(m_arrivals[i] >= expected - TOLERANCE_MS && m_arrivals[i] <= expected + TOLERANCE_MS,
+                     qPrintable(QString("第 %1 个查询在 %2 ms 到达，预期 %3 ms").arg(i + 1).arg(m_arrivals[i]).arg(expected)));
+        }
+        QCOMPARE(finished[0][0].toInt(), count);
+        QCOMPARE(prefetcher.completedCount(), count);
+
+        // 完成时强制发出最后一次进度；中途的进度单调增加
+        QVERIFY(progress.size() >= 2);
+        int previous = 0;
+        for (const QList<QVariant> &args : std::as_const(progress)) {
+            QVERIFY(args[0].toInt() >= previous);
+            QCOMPARE(args[1].toInt(), count);
+            previous = args[0].toInt();
+        }
+        QCOMPARE(progress.last()[0].toInt(), count);
+        QVERIFY(progress.last()[2].toDouble() > 0.0);
+
+        // 吞吐量为已处理曲目数除以运行时间，受令牌桶约束
+        const double expected = count * 1000.0 / elapsedMs;
+        qInfo("%d 首耗时 %lld ms，吞吐量 %.2f 首/秒", count, elapsedMs, throughput);
+        QVERIFY2(qAbs(throughput - expected) <= expected * 0.1,
+                 qPrintable(QString("吞吐量 %1，预期 %2").arg(throughput).arg(expected)));
+        QVERIFY(throughput <= count * 1000.0 / ((count - BURST) * TOKEN_INTERVAL_MS - TOLERANCE_MS));
+        QVERIFY(!QFile::exists(queuePath()));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestLyricPrefetcher)
+
+#include "tst_lyricprefetcher.moc"
@@ -0,0 +1,15 @@
+include(../tests.pri)
+
+QT += gui widgets network
+
+TARGET = tst_lyricprefetcher
+
+HEADERS += \
+    ../../lyricdownloader.h \
+    ../../lyricprefetcher.h \
+    ../../lyricprovider.h \
+    ../../lyricresponsecache.h \
+    ../../networkresilience.h
+
+SOURCES += \
+    tst_lyricprefetcher.cpp
@@ -0,0 +1,262 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QRandomGenerator>
+#include <QElapsedTimer>
+#include <atomic>
+#include "lyricsearchindex.h"
+
+// LyricSearchWorker：查询延迟、不完整结果的标记、目录扫描与持久化
+// 默认五千个歌词文件；设置 QTMEDIAPLAYER_LARGE_CORPUS=1 时改为十万个，用于测量大曲库上的延迟
+// 工作对象直接在测试线程中运行，分批索引由 QTRY 驱动事件循环完成
+class TestLyricSearchIndex : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int DOCUMENTS = 5000;
+    static const int LARGE_DOCUMENTS = 100000;
+    static const int DIRECTORIES = 100;
+    static const int LINES = 20;
+    static const int LATENCY_BUDGET_MS = 50;
+    static const int INDEX_TIMEOUT_MS = 240000;     // 按大语料库估计，低于 QtTest 默认的单个函数超时（5 分钟）
+
+    // 随机歌词用字，不含下面插入的句子里的字
+    static constexpr const char *VOCABULARY =
+        "天地人你我他她爱心梦雨雪花春夏秋冬山水云海星夜日时年今明昨走跑飞唱听看说想"
+        "红黄蓝绿白黑长短远近高低大小新旧快慢冷热甜苦城街路桥门家乡歌声笑泪手眼温柔";
+    static constexpr const char *RARE = "独一无二的晚风";         // 只在一个文件中
+    static constexpr const char *COMMON = "月光照进窗";           // 每 20 个文件一次，远超结果上限
+    static constexpr const char *EXACT = "Hello, Darkness";      // 均匀分布，正好等于结果上限
+    static const int RARE_DOC = 3777;
+
+    struct Result
+    {
+        QList<LyricSearchHit> hits;
+        bool truncated = false;
+        qint64 elapsedNs = 0;
+    };
+
+    QTemporaryDir m_dir;
+    int m_documents = DOCUMENTS;
+    std::atomic<quint64> m_latest{0};
+    LyricSearchWorker *m_worker = nullptr;
+    int m_indexed = 0;
+    int m_pending = 0;
+
+    static QString audioPath(const QString &root, int doc)
+    {
+        return QString("%1/d%2/song%3.mp3").arg(root).arg(doc % DIRECTORIES).arg(doc);
+    }
+
+    static qint64 lineTime(int line) { return 5000 + line * 4000; }
+
+    QByteArray makeLrc(int doc) const
+    {
+        const int exactEvery = m_documents / LyricSearchIndex::DEFAULT_LIMIT;
+        static const QString vocabulary = QString::fromUtf8(VOCABULARY);
+        QRandomGenerator random(quint32(doc) + 1);
+        QByteArray lrc = "[ti:song" + QByteArray::number(doc) + "]\n";
+        for (int i = 0; i < LINES; ++i) {
+            QString text;
+            if (doc == RARE_DOC && i == 5) {
+                text = QString("就像%1吹过").arg(QString::fromUtf8(RARE));
+            } else if (doc % 20 == 0 && i == 3) {
+                text = QString::fromUtf8(COMMON) + "台";
+            } else if (doc % exactEvery == 0 && i == 7) {
+                text = "hello darkness my old friend";
+            } else {
+                const int length = 8 + random.bounded(5);
+                for (int c = 0; c < length; ++c) text += vocabulary[random.bounded(int(vocabulary.size()))];
+            }
+            const qint64 ms = lineTime(i);
+            lrc += QString("[%1:%2.%3]").arg(ms / 60000, 2, 10, QChar('0')).arg(ms / 1000 % 60, 2, 10, QChar('0'))
+                       .arg(ms % 1000 / 10, 2, 10, QChar('0')).toUtf8()
+                   + text.toUtf8() + "\n";
+        }
+        return lrc;
+    }
+
+    static bool writeFile(const QString &path, const QByteArray &data)
+    {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+    }
+
+    void connectProgress(LyricSearchWorker *worker)
+    {
+        connect(worker, &LyricSearchWorker::progress, this, [this](int indexed, int pending) {
+            m_indexed = indexed;
+            m_pending = pending;
+        });
+    }
+
+    // 同一线程内直接连接，search 返回前结果已经收到
+    Result search(LyricSearchWorker *worker, const QString &query, int limit = LyricSearchIndex::DEFAULT_LIMIT)
+    {
+        Result result;
+        const QMetaObject::Connection connection = connect(worker, &LyricSearchWorker::searchFinished, this,
+            [&result](quint64, const QList<LyricSearchHit> &hits, bool truncated, qint64 elapsedNs) {
+                result.hits = hits;
+                result.truncated = truncated;
+                result.elapsedNs = elapsedNs;
+            });
+        worker->search(query, ++m_latest, limit);
+        disconnect(connection);
+        return result;
+    }
+
+    Result search(const QString &query, int limit = LyricSearchIndex::DEFAULT_LIMIT)
+    {
+        return search(m_worker, query, limit);
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        QFile::remove(cacheRoot + "/lyricsearch.idx");
+        QDir(LyricCache::cacheDir()).removeRecursively();
+
+        if (qEnvironmentVariableIntValue("QTMEDIAPLAYER_LARGE_CORPUS")) m_documents = LARGE_DOCUMENTS;
+        QVERIFY(m_dir.isValid());
+        QElapsedTimer timer;
+        timer.start();
+        const QString root = m_dir.filePath("library");
+        QStringList tracks;
+        tracks.reserve(m_documents);
+        for (int d = 0; d < DIRECTORIES; ++d) QVERIFY(QDir().mkpath(QString("%1/d%2").arg(root).arg(d)));
+        for (int doc = 0; doc < m_documents; ++doc) {
+            const QString audio = audioPath(root, doc);
+            QVERIFY(writeFile(audio.chopped(4) + ".lrc", makeLrc(doc)));
+            tracks.append(audio);   // 音频文件本身不需要存在
+        }
+        qInfo("生成 %d 个歌词文件，耗时 %lld ms", m_documents, timer.restart());
+
+        m_worker = new LyricSearchWorker(m_latest);
+        connectProgress(m_worker);
+        m_worker->initialize();
+        m_worker->addTracks(tracks);
+        QTRY_VERIFY_WITH_TIMEOUT(m_pending == 0 && m_indexed == m_documents, INDEX_TIMEOUT_MS);
+        qInfo("索引 %d 首，耗时 %lld ms", m_indexed, timer.elapsed());
+    }
+
+    void cleanupTestCase()
+    {
+        delete m_worker;
+    }
+
+    void findsRarePhrase()
+    {
+        const Result result = search("独一无二 的晚风");
+        QCOMPARE(result.hits.size(), 1);
+        QVERIFY(!result.truncated);
+        QCOMPARE(result.hits[0].audioPath, audioPath(m_dir.filePath("library"), RARE_DOC));
+        QCOMPARE(result.hits[0].timestamp, lineTime(5));
+        QCOMPARE(result.hits[0].text, QString("就像独一无二的晚风吹过"));
+    }
+
+    // 匹配超过上限时标记为不完整，界面据此提示
+    void marksTruncatedResults()
+    {
+        const Result result = search(COMMON);
+        QCOMPARE(result.hits.size(), LyricSearchIndex::DEFAULT_LIMIT);
+        QVERIFY(result.truncated);
+    }
+
+    void exactLimitIsComplete()
+    {
+        const Result result = search(EXACT);
+        QCOMPARE(result.hits.size(), LyricSearchIndex::DEFAULT_LIMIT);
+        QVERIFY(!result.truncated);
+    }
+
+    // 完整（未截断）的查询在 50ms 内返回（首次查询，需要读取候选歌词）
+    // 截断的查询受 40ms 确认上限约束，耗时必然在预算内，只统计截断次数，不作为延迟依据
+    void answersWithinLatencyBudget()
+    {
+        const QString vocabulary = QString::fromUtf8(VOCABULARY);
+        const QStringList selective = {"晚风吹过", "old friend", "不存在的句子"};   // 必须完整确认
+        QStringList broad = {"月光照进窗台"};
+        for (int i = 0; i + 3 < 40; i += 4) broad.append(vocabulary.mid(i, 2));      // 单个二元组，候选很多
+        for (int i = 1; i + 3 < 40; i += 4) broad.append(vocabulary.mid(i, 3));
+
+        qint64 maxNs = 0;
+        qint64 totalNs = 0;
+        int complete = 0;
+        int truncated = 0;
+        for (const QString &query : selective + broad) {
+            const Result result = search(query);
+            if (result.truncated) {
+                QVERIFY2(!selective.contains(query), qPrintable(QString("%1 未确认完").arg(query)));
+                ++truncated;
+                continue;
+            }
+            ++complete;
+            maxNs = qMax(maxNs, result.elapsedNs);
+            totalNs += result.elapsedNs;
+        }
+        qInfo("完整查询 %d 个，平均 %.2f ms，最长 %.2f ms；截断 %d 个", complete,
+              totalNs / 1e6 / complete, maxNs / 1e6, truncated);
+        QVERIFY2(maxNs < LATENCY_BUDGET_MS * 1000000LL, qPrintable(QString("最长 %1 ms").arg(maxNs / 1e6)));
+    }
+
+    // 目录递归扫描：不在播放列表中的曲目也会被索引
+    void indexesDirectories()
+    {
+        const QString root = m_dir.filePath("music");
+        QVERIFY(QDir().mkpath(root + "/artist/album/lyrics"));
+        QVERIFY(writeFile(root + "/single.mp3", QByteArray()));
+        QVERIFY(writeFile(root + "/single.lrc", "[00:01.00]目录扫描的第一首\n"));
+        QVERIFY(writeFile(root + "/artist/album/track.flac", QByteArray()));
+        QVERIFY(writeFile(root + "/artist/album/lyrics/track.lrc", "[00:02.00]子目录里的第二首\n"));
+        QVERIFY(writeFile(root + "/artist/album/cover.jpg", QByteArray()));
+
+        m_worker->addDirectory(root, true);
+        QTRY_VERIFY_WITH_TIMEOUT(m_pending == 0 && m_indexed == m_documents + 2, 10000);
+        QCOMPARE(search("目录扫描").hits.size(), 1);
+        QCOMPARE(search("子目录里").hits.value(0).audioPath, QDir(root).absoluteFilePath("artist/album/track.flac"));
+
+        // 同一目录本次运行不再重复扫描
+        m_worker->addDirectory(root, true);
+        QCoreApplication::processEvents();
+        QCOMPARE(m_indexed, m_documents + 2);
+    }
+
+    // 重新启动后从磁盘读回索引
+    void reloadsSavedIndex()
+    {
+        LyricSearchWorker reloaded(m_latest);
+        reloaded.initialize();
+        const Result result = search(&reloaded, RARE);
+        QCOMPARE(result.hits.size(), 1);
+        QCOMPARE(result.hits[0].timestamp, lineTime(5));
+    }
+
+    void benchmarkSearch_data()
+    {
+        QTest::addColumn<QString>("query");
+        QTest::newRow("rare") << QString::fromUtf8(RARE);
+        QTest::newRow("common") << QString::fromUtf8(COMMON);
+        QTest::newRow("latin") << QString::fromUtf8(EXACT);
+        QTest::newRow("bigram") << QString::fromUtf8(VOCABULARY).left(2);
+        QTest::newRow("miss") << QString("不存在的句子");
+    }
+
+    // 每次迭代为一次完整查询（候选求交 + 确认）；第一次之后候选歌词已在内存中
+    // 截断的结果耗时受确认上限约束，只对完整结果检查延迟
+    void benchmarkSearch()
+    {
+        QFETCH(QString, query);
+        Result result;
+        QBENCHMARK {
+            result = search(query);
+        }
+        if (!result.truncated) QVERIFY(result.elapsedNs < LATENCY_BUDGET_MS * 1000000LL);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestLyricSearchIndex)
+
+#include "tst_lyricsearchindex.moc"
@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+QT += gui widgets
+
+TARGET = tst_lyricsearchindex
+
+HEADERS += \
+    ../../lyricfileindex.h \
+    ../../lyricsearchindex.h
+
+SOURCES += \
+    tst_lyricsearchindex.cpp
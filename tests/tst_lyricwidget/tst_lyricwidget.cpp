@@ -0,0 +1,190 @@
+#include <QtTest>
+#include <QImage>
+#include <QRandomGenerator>
+#include "lyricwidget.h"
+
+// LyricWidget：万行歌词（演唱会、有声书）下的当前行查找与滚动绘制基准
+class TestLyricWidget : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int LINES = 10000;
+    static const int LINE_MS = 3000;        // 平均每行时长
+    static const int TICK_MS = 50;          // positionChanged 的上报间隔
+    static const int POSITIONS = 20000;     // 每次迭代查找的次数
+    static const int WIDTH = 1920;
+    static const int HEIGHT = 1080;
+
+    // 固定种子的歌词：时间戳递增，长短不一，部分行长到需要换行
+    static QList<LyricLine> makeLyrics(int count)
+    {
+        QRandomGenerator random(7);
+        QList<LyricLine> lyrics;
+        lyrics.reserve(count);
+        qint64 ms = 1000;
+        for (int i = 0; i < count; ++i) {
+            QString text = QString("第%1句 ").arg(i + 1);
+            const int words = 1 + random.bounded(random.bounded(10) == 0 ? 40 : 8);
+            for (int w = 0; w < words; ++w) text += w % 2 ? "歌词 " : "lyric ";
+            lyrics.append(LyricLine(ms, text.trimmed()));
+            ms += LINE_MS / 2 + random.bounded(LINE_MS);
+        }
+        return lyrics;
+    }
+
+    // 改用游标之前的查找方式：每次从末尾向前扫描
+    static int findLinear(const QList<LyricLine> &lyrics, qint64 position)
+    {
+        for (int i = lyrics.size() - 1; i >= 0; --i) {
+            if (lyrics[i].timestamp <= position) return i;
+        }
+        return -1;
+    }
+
+    // 正常播放：从歌曲中段开始按上报间隔连续前进
+    static QVector<qint64> playbackPositions(const QList<LyricLine> &lyrics)
+    {
+        QVector<qint64> positions(POSITIONS);
+        const qint64 start = lyrics[lyrics.size() / 2].timestamp;
+        for (int i = 0; i < POSITIONS; ++i) positions[i] = start + qint64(i) * TICK_MS;
+        return positions;
+    }
+
+    // 拖动进度条：随机跳转（含第一行之前）
+    static QVector<qint64> seekPositions(const QList<LyricLine> &lyrics)
+    {
+        QRandomGenerator random(11);
+        QVector<qint64> positions(POSITIONS);
+        const qint64 end = lyrics.last().timestamp + LINE_MS;
+        for (qint64 &position : positions) position = random.bounded(end);
+        return positions;
+    }
+
+    // 按 refresh() 的方式查找：结果作为下一次的游标
+    static int walk(LyricWidget &widget, const QVector<qint64> &positions)
+    {
+        int sum = 0;
+        for (qint64 position : positions) {
+            widget.m_currentLineIndex = widget.findCurrentLine(position);
+            sum += widget.m_currentLineIndex;
+        }
+        return sum;
+    }
+
+    static int walkLinear(const QList<LyricLine> &lyrics, const QVector<qint64> &positions)
+    {
+        int sum = 0;
+        for (qint64 position : positions) sum += findLinear(lyrics, position);
+        return sum;
+    }
+
+    // 不真正上屏，只为得到尺寸；滚动位置由测试直接设置
+    static void prepare(LyricWidget &widget, const QList<LyricLine> &lyrics)
+    {
+        widget.setAttribute(Qt::WA_DontShowOnScreen);
+        widget.resize(WIDTH, HEIGHT);
+        widget.show();
+        widget.setLyrics(lyrics);
+        widget.m_scrollAnimation->stop();
+    }
+
+private slots:
+    void cursorMatchesLinearScan()
+    {
+        const QList<LyricLine> lyrics = makeLyrics(LINES);
+        LyricWidget widget;
+        widget.setLyrics(lyrics);
+
+        for (const QVector<qint64> &positions : {playbackPositions(lyrics), seekPositions(lyrics)}) {
+            for (qint64 position : positions) {
+                const int expected = findLinear(lyrics, position);
+                widget.m_currentLineIndex = widget.findCurrentLine(position);
+                QCOMPARE(widget.m_currentLineIndex, expected);
+            }
+        }
+    }
+
+    // 排版缓存只保留可见行附近，与歌词总行数无关
+    void layoutCacheStaysBounded()
+    {
+        LyricWidget widget;
+        prepare(widget, makeLyrics(LINES));
+        QImage target(WIDTH, HEIGHT, QImage::Format_ARGB32_Premultiplied);
+
+        int maxCached = 0;
+        for (double f = 0.0; f < LINES; f += 97.3) {
+            widget.m_scrollPos = f;
+            widget.render(&target);
+            maxCached = qMax(maxCached, widget.cachedLayoutCount());
+        }
+        qInfo("%d 行歌词，最多缓存 %d 行排版", LINES, maxCached);
+        QVERIFY(maxCached > 0);
+        QVERIFY(maxCached < 100);
+    }
+
+    void benchmarkLookup_data()
+    {
+        QTest::addColumn<bool>("cursor");
+        QTest::addColumn<bool>("seek");
+        QTest::newRow("cursor-playback") << true << false;
+        QTest::newRow("linear-playback") << false << false;
+        QTest::newRow("cursor-seek") << true << true;
+        QTest::newRow("linear-seek") << false << true;
+    }
+
+    // 每次迭代查找 POSITIONS 次
+    void benchmarkLookup()
+    {
+        QFETCH(bool, cursor);
+        QFETCH(bool, seek);
+
+        const QList<LyricLine> lyrics = makeLyrics(LINES);
+        const QVector<qint64> positions = seek ? seekPositions(lyrics) : playbackPositions(lyrics);
+        LyricWidget widget;
+        widget.setLyrics(lyrics);
+
+        int sum = 0;
+        if (cursor) {
+            QBENCHMARK {
+                widget.m_currentLineIndex = -1;
+                sum = walk(widget, positions);
+            }
+        } else {
+            QBENCHMARK {
+                sum = walkLinear(lyrics, positions);
+            }
+        }
+        QVERIFY(sum > 0);
+    }
+
+    void benchmarkScroll_data()
+    {
+        QTest::addColumn<int>("lines");
+        QTest::newRow("100") << 100;
+        QTest::newRow("10000") << LINES;
+    }
+
+    // 每次迭代为滚动中的一整帧：前进四分之一行，新进入可见范围的行首次排版
+    void benchmarkScroll()
+    {
+        QFETCH(int, lines);
+
+        LyricWidget widget;
+        prepare(widget, makeLyrics(lines));
+        QImage target(WIDTH, HEIGHT, QImage::Format_ARGB32_Premultiplied);
+
+        double f = 0.0;
+        QBENCHMARK {
+            widget.m_scrollPos = f;
+            widget.render(&target);
+            f += 0.25;
+            if (f >= lines) f = 0.0;
+        }
+        QVERIFY(widget.cachedLayoutCount() < 100);
+    }
+};
+
+QTEST_MAIN(TestLyricWidget)
+
+#include "tst_lyricwidget.moc"
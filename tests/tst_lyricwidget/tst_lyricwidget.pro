@@ -0,0 +1,11 @@
+include(../tests.pri)
+
+QT += gui widgets
+
+TARGET = tst_lyricwidget
+
+HEADERS += \
+    ../../lyricwidget.h
+
+SOURCES += \
+    tst_lyricwidget.cpp
@@ -0,0 +1,237 @@
+#include <QtTest>
+#include <QNetworkAccessManager>
+#include <QNetworkProxy>
+#include <QElapsedTimer>
+#include "networkresilience.h"
+#include "stubhttpserver.h"
+
+// NetworkResilience：对本地故障注入服务（返回 500、不应答、直接断开）检查重试、超时与熔断
+// 超时与冷却时间调短以加快测试，各用例开始前重置熔断器
+class TestNetworkResilience : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int ATTEMPT_TIMEOUT_MS = 300;
+    static const int DEADLINE_MS = 2000;
+    static const int COOLDOWN_MS = 200;
+    static const int WAIT_MS = 10000;
+
+    struct Outcome
+    {
+        NetworkResult result;
+        qint64 elapsedMs = -1;
+        bool done = false;
+    };
+
+    StubHttpServer m_server;
+    QNetworkAccessManager m_manager;
+
+    // 路径决定故障：error 总是 500，flaky 前两次 500，hang 不应答，close 断开连接，
+    // slow-retry 第一次 500、之后不应答，missing 为 404，其余 200
+    StubHttpServer::Reply handle(const QString &path)
+    {
+        const int hits = m_server.requestCount(path);
+        if (path == "error") return StubHttpServer::json("{}", 500);
+        if (path == "flaky" && hits <= 2) return StubHttpServer::json("{}", 500);
+        if (path == "hang") return StubHttpServer::action(StubHttpServer::Hang);
+        if (path == "close") return StubHttpServer::action(StubHttpServer::Close);
+        if (path == "slow-retry") {
+            return hits == 1 ? StubHttpServer::json("{}", 500) : StubHttpServer::action(StubHttpServer::Hang);
+        }
+        if (path == "missing") return StubHttpServer::json("{}", 404);
+        return StubHttpServer::json(R"({"ok":true})");
+    }
+
+    // 发出请求，不等待；结果写入 outcome（调用方保证其存活到完成）
+    void send(const QString &path, Outcome *outcome)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        NetworkResilience::instance()->get(&m_manager, QNetworkRequest(m_server.baseUrl().resolved(QUrl(path))), this,
+            [outcome, timer](const NetworkResult &result) {
+                outcome->result = result;
+                outcome->elapsedMs = timer.elapsed();
+                outcome->done = true;
+            });
+    }
+
+    Outcome get(const QString &path)
+    {
+        Outcome outcome;
+        send(path, &outcome);
+        QTest::qWaitFor([&outcome]() { return outcome.done; }, WAIT_MS);
+        return outcome;
+    }
+
+    // 持续 5xx 打开熔断器（一个请求的三次尝试即达到阈值）
+    void openBreaker()
+    {
+        get("error");
+        QCOMPARE(status().state, CircuitBreaker::Open);
+        m_server.clearRequests();
+    }
+
+    static NetworkResilience::HostStatus status()
+    {
+        const QList<NetworkResilience::HostStatus> hosts = NetworkResilience::instance()->snapshot();
+        for (const NetworkResilience::HostStatus &host : hosts) {
+            if (host.host == "127.0.0.1") return host;
+        }
+        return NetworkResilience::HostStatus();
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);
+        m_server.setHandler([this](const QString &path, const QUrlQuery &) { return handle(path); });
+        QVERIFY(m_server.listen());
+    }
+
+    void init()
+    {
+        NetworkResilience::instance()->reset();
+        NetworkResilience::instance()->setTimeouts(ATTEMPT_TIMEOUT_MS, DEADLINE_MS);
+        NetworkResilience::instance()->setCooldown(COOLDOWN_MS);
+        m_server.clearRequests();
+    }
+
+    // 5xx 退避后重试，成功后熔断器计数清零
+    void retriesServerErrors()
+    {
+        const Outcome outcome = get("flaky");
+        QVERIFY(outcome.result.ok());
+        QCOMPARE(outcome.result.attempts, 3);
+        QCOMPARE(m_server.requestCount("flaky"), 3);
+        QCOMPARE(status().retries, qint64(2));
+        QCOMPARE(status().consecutiveFailures, 0);
+        QCOMPARE(status().state, CircuitBreaker::Closed);
+    }
+
+    // 持续 5xx：用完重试次数后返回，三次失败打开熔断器，之后的请求不再发出
+    void opensBreakerOnServerErrors()
+    {
+        const Outcome outcome = get("error");
+        QVERIFY(!outcome.result.ok());
+        QCOMPARE(outcome.result.httpStatus, 500);
+        QCOMPARE(outcome.result.attempts, 3);
+        QCOMPARE(status().state, CircuitBreaker::Open);
+
+        const Outcome rejected = get("ok");
+        QVERIFY(rejected.result.rejected);
+        QCOMPARE(rejected.result.attempts, 0);
+        QCOMPARE(m_server.requestCount("ok"), 0);
+    }
+
+    // 冷却结束后转为半开，探测成功则关闭，冷却时间恢复为初始值
+    void halfOpenProbeClosesBreaker()
+    {
+        openBreaker();
+        QVERIFY(status().reopenInMs <= COOLDOWN_MS);
+        QTRY_COMPARE_WITH_TIMEOUT(status().state, CircuitBreaker::HalfOpen, 4 * COOLDOWN_MS);
+
+        const Outcome probe = get("ok");
+        QVERIFY(probe.result.ok());
+        QCOMPARE(probe.result.attempts, 1);
+        QCOMPARE(status().state, CircuitBreaker::Closed);
+        QCOMPARE(status().consecutiveFailures, 0);
+
+        openBreaker();
+        QVERIFY(status().reopenInMs <= COOLDOWN_MS);
+    }
+
+    // 半开时只放行一个探测请求，同时到达的其余请求被拒绝；探测失败则重新打开，冷却时间加倍
+    void halfOpenProbeFailureDoublesCooldown()
+    {
+        openBreaker();
+        QTRY_COMPARE_WITH_TIMEOUT(status().state, CircuitBreaker::HalfOpen, 4 * COOLDOWN_MS);
+
+        Outcome probe;
+        Outcome second;
+        send("hang", &probe);
+        send("ok", &second);
+        QTRY_VERIFY_WITH_TIMEOUT(second.done, WAIT_MS);
+        QVERIFY(second.result.rejected);
+        QCOMPARE(status().state, CircuitBreaker::HalfOpen);
+        QCOMPARE(m_server.requestCount("ok"), 0);
+
+        QTRY_VERIFY_WITH_TIMEOUT(probe.done, WAIT_MS);
+        QCOMPARE(probe.result.errorString, QString("请求超时"));
+        QCOMPARE(probe.result.attempts, 1);
+        QCOMPARE(m_server.requestCount("hang"), 1);
+        QCOMPARE(status().state, CircuitBreaker::Open);
+        QVERIFY2(status().reopenInMs > COOLDOWN_MS && status().reopenInMs <= 2 * COOLDOWN_MS,
+                 qPrintable(QString("剩余冷却 %1 ms").arg(status().reopenInMs)));
+
+        // 加倍后的冷却结束，再次探测成功
+        QTRY_COMPARE_WITH_TIMEOUT(status().state, CircuitBreaker::HalfOpen, 4 * COOLDOWN_MS);
+        QVERIFY(get("ok").result.ok());
+        QCOMPARE(status().state, CircuitBreaker::Closed);
+    }
+
+    // 超时不重试：只等一个单次超时就返回，并计入熔断
+    void doesNotRetryTimeouts()
+    {
+        const Outcome outcome = get("hang");
+        QCOMPARE(outcome.result.error, QNetworkReply::OperationCanceledError);
+        QCOMPARE(outcome.result.errorString, QString("请求超时"));
+        QCOMPARE(outcome.result.attempts, 1);
+        QVERIFY2(outcome.elapsedMs >= ATTEMPT_TIMEOUT_MS && outcome.elapsedMs < 3 * ATTEMPT_TIMEOUT_MS,
+                 qPrintable(QString("耗时 %1 ms").arg(outcome.elapsedMs)));
+        QCOMPARE(m_server.requestCount("hang"), 1);
+        QCOMPARE(status().consecutiveFailures, 1);
+    }
+
+    // 连续三次超时后熔断，第四个请求立即失败
+    void opensBreakerOnTimeouts()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < 3; ++i) {
+            QCOMPARE(get("hang").result.errorString, QString("请求超时"));
+        }
+        QCOMPARE(status().state, CircuitBreaker::Open);
+        qInfo("三次超时共 %lld ms", timer.elapsed());
+        QVERIFY(timer.elapsed() < 3 * 3 * ATTEMPT_TIMEOUT_MS);
+
+        const Outcome rejected = get("hang");
+        QVERIFY(rejected.result.rejected);
+        QVERIFY(rejected.elapsedMs < ATTEMPT_TIMEOUT_MS);
+        QCOMPARE(m_server.requestCount("hang"), 3);
+    }
+
+    // 连接被断开属于可重试的失败
+    void retriesClosedConnections()
+    {
+        const Outcome outcome = get("close");
+        QVERIFY(!outcome.result.ok());
+        QVERIFY(outcome.result.error != QNetworkReply::OperationCanceledError);
+        QCOMPARE(outcome.result.attempts, 3);
+        QVERIFY(m_server.requestCount("close") >= 3);   // 网络层自身也可能重连重发
+    }
+
+    // 整体截止时间到期时中止进行中的重试
+    void deadlineAbortsInFlightAttempt()
+    {
+        NetworkResilience::instance()->setTimeouts(5000, 1000);
+        const Outcome outcome = get("slow-retry");
+        QCOMPARE(outcome.result.error, QNetworkReply::OperationCanceledError);
+        QCOMPARE(outcome.result.attempts, 2);
+        QVERIFY2(outcome.elapsedMs >= 1000 && outcome.elapsedMs < 1500,
+                 qPrintable(QString("耗时 %1 ms").arg(outcome.elapsedMs)));
+    }
+
+    // 4xx 说明服务可达：不重试，也不计入熔断
+    void doesNotRetryClientErrors()
+    {
+        const Outcome outcome = get("missing");
+        QCOMPARE(outcome.result.httpStatus, 404);
+        QCOMPARE(outcome.result.attempts, 1);
+        QCOMPARE(status().consecutiveFailures, 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestNetworkResilience)
+
+#include "tst_networkresilience.moc"
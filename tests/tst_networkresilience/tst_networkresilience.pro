@@ -0,0 +1,11 @@
+include(../tests.pri)
+
+QT += network
+
+TARGET = tst_networkresilience
+
+HEADERS += \
+    ../../networkresilience.h
+
+SOURCES += \
+    tst_networkresilience.cpp
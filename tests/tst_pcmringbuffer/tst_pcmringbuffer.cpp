@@ -0,0 +1,142 @@
+#include <QtTest>
+#include <QThread>
+#include <QElapsedTimer>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "pcmringbuffer.h"
+
+// PcmRingBuffer：基本语义与 192kHz 持续写入下的撕裂读取检测
+class TestPcmRingBuffer : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int SAMPLE_RATE = 192000;
+    static const int BLOCK_FRAMES = 960;        // 生产者每次写入 5ms
+    static const int CAPACITY = 8192;           // 约 43ms，消费者稍慢就会被覆盖
+    static const int WINDOW = 4096;             // 与频谱分析窗口相同量级
+    static const int STRESS_MS = 2000;
+    static const quint32 WRAP = 1u << 20;       // 帧序号取模，保证 float 精确表示
+
+    // 第 index 帧的取值
+    static float frameValue(quint64 index) { return static_cast<float>(index % WRAP); }
+
+    // 窗口内的帧序号必须连续：任何一帧来自另一轮写入都会破坏连续性
+    static bool isContiguous(const float *frames, int count)
+    {
+        for (int i = 1; i < count; ++i) {
+            const quint32 expected = (static_cast<quint32>(frames[i - 1]) + 1) % WRAP;
+            if (static_cast<quint32>(frames[i]) != expected) return false;
+        }
+        return true;
+    }
+
+private slots:
+    void roundsCapacityUpToPowerOfTwo()
+    {
+        PcmRingBuffer buffer(3000);
+        QCOMPARE(buffer.capacity(), 4096);
+    }
+
+    void readFailsUntilEnoughData()
+    {
+        PcmRingBuffer buffer(1024);
+        std::vector<float> data(100);
+        std::vector<float> out(256);
+        for (int i = 0; i < 100; ++i) data[i] = frameValue(i);
+
+        buffer.write(data.data(), 100);
+        QVERIFY(!buffer.readLatest(out.data(), 256));
+        QVERIFY(buffer.readLatest(out.data(), 100));
+        QCOMPARE(out[0], 0.0f);
+        QCOMPARE(out[99], 99.0f);
+        QVERIFY(!buffer.readLatest(out.data(), 2048));  // 超过容量
+    }
+
+    void overwritesOldestWhenFull()
+    {
+        PcmRingBuffer buffer(256);
+        std::vector<float> data(1000);
+        for (int i = 0; i < 1000; ++i) data[i] = frameValue(i);
+
+        // 一次写入超过容量：只保留最后 256 帧
+        buffer.write(data.data(), 1000);
+        QCOMPARE(buffer.framesWritten(), quint64(256));
+
+        // 分块写入绕圈多次：读到的始终是最新的一段
+        PcmRingBuffer ring(256);
+        for (int start = 0; start < 1000; start += 100) {
+            ring.write(data.data() + start, 100);
+        }
+        std::vector<float> out(200);
+        QVERIFY(ring.readLatest(out.data(), 200));
+        QCOMPARE(out.front(), 800.0f);
+        QCOMPARE(out.back(), 999.0f);
+        QVERIFY(isContiguous(out.data(), 200));
+    }
+
+    void noTornReads_data()
+    {
+        QTest::addColumn<bool>("paced");
+        QTest::newRow("realtime-192k") << true;     // 按 192kHz 实时节奏写入
+        QTest::newRow("unthrottled") << false;      // 不限速写入，远高于 192kHz，最大化竞争
+    }
+
+    // 生产者线程持续写入递增帧序号，消费者不停读取最新窗口：
+    // 每次返回成功的读取都必须是连续的一段，读取期间被覆盖的必须返回失败
+    void noTornReads()
+    {
+        QFETCH(bool, paced);
+
+        PcmRingBuffer buffer(CAPACITY);
+        std::atomic<bool> stop(false);
+        std::atomic<quint64> produced(0);
+
+        std::unique_ptr<QThread> producer(QThread::create([&]() {
+            std::vector<float> block(BLOCK_FRAMES);
+            quint64 index = 0;
+            QElapsedTimer clock;
+            clock.start();
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (paced && index >= quint64(clock.nsecsElapsed()) * SAMPLE_RATE / 1000000000ULL) {
+                    QThread::usleep(200);
+                    continue;
+                }
+                for (int i = 0; i < BLOCK_FRAMES; ++i) block[i] = frameValue(index + i);
+                buffer.write(block.data(), BLOCK_FRAMES);
+                index += BLOCK_FRAMES;
+            }
+            produced.store(index);
+        }));
+
+        std::vector<float> window(WINDOW);
+        qint64 accepted = 0;
+        qint64 rejected = 0;
+        qint64 torn = 0;
+        QElapsedTimer clock;
+        clock.start();
+        producer->start();
+        while (clock.elapsed() < STRESS_MS) {
+            if (!buffer.readLatest(window.data(), WINDOW)) {
+                ++rejected;
+                continue;
+            }
+            ++accepted;
+            if (!isContiguous(window.data(), WINDOW)) ++torn;
+        }
+        stop.store(true);
+        producer->wait();
+
+        const double rate = produced.load() * 1000.0 / clock.elapsed();
+        qInfo("写入 %.0f 帧/秒，读取成功 %lld 次，放弃（数据不足或被覆盖）%lld 次，撕裂 %lld 次",
+              rate, accepted, rejected, torn);
+        QCOMPARE(torn, qint64(0));
+        QVERIFY(accepted > 0);
+        QVERIFY(rate >= SAMPLE_RATE * 0.9);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestPcmRingBuffer)
+
+#include "tst_pcmringbuffer.moc"
@@ -0,0 +1,6 @@
+include(../tests.pri)
+
+TARGET = tst_pcmringbuffer
+
+SOURCES += \
+    tst_pcmringbuffer.cpp
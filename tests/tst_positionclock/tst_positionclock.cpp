@@ -0,0 +1,149 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include "positionclock.h"
+
+// PositionClock：全部用显式传入的模拟时间驱动，不依赖真实计时
+class TestPositionClock : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int REPORT_INTERVAL_MS = 250;  // QMediaPlayer 典型的上报间隔
+    static const int JITTER_MS = 20;            // 上报抖动
+    static const int MAX_ERROR_MS = 10;         // 插值位置允许的最大误差
+
+    // 在 t=0 处开始播放并对齐到 position
+    static void start(PositionClock &clock, qint64 position)
+    {
+        clock.setRunning(true, 0);
+        clock.report(position, 0);
+    }
+
+private slots:
+    void holdsPositionWhilePaused()
+    {
+        PositionClock clock;
+        clock.report(5000, 0);
+        QCOMPARE(clock.position(0), qint64(5000));
+        QCOMPARE(clock.position(3000), qint64(5000));
+        QCOMPARE(clock.msUntil(6000, 3000), qint64(-1));
+
+        // 开始播放时从暂停处继续
+        clock.setRunning(true, 3000);
+        QCOMPARE(clock.position(3400), qint64(5400));
+        clock.setRunning(false, 3500);
+        QCOMPARE(clock.position(9000), qint64(5500));
+    }
+
+    void extrapolatesAtPlaybackRate()
+    {
+        PositionClock clock;
+        start(clock, 1000);
+        QCOMPARE(clock.position(500), qint64(1500));
+
+        clock.setRate(2.0, 500);
+        QCOMPARE(clock.position(750), qint64(2000));
+        QCOMPARE(clock.msUntil(3000, 750), qint64(500));
+
+        // 非法速率按 1 倍处理
+        clock.setRate(0.0, 750);
+        QCOMPARE(clock.position(850), qint64(2100));
+    }
+
+    // 小误差每次只修正一部分，不跳变
+    void slewsSmallErrors()
+    {
+        PositionClock clock;
+        start(clock, 0);
+        clock.report(120, 100);                     // 预测 100，误差 20
+        QCOMPARE(clock.position(100), qint64(101));
+        clock.report(80, 200);                      // 预测 201，误差 -121（仍小于对齐阈值）
+        QVERIFY(clock.position(200) > 180);
+        QVERIFY(clock.position(200) < 201);
+    }
+
+    // 带 ±20ms 抖动的上报：误差收敛在 ±10ms 内，逐毫秒的位置不出现跳变
+    void smoothsJitteredReports()
+    {
+        PositionClock clock;
+        start(clock, 0);
+        QRandomGenerator random(3);
+
+        qint64 previous = clock.position(0);
+        qint64 maxError = 0;
+        qint64 totalError = 0;
+        int samples = 0;
+        int maxStep = 0;
+        for (qint64 t = 1; t <= 60000; ++t) {
+            if (t % REPORT_INTERVAL_MS == 0) {
+                clock.report(t + random.bounded(-JITTER_MS, JITTER_MS + 1), t);
+            }
+            const qint64 position = clock.position(t);
+            maxStep = qMax(maxStep, int(qAbs(position - previous - 1)));
+            previous = position;
+            if (t >= 10 * REPORT_INTERVAL_MS) {
+                maxError = qMax(maxError, qAbs(position - t));
+                totalError += qAbs(position - t);
+                ++samples;
+            }
+        }
+
+        qInfo("最大误差 %lld ms，平均误差 %.1f ms，最大单步偏差 %d ms",
+              maxError, double(totalError) / samples, maxStep);
+        QVERIFY2(maxError <= MAX_ERROR_MS, qPrintable(QString("最大误差 %1 ms").arg(maxError)));
+        QVERIFY(double(totalError) / samples <= 4.0);
+        QVERIFY(maxStep <= 3);      // 每次修正不超过 0.05 × 两倍抖动，加取整
+    }
+
+    // 跳转、缓冲等大误差直接对齐
+    void snapsLargeErrors()
+    {
+        PositionClock clock;
+        start(clock, 10000);
+        clock.report(10200, 0);
+        QCOMPARE(clock.position(0), qint64(10200));
+
+        clock.report(3000, 500);                    // 向后跳转
+        QCOMPARE(clock.position(500), qint64(3000));
+        QCOMPARE(clock.position(600), qint64(3100));
+    }
+
+    // 超过一秒没有上报（卡顿）则停止外推，恢复上报后对齐
+    void stopsExtrapolatingOnStall()
+    {
+        PositionClock clock;
+        start(clock, 0);
+        QCOMPARE(clock.position(1000), qint64(1000));
+        QCOMPARE(clock.position(1500), qint64(1000));
+        QCOMPARE(clock.position(5000), qint64(1000));
+
+        clock.report(1040, 5000);
+        QCOMPARE(clock.position(5000), qint64(1002));
+        QCOMPARE(clock.position(5100), qint64(1102));
+    }
+
+    // 输出延迟：听到的位置比上报位置晚，不为负数
+    void compensatesOutputLatency()
+    {
+        PositionClock clock;
+        clock.setLatency(200);
+        QCOMPARE(clock.latency(), 200);
+        start(clock, 1000);
+        QCOMPARE(clock.position(0), qint64(800));
+        QCOMPARE(clock.msUntil(1000, 0), qint64(200));
+        QCOMPARE(clock.msUntil(500, 0), qint64(0));  // 已经过去的时间点
+
+        clock.setRate(2.0, 0);
+        QCOMPARE(clock.msUntil(1000, 0), qint64(100));
+
+        clock.report(100, 100);
+        QCOMPARE(clock.position(100), qint64(0));
+
+        clock.setLatency(-5);
+        QCOMPARE(clock.latency(), 0);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestPositionClock)
+
+#include "tst_positionclock.moc"
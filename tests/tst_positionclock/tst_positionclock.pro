@@ -0,0 +1,6 @@
+include(../tests.pri)
+
+TARGET = tst_positionclock
+
+SOURCES += \
+    tst_positionclock.cpp
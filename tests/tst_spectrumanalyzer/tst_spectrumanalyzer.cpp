@@ -0,0 +1,141 @@
+#include <QtTest>
+#include <QVector>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include "spectrumanalyzer.h"
+
+// SpectrumAnalyzer：频带映射正确性与 FFT 内核基准
+class TestSpectrumAnalyzer : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int SAMPLE_RATE = 44100;
+    static const int FRAMES_PER_SECOND = 20;    // SpectrumWidget 播放时每 50ms 分析一次
+
+    static const BandTable &tableForSize(int fftSize)
+    {
+        switch (fftSize) {
+        case 1024: return BandLayout<BandScale::Log, 64, 1024>::Table;
+        case 4096: return BandLayout<BandScale::Log, 64, 4096>::Table;
+        case 8192: return BandLayout<BandScale::Log, 64, 8192>::Table;
+        default:   return BandLayout<BandScale::Log, 64, 2048>::Table;
+        }
+    }
+
+    static QVector<float> sine(int frames, double frequency, double amplitude = 1.0)
+    {
+        QVector<float> samples(frames);
+        for (int i = 0; i < frames; ++i) {
+            samples[i] = static_cast<float>(amplitude * std::sin(2.0 * M_PI * frequency * i / SAMPLE_RATE));
+        }
+        return samples;
+    }
+
+    // 各条的 bin 范围严格递增（低频不出现重复的列），只有 bin 用尽时才停在最高 bin
+    static void verifyStrictlyIncreasing(const BandTable &table)
+    {
+        const int maxBin = table.fftSize / 2;
+        for (int r = 0; r < BandTable::RATE_COUNT; ++r) {
+            const BandRange *ranges = table.ranges[r];
+            for (int b = 0; b < table.count; ++b) {
+                QVERIFY(ranges[b].firstBin >= 1);
+                QVERIFY(ranges[b].firstBin <= ranges[b].lastBin);
+                QVERIFY(ranges[b].lastBin <= maxBin);
+                if (b > 0 && ranges[b].firstBin < maxBin) {
+                    QVERIFY2(ranges[b].firstBin > ranges[b - 1].lastBin,
+                             qPrintable(QString("采样率 %1 第 %2 条与前一条重叠")
+                                        .arg(BandTable::RATES[r]).arg(b)));
+                }
+            }
+        }
+    }
+
+private slots:
+    void bandsAreStrictlyIncreasing()
+    {
+        verifyStrictlyIncreasing(BandLayout<BandScale::Log>::Table);
+        verifyStrictlyIncreasing(BandLayout<BandScale::Log, 256, 4096>::Table);
+        verifyStrictlyIncreasing(BandLayout<BandScale::Mel, 128, 4096>::Table);
+        verifyStrictlyIncreasing(BandLayout<BandScale::Octave>::Table);
+        verifyStrictlyIncreasing(BandLayout<BandScale::ThirdOctave>::Table);
+    }
+
+    void silenceGivesEmptyBars()
+    {
+        SpectrumAnalyzer analyzer;
+        QVector<float> samples(analyzer.fftSize(), 0.0f);
+        QVector<float> bars(analyzer.barCount(), -1.0f);
+        analyzer.analyze(samples.constData(), bars.data());
+        for (float bar : bars) QCOMPARE(bar, 0.0f);
+    }
+
+    // 正好落在 bin 上的正弦：最高的条必须是包含该 bin 的那一条
+    void sinePeaksInItsBand_data()
+    {
+        QTest::addColumn<int>("bin");
+        QTest::newRow("100Hz") << 5;
+        QTest::newRow("1kHz") << 46;
+        QTest::newRow("8kHz") << 372;
+    }
+
+    void sinePeaksInItsBand()
+    {
+        QFETCH(int, bin);
+
+        SpectrumAnalyzer analyzer;
+        analyzer.setSampleRate(SAMPLE_RATE);
+        const QVector<float> samples = sine(analyzer.fftSize(), double(bin) * SAMPLE_RATE / analyzer.fftSize());
+        QVector<float> bars(analyzer.barCount());
+        analyzer.analyze(samples.constData(), bars.data());
+
+        const int loudest = int(std::max_element(bars.cbegin(), bars.cend()) - bars.cbegin());
+        const BandRange *ranges = BandLayout<BandScale::Log, 64, 2048>::Table.forSampleRate(SAMPLE_RATE);
+        QVERIFY2(ranges[loudest].firstBin <= bin && bin <= ranges[loudest].lastBin,
+                 qPrintable(QString("最高条 %1 覆盖 bin %2~%3").arg(loudest)
+                            .arg(ranges[loudest].firstBin).arg(ranges[loudest].lastBin)));
+        QVERIFY(bars[loudest] > 0.7f);
+    }
+
+    // 20fps 下分析占用需低于单核 1%：每次不超过 500µs
+    // 只计 analyze()（加窗 + FFT + 频带映射）；AudioTap 线程中的解码与混缩不在此预算内
+    void stayWithinCpuBudget()
+    {
+        SpectrumAnalyzer analyzer;
+        const QVector<float> samples = sine(analyzer.fftSize(), 440.0, 0.5);
+        QVector<float> bars(analyzer.barCount());
+        for (int i = 0; i < 200; ++i) analyzer.analyze(samples.constData(), bars.data());
+
+        const double budgetNs = 0.01 * 1e9 / FRAMES_PER_SECOND;
+        qInfo("分析平均每帧 %.1f µs，单核占用 %.3f%%（不含解码）", analyzer.averageCostNs() / 1000.0,
+              analyzer.averageCostNs() * FRAMES_PER_SECOND / 1e9 * 100.0);
+        QVERIFY(analyzer.averageCostNs() < budgetNs);
+    }
+
+    void benchmarkAnalyze_data()
+    {
+        QTest::addColumn<int>("fftSize");
+        QTest::newRow("1024") << 1024;
+        QTest::newRow("2048") << 2048;
+        QTest::newRow("4096") << 4096;
+        QTest::newRow("8192") << 8192;
+    }
+
+    // 加窗 + 实数 FFT + 频带映射
+    void benchmarkAnalyze()
+    {
+        QFETCH(int, fftSize);
+
+        SpectrumAnalyzer analyzer(tableForSize(fftSize));
+        const QVector<float> samples = sine(fftSize, 440.0, 0.5);
+        QVector<float> bars(analyzer.barCount());
+        QBENCHMARK {
+            analyzer.analyze(samples.constData(), bars.data());
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestSpectrumAnalyzer)
+
+#include "tst_spectrumanalyzer.moc"
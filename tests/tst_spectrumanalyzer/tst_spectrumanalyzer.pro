@@ -0,0 +1,6 @@
+include(../tests.pri)
+
+TARGET = tst_spectrumanalyzer
+
+SOURCES += \
+    tst_spectrumanalyzer.cpp
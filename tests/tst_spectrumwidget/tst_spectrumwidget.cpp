@@ -0,0 +1,111 @@
+#include <QtTest>
+#include <QImage>
+#include <QPainter>
+#include <QLinearGradient>
+#include <QRandomGenerator>
+#include <cmath>
+#include "spectrumwidget.h"
+
+// SpectrumWidget 绘制基准：图集贴图与逐帧渐变（原实现）在 4K 画布上的每帧耗时
+class TestSpectrumWidget : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int WIDTH = 3840;
+    static const int HEIGHT = 2160;
+
+    static const BandTable &tableForBars(int bars)
+    {
+        switch (bars) {
+        case 256:  return BandLayout<BandScale::Log, 256, 8192>::Table;
+        case 1024: return BandLayout<BandScale::Log, 1024, 8192>::Table;
+        default:   return BandLayout<BandScale::Log, 64>::Table;
+        }
+    }
+
+    // 固定种子的条高与峰值，两种绘制方式使用同一组数据
+    static void fillLevels(SpectrumWidget &widget)
+    {
+        QRandomGenerator random(42);
+        for (int i = 0; i < widget.m_barCount; ++i) {
+            widget.m_barHeights[i] = 0.12 + 0.88 * random.generateDouble();
+            widget.m_peakHeights[i] = qMin(1.0, widget.m_barHeights[i] + 0.05);
+        }
+    }
+
+    // 改用图集之前的绘制方式：每条每帧新建渐变并绘制抗锯齿圆角矩形
+    static void paintWithGradients(const SpectrumWidget &widget, QImage &target)
+    {
+        QPainter painter(&target);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.fillRect(target.rect(), widget.m_backgroundColor);
+
+        const int height = target.height();
+        for (int i = 0; i < widget.m_barCount; ++i) {
+            const int x = widget.barX(i);
+            const int y = widget.barTop(i);
+            const int barHeight = height - 10 - y;
+
+            const double hue = std::fmod(i * 360.0 / widget.m_barCount + widget.m_colorOffset, 360.0) / 360.0;
+            QLinearGradient gradient(x, y + barHeight, x, y);
+            gradient.setColorAt(0, QColor::fromHsvF(hue, 0.95, 1.0));
+            gradient.setColorAt(1, QColor::fromHsvF(hue, 0.75, 0.8));
+            painter.setBrush(gradient);
+            painter.setPen(Qt::NoPen);
+            painter.drawRoundedRect(x, y, widget.m_barWidth, barHeight, 2, 2);
+
+            const int peakY = widget.peakTop(i);
+            if (peakY >= 0) {
+                painter.setBrush(QColor::fromHsvF(hue, 1.0, 1.0));
+                painter.drawRoundedRect(x, peakY, widget.m_barWidth, 3, 1, 1);
+            }
+        }
+    }
+
+private slots:
+    void benchmarkPaint_data()
+    {
+        QTest::addColumn<int>("bars");
+        QTest::addColumn<bool>("atlas");
+        for (int bars : {64, 256, 1024}) {
+            QTest::addRow("%d-atlas", bars) << bars << true;
+            QTest::addRow("%d-gradient", bars) << bars << false;
+        }
+    }
+
+    // 每次迭代为一整帧（整体重绘）
+    void benchmarkPaint()
+    {
+        QFETCH(int, bars);
+        QFETCH(bool, atlas);
+
+        // 不真正上屏，只为同步收到尺寸变化（计算条宽）
+        SpectrumWidget widget(nullptr, tableForBars(bars));
+        widget.setAttribute(Qt::WA_DontShowOnScreen);
+        widget.resize(WIDTH, HEIGHT);
+        widget.show();
+        widget.setPlaying(true);
+        QImage target(WIDTH, HEIGHT, QImage::Format_ARGB32_Premultiplied);
+
+        // 首次绘制建立图集，不计入耗时
+        widget.render(&target);
+        QCOMPARE(widget.barCount(), bars);
+        QVERIFY(widget.barX(bars - 1) + widget.m_barWidth <= WIDTH);
+        fillLevels(widget);
+
+        if (atlas) {
+            QBENCHMARK {
+                widget.render(&target);
+            }
+        } else {
+            QBENCHMARK {
+                paintWithGradients(widget, target);
+            }
+        }
+    }
+};
+
+QTEST_MAIN(TestSpectrumWidget)
+
+#include "tst_spectrumwidget.moc"
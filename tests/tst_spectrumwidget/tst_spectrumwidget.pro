@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+QT += gui widgets multimedia
+
+TARGET = tst_spectrumwidget
+
+HEADERS += \
+    ../../audiotap.h \
+    ../../spectrumwidget.h
+
+SOURCES += \
+    tst_spectrumwidget.cpp
@@ -0,0 +1,423 @@
+#ifndef WAVEFORMOVERVIEW_H
+#define WAVEFORMOVERVIEW_H
+
+#include <QObject>
+#include <QThread>
+#include <QSlider>
+#include <QStyle>
+#include <QPainter>
+#include <QPixmap>
+#include <QImage>
+#include <QPaintEvent>
+#include <QAudioDecoder>
+#include <QAudioBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QSharedPointer>
+#include <QtEndian>
+#include <QVector>
+#include <QUrl>
+#include <QDebug>
+#include <cmath>
+#include <cstring>
+#include "pcmconverter.h"
+#include "cachedirectory.h"
+
+// 整首曲目的波形概览数据（每桶 min/max/RMS）
+// 旁路文件格式（小端）：
+//   "QMWF" | quint32 版本 | quint32 每秒桶数 | quint32 桶数 | qint8 min[桶数] | qint8 max[桶数] | quint8 rms[桶数]
+// 重新打开时直接内存映射旁路文件，不做任何解码；缓存目录有总大小、文件数与有效期上限
+class WaveformData
+{
+private:
+    static const quint32 VERSION = 1;
+    static const int HEADER_SIZE = 16;
+    static constexpr qint64 MAX_CACHE_BYTES = 64LL * 1024 * 1024;        // 约两千首 4 分钟的曲目
+    static const int MAX_CACHE_FILES = 5000;
+    static constexpr qint64 MAX_CACHE_AGE_MS = 90LL * 24 * 3600 * 1000;  // 90 天未使用即删除
+
+    QFile m_file;                   // 映射中的旁路文件
+    const uchar *m_base = nullptr;  // 映射起始地址
+    int m_count = 0;                // 桶数
+
+public:
+    static const int BUCKETS_PER_SECOND = 50;   // 每桶 20ms，两小时约 1MB
+
+    int bucketCount() const { return m_count; }
+    const qint8 *mins() const { return reinterpret_cast<const qint8 *>(m_base + HEADER_SIZE); }
+    const qint8 *maxs() const { return mins() + m_count; }
+    const quint8 *rms() const { return reinterpret_cast<const quint8 *>(m_base + HEADER_SIZE) + 2 * m_count; }
+
+    static QString cacheDir()
+    {
+        return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/waveforms";
+    }
+
+    // 旁路文件路径：缓存目录下，以 路径+修改时间+大小 的哈希命名
+    static QString sidecarPath(const QString &audioPath)
+    {
+        QFileInfo info(audioPath);
+        QByteArray key = info.absoluteFilePath().toUtf8()
+                         + '|' + QByteArray::number(info.lastModified().toMSecsSinceEpoch())
+                         + '|' + QByteArray::number(info.size());
+        return cacheDir() + "/" + QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex() + ".wfm";
+    }
+
+    // 超出上限时淘汰最久未使用的旁路文件
+    static void trimCache()
+    {
+        CacheDirectory::trim(cacheDir(), "*.wfm", MAX_CACHE_BYTES, MAX_CACHE_FILES, MAX_CACHE_AGE_MS);
+    }
+
+    // 映射已有的旁路文件，格式不符时返回空
+    static QSharedPointer<WaveformData> load(const QString &path)
+    {
+        QSharedPointer<WaveformData> data(new WaveformData);
+        data->m_file.setFileName(path);
+        if (!data->m_file.open(QIODevice::ReadOnly) || data->m_file.size() < HEADER_SIZE) {
+            return {};
+        }
+
+        const uchar *base = data->m_file.map(0, data->m_file.size());
+        if (!base || memcmp(base, "QMWF", 4) != 0
+            || qFromLittleEndian<quint32>(base + 4) != VERSION
+            || qFromLittleEndian<quint32>(base + 8) != BUCKETS_PER_SECOND) {
+            return {};
+        }
+
+        const quint32 count = qFromLittleEndian<quint32>(base + 12);
+        if (data->m_file.size() != HEADER_SIZE + 3 * qint64(count)) {
+            return {};
+        }
+        data->m_base = base;
+        data->m_count = static_cast<int>(count);
+        CacheDirectory::touch(path);
+        return data;
+    }
+
+    // 原子写入旁路文件
+    static bool save(const QString &path, const QVector<qint8> &mins,
+                     const QVector<qint8> &maxs, const QVector<quint8> &rms)
+    {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qDebug() << "无法写入波形缓存:" << path;
+            return false;
+        }
+
+        uchar header[HEADER_SIZE];
+        memcpy(header, "QMWF", 4);
+        qToLittleEndian<quint32>(VERSION, header + 4);
+        qToLittleEndian<quint32>(BUCKETS_PER_SECOND, header + 8);
+        qToLittleEndian<quint32>(static_cast<quint32>(mins.size()), header + 12);
+
+        file.write(reinterpret_cast<const char *>(header), HEADER_SIZE);
+        file.write(reinterpret_cast<const char *>(mins.constData()), mins.size());
+        file.write(reinterpret_cast<const char *>(maxs.constData()), maxs.size());
+        file.write(reinterpret_cast<const char *>(rms.constData()), rms.size());
+        return file.commit();
+    }
+};
+
+// 解码线程中的波形构建器：全速解码整首曲目，按桶统计 min/max/RMS
+class WaveformBuilder : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int SCRATCH_FRAMES = 16384;
+
+    QAudioDecoder *m_decoder = nullptr;
+    QString m_audioPath;            // 正在构建的音频
+    QString m_sidecarPath;          // 输出旁路文件
+    quint64 m_generation = 0;       // 请求序号
+
+    QVector<float> m_scratch;       // 混缩缓冲
+    QVector<qint8> m_mins;
+    QVector<qint8> m_maxs;
+    QVector<quint8> m_rms;
+    int m_framesPerBucket = 0;
+    int m_bucketFrames = 0;         // 当前桶已累计帧数
+    float m_bucketMin = 0.0f;
+    float m_bucketMax = 0.0f;
+    double m_bucketSquares = 0.0;
+
+public:
+    WaveformBuilder() { m_scratch.resize(SCRATCH_FRAMES); }
+
+public slots:
+    void initialize()
+    {
+        m_decoder = new QAudioDecoder(this);
+        connect(m_decoder, &QAudioDecoder::bufferReady, this, &WaveformBuilder::readBuffers);
+        connect(m_decoder, &QAudioDecoder::finished, this, &WaveformBuilder::finish);
+        connect(m_decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error),
+                this, [this](QAudioDecoder::Error error) {
+            qDebug() << "波形解码错误:" << error << m_decoder->errorString();
+            m_decoder->stop();
+            m_audioPath.clear();
+        });
+    }
+
+    // 开始构建；新请求会中断尚未完成的旧请求
+    void build(const QString &audioPath, const QString &sidecarPath, quint64 generation)
+    {
+        // 先清空路径，避免旧请求的部分数据在停止时被当作完整结果写出
+        m_audioPath.clear();
+        m_decoder->stop();
+        m_audioPath = audioPath;
+        m_sidecarPath = sidecarPath;
+        m_generation = generation;
+        m_mins.clear();
+        m_maxs.clear();
+        m_rms.clear();
+        m_framesPerBucket = 0;
+        resetBucket();
+
+        m_decoder->setSource(QUrl::fromLocalFile(audioPath));
+        m_decoder->start();
+    }
+
+signals:
+    void built(const QString &audioPath, const QString &sidecarPath, quint64 generation);
+
+private slots:
+    void readBuffers()
+    {
+        while (m_decoder->bufferAvailable()) {
+            QAudioBuffer buffer = m_decoder->read();
+            if (!buffer.isValid() || m_audioPath.isEmpty()) continue;
+
+            if (m_framesPerBucket == 0) {
+                m_framesPerBucket = qMax(1, buffer.format().sampleRate() / WaveformData::BUCKETS_PER_SECOND);
+            }
+
+            const int frames = static_cast<int>(buffer.frameCount());
+            for (int offset = 0; offset < frames; offset += SCRATCH_FRAMES) {
+                const int count = qMin(SCRATCH_FRAMES, frames - offset);
+                if (!PcmConverter::toMono(buffer, offset, count, m_scratch.data())) break;
+                accumulate(m_scratch.constData(), count);
+            }
+        }
+    }
+
+    void finish()
+    {
+        if (m_audioPath.isEmpty()) return;
+        if (m_bucketFrames > 0) flushBucket();
+
+        if (!m_mins.isEmpty() && WaveformData::save(m_sidecarPath, m_mins, m_maxs, m_rms)) {
+            qDebug() << "波形概览已生成:" << m_audioPath << "桶数:" << m_mins.size();
+            emit built(m_audioPath, m_sidecarPath, m_generation);
+            WaveformData::trimCache();
+        }
+        m_audioPath.clear();
+    }
+
+private:
+    void accumulate(const float *samples, int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            const float v = samples[i];
+            m_bucketMin = qMin(m_bucketMin, v);
+            m_bucketMax = qMax(m_bucketMax, v);
+            m_bucketSquares += double(v) * v;
+            if (++m_bucketFrames == m_framesPerBucket) {
+                flushBucket();
+            }
+        }
+    }
+
+    void flushBucket()
+    {
+        const double rms = std::sqrt(m_bucketSquares / m_bucketFrames);
+        m_mins.append(static_cast<qint8>(qBound(-127, qRound(m_bucketMin * 127.0f), 127)));
+        m_maxs.append(static_cast<qint8>(qBound(-127, qRound(m_bucketMax * 127.0f), 127)));
+        m_rms.append(static_cast<quint8>(qBound(0, qRound(rms * 255.0), 255)));
+        resetBucket();
+    }
+
+    void resetBucket()
+    {
+        m_bucketFrames = 0;
+        m_bucketMin = 0.0f;
+        m_bucketMax = 0.0f;
+        m_bucketSquares = 0.0;
+    }
+};
+
+// 波形概览服务：优先映射已有旁路文件，否则在后台线程解码生成
+class WaveformOverview : public QObject
+{
+    Q_OBJECT
+
+private:
+    QThread m_thread;
+    WaveformBuilder *m_builder;
+    quint64 m_generation = 0;       // 最新请求序号，旧请求的结果直接丢弃
+
+public:
+    explicit WaveformOverview(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+        m_builder = new WaveformBuilder;
+        m_builder->moveToThread(&m_thread);
+        connect(&m_thread, &QThread::started, m_builder, &WaveformBuilder::initialize);
+        connect(&m_thread, &QThread::finished, m_builder, &QObject::deleteLater);
+        connect(m_builder, &WaveformBuilder::built, this, &WaveformOverview::onBuilt);
+        m_thread.setObjectName("WaveformBuilder");
+        m_thread.start(QThread::LowPriority);
+    }
+
+    ~WaveformOverview()
+    {
+        m_thread.quit();
+        m_thread.wait();
+    }
+
+    // 请求某个本地音频的波形概览，结果通过 waveformReady 返回
+    void request(const QString &audioPath)
+    {
+        const quint64 generation = ++m_generation;
+        const QString sidecar = WaveformData::sidecarPath(audioPath);
+
+        QSharedPointer<WaveformData> data = WaveformData::load(sidecar);
+        if (data) {
+            emit waveformReady(audioPath, data);
+            return;
+        }
+
+        QMetaObject::invokeMethod(m_builder, [builder = m_builder, audioPath, sidecar, generation]() {
+            builder->build(audioPath, sidecar, generation);
+        }, Qt::QueuedConnection);
+    }
+
+signals:
+    void waveformReady(const QString &audioPath, QSharedPointer<WaveformData> data);
+
+private slots:
+    void onBuilt(const QString &audioPath, const QString &sidecarPath, quint64 generation)
+    {
+        if (generation != m_generation) return;
+        QSharedPointer<WaveformData> data = WaveformData::load(sidecarPath);
+        if (data) {
+            emit waveformReady(audioPath, data);
+        }
+    }
+};
+
+// 带波形概览背景的进度条
+class WaveformSlider : public QSlider
+{
+    Q_OBJECT
+
+private:
+    QSharedPointer<WaveformData> m_waveform;
+    QPixmap m_playedPixmap;         // 已播放部分（按设备像素渲染）
+    QPixmap m_remainingPixmap;      // 未播放部分
+    QSize m_cachedSize;
+    qreal m_cachedRatio = 0.0;      // 渲染时的设备像素比
+
+public:
+    explicit WaveformSlider(Qt::Orientation orientation, QWidget *parent = nullptr)
+        : QSlider(orientation, parent)
+    {
+        setMinimumHeight(40);
+    }
+
+    void setWaveform(QSharedPointer<WaveformData> waveform)
+    {
+        m_waveform = waveform;
+        m_cachedSize = QSize();
+        update();
+    }
+
+    void clearWaveform()
+    {
+        setWaveform({});
+    }
+
+protected:
+    void paintEvent(QPaintEvent *event) override
+    {
+        if (m_waveform && m_waveform->bucketCount() > 0) {
+            const qreal dpr = devicePixelRatioF();
+            if (m_cachedSize != size() || m_cachedRatio != dpr) {
+                renderWaveform(dpr);
+            }
+
+            // 目标矩形为逻辑坐标，源矩形为位图的设备像素坐标
+            QPainter painter(this);
+            int split = QStyle::sliderPositionFromValue(minimum(), maximum(), value(), width());
+            painter.drawPixmap(QRectF(split, 0, width() - split, height()), m_remainingPixmap,
+                               QRectF(split * dpr, 0, (width() - split) * dpr, height() * dpr));
+            painter.drawPixmap(QRectF(0, 0, split, height()), m_playedPixmap,
+                               QRectF(0, 0, split * dpr, height() * dpr));
+        }
+        QSlider::paintEvent(event);
+    }
+
+private:
+    // 把桶数据按设备像素列聚合，渲染成两种配色的位图（仅在尺寸、像素比或数据变化时执行）
+    // 高 DPI 屏幕上按物理像素绘制，避免放大后发虚
+    void renderWaveform(qreal dpr)
+    {
+        m_cachedSize = size();
+        m_cachedRatio = dpr;
+        const int w = qMax(1, qRound(width() * dpr));
+        const int h = qMax(1, qRound(height() * dpr));
+        const int count = m_waveform->bucketCount();
+        const qint8 *mins = m_waveform->mins();
+        const qint8 *maxs = m_waveform->maxs();
+        const quint8 *rms = m_waveform->rms();
+
+        QImage mask(w, h, QImage::Format_ARGB32_Premultiplied);
+        mask.fill(Qt::transparent);
+        QPainter painter(&mask);
+        const double mid = h / 2.0;
+        const double scale = (h / 2.0 - 2 * dpr) / 127.0;
+
+        for (int x = 0; x < w; ++x) {
+            int first = static_cast<int>(qint64(x) * count / w);
+            int last = qMax(first + 1, static_cast<int>(qint64(x + 1) * count / w));
+            int lo = 127, hi = -127;
+            double squares = 0.0;
+            for (int b = first; b < last && b < count; ++b) {
+                lo = qMin<int>(lo, mins[b]);
+                hi = qMax<int>(hi, maxs[b]);
+                squares += double(rms[b]) * rms[b];
+            }
+            if (hi < lo) continue;
+            double level = std::sqrt(squares / (last - first)) / 255.0 * 127.0;
+
+            painter.setPen(QColor(255, 255, 255, 110));
+            painter.drawLine(QPointF(x + 0.5, mid - hi * scale), QPointF(x + 0.5, mid - lo * scale));
+            painter.setPen(QColor(255, 255, 255, 230));
+            painter.drawLine(QPointF(x + 0.5, mid - level * scale), QPointF(x + 0.5, mid + level * scale));
+        }
+        painter.end();
+
+        m_playedPixmap = tinted(mask, QColor("#64b5f6"), dpr);
+        m_remainingPixmap = tinted(mask, QColor(120, 120, 140), dpr);
+    }
+
+    static QPixmap tinted(const QImage &mask, const QColor &color, qreal dpr)
+    {
+        QImage image = mask;
+        QPainter painter(&image);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        painter.fillRect(image.rect(), color);
+        painter.end();
+        QPixmap pixmap = QPixmap::fromImage(image);
+        pixmap.setDevicePixelRatio(dpr);
+        return pixmap;
+    }
+};
+
+#endif // WAVEFORMOVERVIEW_H
@@ -196,6 +196,33 @@ void Widget::initMenu()
         }}
     }, true);
 
+    // 交叉淡化（音频播放器曲间重叠时长）
+    QMenu *crossfadeMenu = playerMenu->addMenu("交叉淡化");
+    m = new Menu(crossfadeMenu);
+    m->createActionGroup({
+        {"关闭（无缝衔接）", "", [=]() { m_audio->setCrossfadeDuration(0); }},
+        {"2 秒", "", [=]() { m_audio->setCrossfadeDuration(2000); }},
+        {"5 秒", "", [=]() { m_audio->setCrossfadeDuration(5000); }},
+        {"8 秒", "", [=]() { m_audio->setCrossfadeDuration(8000); }}
+    }, true);
+    crossfadeMenu->actions().first()->setChecked(true);
+
+    // 歌词延迟补偿（输出设备延迟，蓝牙耳机通常 150~300 毫秒）
+    QMenu *latencyMenu = playerMenu->addMenu("歌词延迟补偿");
+    m = new Menu(latencyMenu);
+    m->createActionGroup({
+        {"无（有线 / 内置扬声器）", "", [=]() { m_audio->setLyricLatency(0); }},
+        {"100 毫秒", "", [=]() { m_audio->setLyricLatency(100); }},
+        {"200 毫秒（蓝牙）", "", [=]() { m_audio->setLyricLatency(200); }},
+        {"300 毫秒", "", [=]() { m_audio->setLyricLatency(300); }}
+    }, true);
+    latencyMenu->actions().first()->setChecked(true);
+
+    // 歌词批量预取（为播放列表中缺少歌词的曲目在线下载）
+    m = new Menu(playerMenu);
+    m->createAction("预取全部歌词", "", [=]() { m_audio->prefetchLyrics(); });
+    m->createAction("停止预取歌词", "", [=]() { m_audio->lyricPrefetcher()->stop(); });
+
     // 关于菜单
     m = new Menu(helpMenu);
     m->createAction("关于", "./assets/about.png", [=]() {
@@ -210,6 +237,11 @@ void Widget::initMenu()
             "• 视频滤镜效果\n"
             "• 倍速播放");
     });
+    m->createAction("网络诊断", "", [=]() {
+        NetworkDiagnosticsDialog *dialog = new NetworkDiagnosticsDialog(m_audio->lyricDownloader(), this);
+        dialog->exec();
+        delete dialog;
+    });
 
     // 创建布局
     QVBoxLayout *layout = new QVBoxLayout(this);
@@ -17,6 +17,7 @@
 #include "audioplayer.h"
 #include "menu.h"
 #include "playhistory.h"
+#include "networkdiagnosticsdialog.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { 